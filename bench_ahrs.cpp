@@ -0,0 +1,219 @@
+/**
+ * @file bench_ahrs.cpp
+ * @brief 姿态融合滤波器更新开销对比
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   按正弦角速度生成真实姿态轨迹，由其得到带噪声的陀螺、加速度计与磁力计样本，
+ *   经 AHRSFilter 接口（与 IMUReader 相同的虚调用）逐样本更新 Madgwick / Mahony / EKF，
+ *   分别测量六轴与九轴的 ns/次，并输出末尾的倾角误差作为结果合理性检查。
+ *   AHRSBatch（VirtualIMU 使用的多通道版本）的各通道都处理轨迹的前 1/AHRS_BATCH_LANES 段（总更新次数不变，
+ *   各通道初始姿态与真实姿态一致），输出每通道每次更新的 ns 与相对同一算法单通道版本的加速比，
+ *   倾角误差取各通道在段末的最大值。
+ *   用法: bench_ahrs [--samples 200000] [--rate 200] [--rounds 5]
+ */
+#include "ahrs.h"
+#include "imu_math.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr float GRAVITY = 9.80665f;
+
+struct Sample {
+    Vec3f gyro;
+    Vec3f accel;
+    Vec3f mag;
+};
+
+// 多通道输入：每次更新的各字段为 AHRS_BATCH_LANES 个通道的数组
+struct LaneSample {
+    alignas(32) float gx[AHRS_BATCH_LANES];
+    alignas(32) float gy[AHRS_BATCH_LANES];
+    alignas(32) float gz[AHRS_BATCH_LANES];
+    alignas(32) float ax[AHRS_BATCH_LANES];
+    alignas(32) float ay[AHRS_BATCH_LANES];
+    alignas(32) float az[AHRS_BATCH_LANES];
+    alignas(32) float mx[AHRS_BATCH_LANES];
+    alignas(32) float my[AHRS_BATCH_LANES];
+    alignas(32) float mz[AHRS_BATCH_LANES];
+};
+
+template <typename Fn>
+double bestNsPerUpdate(int rounds, size_t updates, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / updates;
+        best = std::min(best, ns);
+    }
+    return best;
+}
+
+// 两个姿态的倾角差（机体系重力方向夹角）度
+float tiltErrorDeg(const Quatf& estimate, const Quatf& truth) {
+    Vec3f up_est = rotateInverse(estimate, Vec3f{0.0f, 0.0f, 1.0f});
+    Vec3f up_true = rotateInverse(truth, Vec3f{0.0f, 0.0f, 1.0f});
+    float c = std::min(1.0f, std::max(-1.0f, dot(up_est, up_true)));
+    return std::acos(c) * RAD_TO_DEG;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t samples = 200000;
+    float rate = 200.0f;
+    int rounds = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) {
+            samples = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            rate = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--samples 200000] [--rate 200] [--rounds 5]" << std::endl;
+            return 1;
+        }
+    }
+    if (samples == 0 || rate <= 0.0f || rounds <= 0) {
+        std::cerr << "错误: 参数无效" << std::endl;
+        return 1;
+    }
+
+    // 真实轨迹：各轴正弦角速度，机体系到世界系四元数右乘增量旋转
+    const float dt = 1.0f / rate;
+    const Vec3f mag_world{20.0f, 0.0f, -40.0f};
+    std::mt19937 rng(12345);
+    std::normal_distribution<float> gyro_noise(0.0f, 0.005f);
+    std::normal_distribution<float> accel_noise(0.0f, 0.05f);
+    std::normal_distribution<float> mag_noise(0.0f, 0.3f);
+    const size_t steps = samples / AHRS_BATCH_LANES;
+    std::vector<Sample> data(samples);
+    Quatf truth;
+    Quatf lane_truth;
+    for (size_t k = 0; k < samples; k++) {
+        if (k == steps) {
+            lane_truth = truth;
+        }
+        float t = k * dt;
+        Vec3f omega{0.8f * std::sin(0.7f * t), 0.6f * std::sin(1.1f * t + 1.0f), 0.5f * std::sin(0.3f * t + 2.0f)};
+        Vec3f g = rotateInverse(truth, Vec3f{0.0f, 0.0f, GRAVITY});
+        Vec3f m = rotateInverse(truth, mag_world);
+        data[k].gyro = omega + Vec3f{gyro_noise(rng), gyro_noise(rng), gyro_noise(rng)};
+        data[k].accel = g + Vec3f{accel_noise(rng), accel_noise(rng), accel_noise(rng)};
+        data[k].mag = m + Vec3f{mag_noise(rng), mag_noise(rng), mag_noise(rng)};
+        truth = normalized(truth * quatFromRotationVector(omega * dt));
+    }
+
+    std::vector<LaneSample> lanes(steps);
+    for (size_t k = 0; k < steps; k++) {
+        for (int l = 0; l < AHRS_BATCH_LANES; l++) {
+            const Sample& src = data[k];
+            LaneSample& dst = lanes[k];
+            dst.gx[l] = src.gyro.x;
+            dst.gy[l] = src.gyro.y;
+            dst.gz[l] = src.gyro.z;
+            dst.ax[l] = src.accel.x;
+            dst.ay[l] = src.accel.y;
+            dst.az[l] = src.accel.z;
+            dst.mx[l] = src.mag.x;
+            dst.my[l] = src.mag.y;
+            dst.mz[l] = src.mag.z;
+        }
+    }
+    float lane_dt[AHRS_BATCH_LANES];
+    std::fill(lane_dt, lane_dt + AHRS_BATCH_LANES, dt);
+
+    std::cout << "=== 姿态融合更新开销 ===" << std::endl;
+    std::cout << "样本: " << samples << "  采样率: " << rate << " Hz  轮数: " << rounds << "（取最快）" << std::endl;
+    if (steps == 0) {
+        std::cerr << "错误: 样本数少于通道数 " << AHRS_BATCH_LANES << std::endl;
+        return 1;
+    }
+
+    struct Case {
+        const char* name;
+        AHRSAlgorithm algorithm;
+    };
+    const Case cases[] = {{"Madgwick", AHRSAlgorithm::MADGWICK},
+                          {"Mahony", AHRSAlgorithm::MAHONY},
+                          {"EKF", AHRSAlgorithm::EKF}};
+
+    auto printRow = [](double ns, double ratio, const char* name, float tilt) {
+        std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(8) << ns << " ns/次" << std::setw(8)
+                  << ratio << "x  " << std::left << std::setw(10) << name << std::right << "  末尾倾角误差 "
+                  << std::setprecision(3) << tilt << "°" << std::endl;
+    };
+
+    bool ok = true;
+    for (bool use_mag : {false, true}) {
+        std::cout << std::endl << (use_mag ? "九轴（含磁力计）:" : "六轴:") << std::endl;
+        double baseline = 0.0;
+        double scalar_ns[3] = {};
+        int index = 0;
+        for (const Case& c : cases) {
+            AHRSConfig config;
+            config.algorithm = c.algorithm;
+            config.use_mag = use_mag;
+            std::unique_ptr<AHRSFilter> filter = createAHRSFilter(config);
+            double ns = bestNsPerUpdate(rounds, samples, [&] {
+                filter->reset();
+                for (const Sample& s : data) {
+                    filter->update(s.gyro, s.accel, use_mag ? &s.mag : nullptr, dt);
+                }
+            });
+            if (baseline == 0.0) {
+                baseline = ns;
+            }
+            Quatf q = filter->orientation();
+            float tilt = tiltErrorDeg(q, truth);
+            bool finite = std::isfinite(q.w) && std::isfinite(q.x) && std::isfinite(q.y) && std::isfinite(q.z);
+            ok = ok && finite && tilt < 5.0f;
+            scalar_ns[index++] = ns;
+            printRow(ns, ns / baseline, c.name, tilt);
+        }
+
+        // 多通道版本：ns 为每通道每次更新，倍数为相对同一算法单通道版本的加速比
+        std::cout << "  AHRSBatch（" << AHRS_BATCH_LANES << " 通道，ns/通道·次，倍数为相对单通道的加速比）:" << std::endl;
+        for (int i = 0; i < 2; i++) {
+            AHRSConfig config;
+            config.algorithm = cases[i].algorithm;
+            AHRSBatch batch(config);
+            double ns = bestNsPerUpdate(rounds, steps * AHRS_BATCH_LANES, [&] {
+                batch.reset();
+                for (const LaneSample& s : lanes) {
+                    batch.update(s.gx, s.gy, s.gz, s.ax, s.ay, s.az, use_mag ? s.mx : nullptr, s.my, s.mz, lane_dt);
+                }
+            });
+            float tilt = 0.0f;
+            for (int l = 0; l < AHRS_BATCH_LANES; l++) {
+                Quatf q = batch.orientation(l);
+                float lane_tilt = tiltErrorDeg(q, lane_truth);
+                ok = ok && std::isfinite(lane_tilt);
+                tilt = std::max(tilt, lane_tilt);
+            }
+            ok = ok && tilt < 5.0f;
+            printRow(ns, scalar_ns[i] / ns, cases[i].name, tilt);
+        }
+    }
+
+    if (!ok) {
+        std::cerr << "错误: 滤波结果发散（倾角误差超过 5°）" << std::endl;
+        return 1;
+    }
+    return 0;
+}
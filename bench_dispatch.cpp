@@ -0,0 +1,216 @@
+/**
+ * @file bench_dispatch.cpp
+ * @brief 回调分发开销对比
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   1. 每帧分发：同一 IMUData 序列经 std::function / Delegate / 编译期 Sink 调用
+ *      （回调对象经 volatile 指针访问，避免编译器在基准中去虚化）
+ *   2. 构造+调用：sendCommand 每次构造发送函数的开销
+ *   3. 解析+分发：IMUParser（Delegate）与 IMUParserT<Sink>（IMUData / 帧视图）
+ *   用法: bench_dispatch [--tag 0x7F] [--frames 200000] [--rounds 5]
+ */
+#include "delegate.h"
+#include "imu_parser.h"
+#include "imu_parser_t.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr U8 kAddress = 0x50;
+
+// 传感器数据帧：起始码 + 地址 + 长度 + 数据体 + 校验和 + 结束码
+void appendFrame(std::vector<U8>& stream, const U8* body, int len) {
+    U8 checksum = kAddress + static_cast<U8>(len);
+    stream.push_back(CMD_PACKET_BEGIN);
+    stream.push_back(kAddress);
+    stream.push_back(static_cast<U8>(len));
+    for (int i = 0; i < len; i++) {
+        stream.push_back(body[i]);
+        checksum += body[i];
+    }
+    stream.push_back(checksum);
+    stream.push_back(CMD_PACKET_END);
+}
+
+template <typename Fn>
+double bestNsPerFrame(int rounds, size_t frames, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / frames;
+        best = std::min(best, ns);
+    }
+    return best;
+}
+
+void printRow(const char* name, double ns, double baseline) {
+    std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(8) << ns << " ns/帧" << std::setw(8)
+              << baseline / ns << "x  " << name << std::endl;
+}
+
+// 编译期 Sink：累加航向角
+struct YawSink {
+    float sum = 0.0f;
+    void operator()(const IMUData& data) { sum += data.euler_z; }
+};
+
+struct YawViewSink {
+    float sum = 0.0f;
+    void operator()(const IMUFrameView& view) { sum += view.yaw(); }
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int tag = 0x7F;
+    size_t frames = 200000;
+    int rounds = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tag" && i + 1 < argc) {
+            tag = static_cast<int>(std::strtol(argv[++i], nullptr, 0));
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--tag 0x7F] [--frames 200000] [--rounds 5]" << std::endl;
+            return 1;
+        }
+    }
+    if (tag < 0x01 || tag > 0x7F || frames == 0 || rounds <= 0) {
+        std::cerr << "错误: 参数无效" << std::endl;
+        return 1;
+    }
+
+    int body_len = 7 + IMU_FRAME_OFFSETS.offset[tag][7];
+    std::mt19937 rng(12345);
+    std::vector<IMUData> samples(frames);
+    std::vector<U8> stream;
+    stream.reserve(frames * (body_len + 5));
+    for (size_t f = 0; f < frames; f++) {
+        U8 body[7 + IMU_RAW_MAX_PAYLOAD];
+        body[0] = 0x11;
+        body[1] = static_cast<U8>(tag);
+        body[2] = 0;
+        U32 timestamp = static_cast<U32>(f * 4);
+        memcpy(body + 3, &timestamp, 4);
+        for (int i = 7; i < body_len; i++) {
+            body[i] = static_cast<U8>(rng());
+        }
+        appendFrame(stream, body, body_len);
+        samples[f] = IMUFrameView(body + 7, static_cast<uint16_t>(tag), timestamp).toIMUData();
+    }
+
+    std::cout << "=== 回调分发开销对比 ===" << std::endl;
+    std::cout << "订阅标签: 0x" << std::hex << tag << std::dec << "  帧数: " << frames << "  轮数: " << rounds
+              << "（取最快）" << std::endl;
+
+    // 各路径各自累加航向角，顺序相同，结果应逐位一致（同时防止循环被优化掉）
+    float function_sum = 0.0f;
+    float delegate_sum = 0.0f;
+    float parser_sum = 0.0f;
+
+    std::cout << std::endl << "每帧分发:" << std::endl;
+    IMUDataCallback function_callback = [&function_sum](const IMUData& data) { function_sum += data.euler_z; };
+    IMUDataCallback* volatile function_ptr = &function_callback;
+    double function_ns = bestNsPerFrame(rounds, frames, [&] {
+        for (const IMUData& data : samples) {
+            (*function_ptr)(data);
+        }
+    });
+    IMUDataDelegate delegate_callback = [&delegate_sum](const IMUData& data) { delegate_sum += data.euler_z; };
+    IMUDataDelegate* volatile delegate_ptr = &delegate_callback;
+    double delegate_ns = bestNsPerFrame(rounds, frames, [&] {
+        for (const IMUData& data : samples) {
+            (*delegate_ptr)(data);
+        }
+    });
+    YawSink inline_sink;
+    double inline_ns = bestNsPerFrame(rounds, frames, [&] {
+        for (const IMUData& data : samples) {
+            inline_sink(data);
+        }
+    });
+    printRow("std::function", function_ns, function_ns);
+    printRow("Delegate", delegate_ns, function_ns);
+    printRow("编译期 Sink（内联）", inline_ns, function_ns);
+
+    std::cout << std::endl << "构造+调用（发送函数，捕获一个引用）:" << std::endl;
+    size_t sent = 0;
+    size_t* volatile sent_ptr = &sent;
+    U8 payload[8] = {};
+    double function_send = bestNsPerFrame(rounds, frames, [&] {
+        for (size_t f = 0; f < frames; f++) {
+            std::function<int(const U8*, size_t)> send = [sent_ptr](const U8*, size_t len) -> int {
+                *sent_ptr += len;
+                return 0;
+            };
+            send(payload, sizeof(payload));
+        }
+    });
+    double delegate_send = bestNsPerFrame(rounds, frames, [&] {
+        for (size_t f = 0; f < frames; f++) {
+            IMUSendDelegate send = [sent_ptr](const U8*, size_t len) -> int {
+                *sent_ptr += len;
+                return 0;
+            };
+            send(payload, sizeof(payload));
+        }
+    });
+    printRow("std::function", function_send, function_send);
+    printRow("Delegate", delegate_send, function_send);
+
+    std::cout << std::endl << "解析+分发（含逐字节状态机）:" << std::endl;
+    IMUParser parser;
+    parser.setDataCallback([&parser_sum](const IMUData& data) { parser_sum += data.euler_z; });
+    double parser_ns = bestNsPerFrame(rounds, frames, [&] {
+        for (U8 byte : stream) {
+            parser.processByte(byte);
+        }
+    });
+    IMUParserT<YawSink> data_parser;
+    double data_parser_ns = bestNsPerFrame(rounds, frames, [&] {
+        for (U8 byte : stream) {
+            data_parser.processByte(byte);
+        }
+    });
+    IMUParserT<YawViewSink> view_parser;
+    double view_parser_ns = bestNsPerFrame(rounds, frames, [&] {
+        for (U8 byte : stream) {
+            view_parser.processByte(byte);
+        }
+    });
+    printRow("IMUParser（Delegate）", parser_ns, parser_ns);
+    printRow("IMUParserT<IMUData Sink>", data_parser_ns, parser_ns);
+    printRow("IMUParserT<帧视图 Sink>", view_parser_ns, parser_ns);
+
+    if (function_sum != inline_sink.sum || delegate_sum != inline_sink.sum) {
+        std::cerr << "错误: 三种分发方式的航向角累加不一致" << std::endl;
+        return 1;
+    }
+    // 三种解析器的航向角累加应一致
+    if (parser_sum != data_parser.sink().sum || data_parser.sink().sum != view_parser.sink().sum) {
+        std::cerr << "错误: 三种解析器的航向角累加不一致" << std::endl;
+        return 1;
+    }
+    if (view_parser.getStats().sensor_frames != frames * rounds) {
+        std::cerr << "错误: 解析帧数 " << view_parser.getStats().sensor_frames << "，期望 " << frames * rounds
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file bench_fft.cpp
+ * @brief 实数 FFT 长度与耗时关系
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   对 64 到 8192（[Vibration] fft_size 的取值范围）的每个长度测量 RealFFT 正变换与逆变换耗时，
+ *   输出 us/次、ns/(n·log2 n) 以及振动监测中每帧三轴正变换的耗时；
+ *   同时以双精度直接 DFT（n ≤ 1024）与往返变换检查结果，误差超限时返回 1。
+ *   用法: bench_fft [--min 64] [--max 8192] [--rounds 5]
+ */
+#include "fft.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+template <typename Fn>
+double bestNsPerTransform(int rounds, int repeats, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; i++) {
+            fn();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / repeats;
+        best = std::min(best, ns);
+    }
+    return best;
+}
+
+// 相对直接 DFT 的最大误差（相对于频谱最大幅值）
+double dftError(const std::vector<float>& x, const std::vector<std::complex<float>>& spectrum) {
+    const int n = static_cast<int>(x.size());
+    double max_error = 0.0;
+    double max_magnitude = 0.0;
+    for (int k = 0; k <= n / 2; k++) {
+        std::complex<double> sum = 0.0;
+        for (int t = 0; t < n; t++) {
+            sum += static_cast<double>(x[t]) * std::polar(1.0, -2.0 * PI * k * t / n);
+        }
+        max_magnitude = std::max(max_magnitude, std::abs(sum));
+        max_error = std::max(max_error, std::abs(sum - std::complex<double>(spectrum[k])));
+    }
+    return max_magnitude > 0.0 ? max_error / max_magnitude : max_error;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int min_size = 64;
+    int max_size = 8192;
+    int rounds = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--min" && i + 1 < argc) {
+            min_size = std::atoi(argv[++i]);
+        } else if (arg == "--max" && i + 1 < argc) {
+            max_size = std::atoi(argv[++i]);
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--min 64] [--max 8192] [--rounds 5]" << std::endl;
+            return 1;
+        }
+    }
+    if (!RealFFT::isPowerOfTwo(min_size) || !RealFFT::isPowerOfTwo(max_size) || min_size > max_size || rounds <= 0) {
+        std::cerr << "错误: 长度须为 2 的幂（≥ 4）且 min ≤ max" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== 实数 FFT 耗时 ===" << std::endl;
+    std::cout << "轮数: " << rounds << "（取最快）" << std::endl << std::endl;
+    std::cout << "      n     正变换 us   逆变换 us   ns/(n·log2n)   三轴/帧 us   DFT 误差    往返误差" << std::endl;
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    bool ok = true;
+    for (int n = min_size; n <= max_size; n *= 2) {
+        RealFFT fft(n);
+        std::vector<float> x(n);
+        for (float& v : x) {
+            v = dist(rng);
+        }
+        std::vector<std::complex<float>> spectrum(n / 2 + 1);
+        std::vector<float> back(n);
+
+        // 每轮的变换次数使总点数约为 2^22
+        int repeats = std::max(1, (1 << 22) / n);
+        double forward_ns = bestNsPerTransform(rounds, repeats, [&] { fft.forward(x.data(), spectrum.data()); });
+        double inverse_ns = bestNsPerTransform(rounds, repeats, [&] { fft.inverse(spectrum.data(), back.data()); });
+
+        fft.forward(x.data(), spectrum.data());
+        fft.inverse(spectrum.data(), back.data());
+        double round_trip = 0.0;
+        for (int i = 0; i < n; i++) {
+            round_trip = std::max(round_trip, static_cast<double>(std::fabs(back[i] - x[i])));
+        }
+        double dft = n <= 1024 ? dftError(x, spectrum) : -1.0;
+        ok = ok && round_trip < 1e-4 && dft < 1e-5;
+
+        double log2n = std::log2(static_cast<double>(n));
+        std::cout << std::setw(7) << n << std::fixed << std::setprecision(2) << std::setw(13) << forward_ns / 1000.0
+                  << std::setw(12) << inverse_ns / 1000.0 << std::setw(15) << forward_ns / (n * log2n)
+                  << std::setw(13) << 3.0 * forward_ns / 1000.0 << std::scientific << std::setprecision(1);
+        if (dft >= 0.0) {
+            std::cout << std::setw(12) << dft;
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::setw(12) << round_trip << std::defaultfloat << std::endl;
+    }
+
+    if (!ok) {
+        std::cerr << "错误: FFT 结果与直接 DFT 或往返变换不一致" << std::endl;
+        return 1;
+    }
+    return 0;
+}
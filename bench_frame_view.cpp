@@ -0,0 +1,171 @@
+/**
+ * @file bench_frame_view.cpp
+ * @brief 帧视图与完整解码性能对比
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   生成指定订阅标签的随机传感器数据帧，分别测量：
+ *     1. 仅解码：decodeRawPayload() 完整解码 vs IMUFrameView 只读航向角 / 全部字段
+ *     2. 解析+回调：IMUParser 数据回调 vs 帧视图回调（含逐字节状态机）
+ *   用法: bench_frame_view [--tag 0x7F] [--frames 200000] [--rounds 5]
+ */
+#include "imu_frame_view.h"
+#include "imu_parser.h"
+#include "imu_raw_sample.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr U8 kAddress = 0x50;
+
+// 传感器数据帧：起始码 + 地址 + 长度 + 数据体 + 校验和 + 结束码
+void appendFrame(std::vector<U8>& stream, const U8* body, int len) {
+    U8 checksum = kAddress + static_cast<U8>(len);
+    stream.push_back(CMD_PACKET_BEGIN);
+    stream.push_back(kAddress);
+    stream.push_back(static_cast<U8>(len));
+    for (int i = 0; i < len; i++) {
+        stream.push_back(body[i]);
+        checksum += body[i];
+    }
+    stream.push_back(checksum);
+    stream.push_back(CMD_PACKET_END);
+}
+
+template <typename Fn>
+double bestNsPerFrame(int rounds, size_t frames, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / frames;
+        best = std::min(best, ns);
+    }
+    return best;
+}
+
+void printRow(const char* name, double ns, double baseline) {
+    std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(8) << ns << " ns/帧" << std::setw(8)
+              << baseline / ns << "x  " << name << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int tag = 0x7F;
+    size_t frames = 200000;
+    int rounds = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tag" && i + 1 < argc) {
+            tag = static_cast<int>(std::strtol(argv[++i], nullptr, 0));
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--tag 0x7F] [--frames 200000] [--rounds 5]" << std::endl;
+            return 1;
+        }
+    }
+    if (tag < 0x01 || tag > 0x7F || frames == 0 || rounds <= 0) {
+        std::cerr << "错误: 参数无效" << std::endl;
+        return 1;
+    }
+
+    int payload_bytes = IMU_FRAME_OFFSETS.offset[tag][7];
+    int body_len = 7 + payload_bytes;
+
+    // 数据体：命令 0x11 + 订阅标签 + 时间戳 + 随机字段
+    std::mt19937 rng(12345);
+    std::vector<U8> bodies(frames * body_len);
+    std::vector<U8> stream;
+    stream.reserve(frames * (body_len + 5));
+    for (size_t f = 0; f < frames; f++) {
+        U8* body = &bodies[f * body_len];
+        body[0] = 0x11;
+        body[1] = static_cast<U8>(tag);
+        body[2] = 0;
+        U32 timestamp = static_cast<U32>(f * 4);
+        memcpy(body + 3, &timestamp, 4);
+        for (int i = 7; i < body_len; i++) {
+            body[i] = static_cast<U8>(rng());
+        }
+        appendFrame(stream, body, body_len);
+    }
+
+    std::cout << "=== 帧视图性能对比 ===" << std::endl;
+    std::cout << "订阅标签: 0x" << std::hex << tag << std::dec << "  数据体: " << payload_bytes
+              << " 字节  帧数: " << frames << "  轮数: " << rounds << "（取最快）" << std::endl;
+
+    volatile float sink = 0.0f;
+
+    std::cout << std::endl << "仅解码:" << std::endl;
+    double eager = bestNsPerFrame(rounds, frames, [&] {
+        float acc = 0.0f;
+        for (size_t f = 0; f < frames; f++) {
+            IMUData data;
+            decodeRawPayload(&bodies[f * body_len + 7], static_cast<uint16_t>(tag), data);
+            acc += data.euler_z;
+        }
+        sink = acc;
+    });
+    double view_yaw = bestNsPerFrame(rounds, frames, [&] {
+        float acc = 0.0f;
+        for (size_t f = 0; f < frames; f++) {
+            IMUFrameView view(&bodies[f * body_len + 7], static_cast<uint16_t>(tag), 0);
+            acc += view.yaw();
+        }
+        sink = acc;
+    });
+    double view_all = bestNsPerFrame(rounds, frames, [&] {
+        float acc = 0.0f;
+        for (size_t f = 0; f < frames; f++) {
+            IMUFrameView view(&bodies[f * body_len + 7], static_cast<uint16_t>(tag), 0);
+            Vec3f a = view.accel(), g = view.accelWithGravity(), w = view.gyro(), m = view.mag(), e = view.euler();
+            Quatf q = view.quat();
+            acc += a.x + g.y + w.z + m.x + e.z + q.w + view.temperature() + view.pressure() + view.height();
+        }
+        sink = acc;
+    });
+    printRow("完整解码 IMUData", eager, eager);
+    printRow("帧视图 yaw()", view_yaw, eager);
+    printRow("帧视图 全部字段", view_all, eager);
+
+    std::cout << std::endl << "解析+回调（含逐字节状态机）:" << std::endl;
+    float acc = 0.0f;
+    IMUParser data_parser;
+    data_parser.setDataCallback([&](const IMUData& data) { acc += data.euler_z; });
+    double parse_eager = bestNsPerFrame(rounds, frames, [&] {
+        for (U8 byte : stream) {
+            data_parser.processByte(byte);
+        }
+    });
+    IMUParser view_parser;
+    view_parser.setFrameViewCallback([&](const IMUFrameView& view) { acc += view.yaw(); });
+    double parse_view = bestNsPerFrame(rounds, frames, [&] {
+        for (U8 byte : stream) {
+            view_parser.processByte(byte);
+        }
+    });
+    sink = acc;
+    printRow("数据回调 euler_z", parse_eager, parse_eager);
+    printRow("帧视图回调 yaw()", parse_view, parse_eager);
+
+    IMUParserStats stats = view_parser.getStats();
+    if (stats.sensor_frames != frames * rounds) {
+        std::cerr << "错误: 解析帧数 " << stats.sensor_frames << "，期望 " << frames * rounds << std::endl;
+        return 1;
+    }
+    return 0;
+}
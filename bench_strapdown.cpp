@@ -0,0 +1,142 @@
+/**
+ * @file bench_strapdown.cpp
+ * @brief 捷联积分每样本开销
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   预先生成带噪声的角速度与比力采样，分别测量：
+ *     1. update() 逐样本积分（开启 / 关闭内置零速检测）
+ *     2. updateBatch() 批量积分（不写出 / 写出每步状态）
+ *     3. 由 IMUData 构造采样再积分（IMUReader 中的路径）
+ *   用法: bench_strapdown [--samples 200000] [--rate 200] [--rounds 5]
+ */
+#include "imu_math.h"
+#include "strapdown.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename Fn>
+double bestNsPerSample(int rounds, size_t samples, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; r++) {
+        auto begin = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / samples;
+        best = std::min(best, ns);
+    }
+    return best;
+}
+
+void printRow(const char* name, double ns, double baseline) {
+    std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(8) << ns << " ns/样本" << std::setw(8)
+              << baseline / ns << "x  " << name << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t samples = 200000;
+    float rate = 200.0f;
+    int rounds = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) {
+            samples = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            rate = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--samples 200000] [--rate 200] [--rounds 5]" << std::endl;
+            return 1;
+        }
+    }
+    if (samples == 0 || rate <= 0.0f || rounds <= 0) {
+        std::cerr << "错误: 参数无效" << std::endl;
+        return 1;
+    }
+
+    // 近似静止附近的小幅运动，使内置零速检测时而触发
+    const float dt = 1.0f / rate;
+    std::mt19937 rng(12345);
+    std::normal_distribution<float> gyro_noise(0.0f, 0.02f);
+    std::normal_distribution<float> accel_noise(0.0f, 0.2f);
+    std::vector<StrapdownSample> input(samples);
+    std::vector<IMUData> frames(samples);
+    for (size_t k = 0; k < samples; k++) {
+        StrapdownSample& s = input[k];
+        s.gyro = Vec3f{gyro_noise(rng), gyro_noise(rng), gyro_noise(rng)};
+        s.accel = Vec3f{accel_noise(rng), accel_noise(rng), 9.8f + accel_noise(rng)};
+        s.dt = dt;
+        IMUData& d = frames[k];
+        d.gyro_x = s.gyro.x * RAD_TO_DEG;
+        d.gyro_y = s.gyro.y * RAD_TO_DEG;
+        d.gyro_z = s.gyro.z * RAD_TO_DEG;
+        d.accel_with_gravity_x = s.accel.x;
+        d.accel_with_gravity_y = s.accel.y;
+        d.accel_with_gravity_z = s.accel.z;
+    }
+    std::vector<StrapdownState> trajectory(samples);
+
+    std::cout << "=== 捷联积分开销 ===" << std::endl;
+    std::cout << "样本: " << samples << "  采样率: " << rate << " Hz  轮数: " << rounds << "（取最快）" << std::endl;
+
+    StrapdownConfig config;
+    StrapdownIntegrator integrator;
+    auto run = [&](bool zupt, auto&& body) {
+        config.zupt = zupt;
+        integrator.configure(config);
+        return bestNsPerSample(rounds, samples, [&] {
+            integrator.reset(Quatf{});
+            body();
+        });
+    };
+
+    std::cout << std::endl << "逐样本:" << std::endl;
+    double update_ns = run(false, [&] {
+        for (const StrapdownSample& s : input) {
+            integrator.update(s);
+        }
+    });
+    double zupt_ns = run(true, [&] {
+        for (const StrapdownSample& s : input) {
+            integrator.update(s);
+        }
+    });
+    uint64_t zupts = integrator.state().zupts;
+    printRow("update()", update_ns, update_ns);
+    printRow("update() + 内置零速检测", zupt_ns, update_ns);
+
+    std::cout << std::endl << "批量:" << std::endl;
+    double batch_ns = run(false, [&] { integrator.updateBatch(input.data(), samples); });
+    double trajectory_ns = run(false, [&] { integrator.updateBatch(input.data(), samples, trajectory.data()); });
+    printRow("updateBatch()", batch_ns, update_ns);
+    printRow("updateBatch() + 写出轨迹", trajectory_ns, update_ns);
+
+    std::cout << std::endl << "由 IMUData 积分（读取器路径）:" << std::endl;
+    double imu_ns = run(false, [&] {
+        for (const IMUData& d : frames) {
+            integrator.update(strapdownSampleFromIMU(d, dt));
+        }
+    });
+    printRow("strapdownSampleFromIMU() + update()", imu_ns, update_ns);
+
+    const StrapdownState& state = integrator.state();
+    std::cout << std::endl << "内置零速检测触发次数: " << zupts << std::endl;
+    if (state.samples != samples || !std::isfinite(state.position[0])) {
+        std::cerr << "错误: 积分样本数 " << state.samples << "，期望 " << samples << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,356 @@
+/**
+ * @file imu_allan.cpp
+ * @brief 长时间静态记录的 Allan 偏差分析工具
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   输入 CSV：timestamp_ms,gyro_x,gyro_y,gyro_z,accel_x,accel_y,accel_z（角速度 dps，加速度 m/s²），
+ *   非数字开头的行（表头、注释）跳过。文件按块读取、解析为样本块后分发给工作线程，
+ *   每个工作线程负责若干 (通道, 簇大小区间) 的累加器；队列有界，内存占用与记录长度无关。
+ *
+ *   用法: imu_allan <recording.csv> [-o allan.csv] [--rate Hz] [--points 每十倍频程点数] [--threads N]
+ */
+#include "allan_variance.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr int CHANNELS = 6;
+constexpr size_t CHUNK_SAMPLES = 65536;
+constexpr size_t QUEUE_DEPTH = 4;
+constexpr size_t READ_BLOCK = 4 << 20;
+// 短簇（步长 1，逐样本更新）与长簇分给不同的累加器，逐样本开销主要在前者
+constexpr uint64_t SHORT_CLUSTER_LIMIT = 2 * ALLAN_LEVEL_MIN_Q;
+
+static const char* kChannelNames[CHANNELS] = {"gyro_x", "gyro_y", "gyro_z", "accel_x", "accel_y", "accel_z"};
+
+// 样本块：按通道分开存放
+struct Chunk {
+    std::vector<float> channel[CHANNELS];
+    size_t size = 0;
+};
+
+// 有界阻塞队列
+class ChunkQueue {
+public:
+    void push(std::shared_ptr<const Chunk> chunk) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return queue_.size() < QUEUE_DEPTH; });
+        queue_.push(std::move(chunk));
+        not_empty_.notify_one();
+    }
+
+    // 空指针表示结束
+    std::shared_ptr<const Chunk> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !queue_.empty(); });
+        std::shared_ptr<const Chunk> chunk = std::move(queue_.front());
+        queue_.pop();
+        not_full_.notify_one();
+        return chunk;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::queue<std::shared_ptr<const Chunk>> queue_;
+};
+
+// 单个累加任务
+struct Task {
+    int channel;
+    std::unique_ptr<AllanVarianceAccumulator> accumulator;
+};
+
+// 解析十进制浮点数（[-+]digits[.digits][e[-+]digits]），返回结束位置，失败返回 nullptr
+static const char* parseNumber(const char* p, const char* end, double& out) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    const char* start = p;
+    double value = 0.0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10.0 + (*p - '0');
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+        }
+    }
+    if (p == start) {
+        return nullptr;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            p++;
+        }
+        int exponent = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            exponent = exponent * 10 + (*p - '0');
+            p++;
+        }
+        value *= std::pow(10.0, exp_negative ? -exponent : exponent);
+    }
+    out = negative ? -value : value;
+    return p;
+}
+
+// 解析一行，成功返回 true
+static bool parseLine(const char* p, const char* end, double& timestamp, float values[CHANNELS]) {
+    double v;
+    p = parseNumber(p, end, timestamp);
+    if (p == nullptr) {
+        return false;
+    }
+    for (int c = 0; c < CHANNELS; c++) {
+        while (p < end && (*p == ',' || *p == ' ' || *p == '\t')) p++;
+        p = parseNumber(p, end, v);
+        if (p == nullptr) {
+            return false;
+        }
+        values[c] = static_cast<float>(v);
+    }
+    return true;
+}
+
+static void printUsage(const char* prog) {
+    std::cerr << "用法: " << prog << " <recording.csv> [-o allan.csv] [--rate Hz] [--points N] [--threads N]" << std::endl;
+    std::cerr << "  输入列: timestamp_ms,gyro_x,gyro_y,gyro_z,accel_x,accel_y,accel_z" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string output = "allan.csv";
+    double rate = 0.0;
+    int points_per_decade = 10;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--rate" && i + 1 < argc) {
+            rate = std::atof(argv[++i]);
+        } else if (arg == "--points" && i + 1 < argc) {
+            points_per_decade = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (input.empty() && arg[0] != '-') {
+            input = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (input.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* file = std::fopen(input.c_str(), "rb");
+    if (file == nullptr) {
+        std::cerr << "错误: 无法打开记录文件 " << input << std::endl;
+        return 1;
+    }
+
+    // 簇大小上限按文件大小粗估（每行约 40 字节），多余的簇大小不会产生结果
+    std::fseek(file, 0, SEEK_END);
+    long file_bytes = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    uint64_t max_cluster = std::max<uint64_t>(4, static_cast<uint64_t>(file_bytes / 20) / 2);
+    std::vector<uint64_t> sizes = allanClusterSizes(max_cluster, points_per_decade);
+    std::vector<uint64_t> short_sizes, long_sizes;
+    for (uint64_t m : sizes) {
+        (m < SHORT_CLUSTER_LIMIT ? short_sizes : long_sizes).push_back(m);
+    }
+
+    // 每个通道两个任务，按轮转分给工作线程
+    std::vector<Task> tasks;
+    for (int c = 0; c < CHANNELS; c++) {
+        tasks.push_back({c, std::make_unique<AllanVarianceAccumulator>(short_sizes)});
+        if (!long_sizes.empty()) {
+            tasks.push_back({c, std::make_unique<AllanVarianceAccumulator>(long_sizes)});
+        }
+    }
+    threads = std::min<int>(threads, static_cast<int>(tasks.size()));
+    std::vector<ChunkQueue> queues(threads);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < threads; w++) {
+        workers.emplace_back([w, threads, &tasks, &queues] {
+            while (std::shared_ptr<const Chunk> chunk = queues[w].pop()) {
+                for (size_t t = w; t < tasks.size(); t += threads) {
+                    tasks[t].accumulator->add(chunk->channel[tasks[t].channel].data(), chunk->size);
+                }
+            }
+        });
+    }
+
+    // 读取并解析
+    std::vector<char> buffer(READ_BLOCK);
+    std::string carry;
+    auto chunk = std::make_shared<Chunk>();
+    for (auto& ch : chunk->channel) ch.resize(CHUNK_SAMPLES);
+    uint64_t samples = 0, bad_lines = 0;
+    double first_ts = 0.0, last_ts = 0.0;
+
+    auto dispatch = [&]() {
+        if (chunk->size == 0) {
+            return;
+        }
+        std::shared_ptr<const Chunk> full = chunk;
+        for (auto& queue : queues) {
+            queue.push(full);
+        }
+        chunk = std::make_shared<Chunk>();
+        for (auto& ch : chunk->channel) ch.resize(CHUNK_SAMPLES);
+    };
+    auto handleLine = [&](const char* begin, const char* end) {
+        if (begin == end) {
+            return;
+        }
+        char first = *begin;
+        if (!((first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.')) {
+            return;  // 表头或注释
+        }
+        double ts;
+        float values[CHANNELS];
+        if (!parseLine(begin, end, ts, values)) {
+            bad_lines++;
+            return;
+        }
+        if (samples == 0) {
+            first_ts = ts;
+        }
+        last_ts = ts;
+        samples++;
+        for (int c = 0; c < CHANNELS; c++) {
+            chunk->channel[c][chunk->size] = values[c];
+        }
+        if (++chunk->size == CHUNK_SAMPLES) {
+            dispatch();
+        }
+    };
+
+    size_t n;
+    while ((n = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        const char* p = buffer.data();
+        const char* end = p + n;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (nl == nullptr) {
+                carry.append(p, end);
+                break;
+            }
+            if (!carry.empty()) {
+                carry.append(p, nl);
+                handleLine(carry.data(), carry.data() + carry.size());
+                carry.clear();
+            } else {
+                handleLine(p, nl);
+            }
+            p = nl + 1;
+        }
+    }
+    if (!carry.empty()) {
+        handleLine(carry.data(), carry.data() + carry.size());
+    }
+    std::fclose(file);
+    dispatch();
+    for (auto& queue : queues) {
+        queue.push(nullptr);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (samples < 3) {
+        std::cerr << "错误: 有效样本不足 (" << samples << ")" << std::endl;
+        return 1;
+    }
+    double tau0 = rate > 0.0 ? 1.0 / rate : (last_ts - first_ts) / 1000.0 / static_cast<double>(samples - 1);
+    if (tau0 <= 0.0) {
+        std::cerr << "错误: 无法由时间戳确定采样周期，请用 --rate 指定" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(output);
+    if (!out.is_open()) {
+        std::cerr << "错误: 无法写入 " << output << std::endl;
+        return 1;
+    }
+    out << "channel,tau_s,adev,terms\n" << std::setprecision(9);
+
+    std::cout << "样本数: " << samples << "  采样周期: " << tau0 * 1000.0 << " ms"
+              << "  时长: " << samples * tau0 / 3600.0 << " h";
+    if (bad_lines > 0) {
+        std::cout << "  无法解析的行: " << bad_lines;
+    }
+    std::cout << std::endl << std::endl;
+
+    for (int c = 0; c < CHANNELS; c++) {
+        std::vector<AllanPoint> points;
+        for (const Task& task : tasks) {
+            if (task.channel == c) {
+                std::vector<AllanPoint> part = task.accumulator->result();
+                points.insert(points.end(), part.begin(), part.end());
+            }
+        }
+        std::sort(points.begin(), points.end(),
+                  [](const AllanPoint& a, const AllanPoint& b) { return a.cluster_size < b.cluster_size; });
+
+        // 独立簇少于 3 个的点方差过大，不输出
+        std::vector<double> tau, adev;
+        for (const AllanPoint& p : points) {
+            if (p.cluster_size * 3 > samples) {
+                continue;
+            }
+            tau.push_back(p.cluster_size * tau0);
+            adev.push_back(std::sqrt(p.avar));
+            out << kChannelNames[c] << "," << tau.back() << "," << adev.back() << "," << p.terms << "\n";
+        }
+
+        AllanNoiseParams noise = extractAllanNoise(tau, adev);
+        std::cout << std::fixed << std::setprecision(6);
+        if (c < 3) {
+            std::cout << kChannelNames[c] << ": ARW=" << noise.random_walk * 60.0 << " deg/√h"
+                      << "  零偏不稳定性=" << noise.bias_instability * 3600.0 << " deg/h"
+                      << " (τ=" << std::setprecision(1) << noise.bias_instability_tau << "s)"
+                      << std::setprecision(6) << "  RRW=" << noise.rate_random_walk * 3600.0 * 60.0 << " deg/h/√h"
+                      << std::endl;
+        } else {
+            std::cout << kChannelNames[c] << ": VRW=" << noise.random_walk * 60.0 << " m/s/√h"
+                      << "  零偏不稳定性=" << noise.bias_instability << " m/s²"
+                      << " (τ=" << std::setprecision(1) << noise.bias_instability_tau << "s)"
+                      << std::setprecision(6) << "  RRW=" << noise.rate_random_walk << " m/s²/√s"
+                      << std::endl;
+        }
+        std::cout.unsetf(std::ios::fixed);
+    }
+    std::cout << std::endl << "Allan 偏差曲线已写入: " << output << std::endl;
+    return 0;
+}
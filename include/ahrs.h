@@ -0,0 +1,162 @@
+/*
+    * @file ahrs.h
+    * @brief 主机端姿态融合（Madgwick / Mahony / 误差状态 EKF）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef AHRS_H
+#define AHRS_H
+
+#include "imu_math.h"
+#include <memory>
+#include <string>
+
+// 融合算法
+enum class AHRSAlgorithm {
+    NONE = 0,       // 使用设备输出的四元数
+    MADGWICK,
+    MAHONY,
+    EKF             // 误差状态 EKF，估计姿态与陀螺零偏
+};
+
+// [AHRS] 配置
+struct AHRSConfig {
+    AHRSAlgorithm algorithm = AHRSAlgorithm::NONE;
+    bool use_mag = false;           // 是否融合磁力计（需订阅 0x08）
+    float beta = 0.1f;              // Madgwick 梯度步长
+    float kp = 0.5f;                // Mahony 比例增益
+    float ki = 0.0f;                // Mahony 积分增益
+    float gyro_noise = 0.01f;       // EKF 陀螺噪声 rad/s
+    float gyro_bias_noise = 1e-4f;  // EKF 零偏随机游走 rad/s/√s
+    float accel_noise = 0.05f;      // EKF 归一化加速度观测噪声
+    float mag_noise = 0.1f;         // EKF 归一化磁场观测噪声
+};
+
+// 解析算法名 (none/madgwick/mahony/ekf)，无法识别时返回 fallback
+AHRSAlgorithm parseAHRSAlgorithm(const std::string& name, AHRSAlgorithm fallback = AHRSAlgorithm::NONE);
+
+// 由静止时的加速度（与磁场）直接求姿态，无磁场时航向为 0
+Quatf alignToGravity(const Vec3f& accel, const Vec3f* mag = nullptr);
+
+// 姿态融合滤波器接口
+// gyro 单位 rad/s，accel 单位 m/s²（Madgwick/Mahony 只使用方向），mag 为空表示不融合磁力计，dt 单位 s。
+// 输出四元数与 IMUData::quat_* 约定一致（机体系到世界系，世界系 z 轴向上）
+class AHRSFilter {
+public:
+    virtual ~AHRSFilter() = default;
+
+    virtual void update(const Vec3f& gyro, const Vec3f& accel, const Vec3f* mag, float dt) = 0;
+
+    virtual Quatf orientation() const = 0;
+
+    virtual void reset() = 0;
+};
+
+// Madgwick 梯度下降滤波
+class MadgwickFilter : public AHRSFilter {
+public:
+    explicit MadgwickFilter(float beta = 0.1f);
+
+    void update(const Vec3f& gyro, const Vec3f& accel, const Vec3f* mag, float dt) override;
+    Quatf orientation() const override { return q_; }
+    void reset() override { q_ = Quatf{}; }
+
+private:
+    float beta_;
+    Quatf q_;
+};
+
+// Mahony 互补滤波（PI 反馈）
+class MahonyFilter : public AHRSFilter {
+public:
+    MahonyFilter(float kp = 0.5f, float ki = 0.0f);
+
+    void update(const Vec3f& gyro, const Vec3f& accel, const Vec3f* mag, float dt) override;
+    Quatf orientation() const override { return q_; }
+    void reset() override;
+
+private:
+    float kp_;
+    float ki_;
+    Quatf q_;
+    Vec3f integral_;
+};
+
+// 误差状态 EKF：名义状态为姿态四元数与陀螺零偏，误差状态 [δθ, δb] 为 6 维
+class ErrorStateEKF : public AHRSFilter {
+public:
+    explicit ErrorStateEKF(const AHRSConfig& config = AHRSConfig());
+
+    void update(const Vec3f& gyro, const Vec3f& accel, const Vec3f* mag, float dt) override;
+    Quatf orientation() const override { return q_; }
+    void reset() override;
+
+    // 当前估计的陀螺零偏 rad/s
+    Vec3f gyroBias() const { return bias_; }
+
+private:
+    // 以观测 z 与预测 h（均为机体系单位向量）做一次三维更新
+    void correct(const Vec3f& z, const Vec3f& h, float noise);
+
+    AHRSConfig config_;
+    bool initialized_;  // 首帧用加速度（与磁场）对准姿态
+    Quatf q_;
+    Vec3f bias_;
+    float P_[6][6];
+};
+
+// 按配置创建滤波器，algorithm=NONE 时返回空
+std::unique_ptr<AHRSFilter> createAHRSFilter(const AHRSConfig& config);
+
+// 多通道并行姿态融合的通道数
+constexpr int AHRS_BATCH_LANES = 8;
+
+// 多通道 Madgwick / Mahony（六轴或九轴），用于在同一线程上同时更新多个设备的姿态。
+// 状态按结构数组存放，各通道运算相同、条件均为按通道选择，对通道的循环可由编译器自动向量化。
+// 与单通道滤波器的区别：
+//   - 各输入为 AHRS_BATCH_LANES 个通道的数组，单位与 AHRSFilter::update() 相同；
+//   - mx 为空时按六轴更新；九轴时磁场为零的通道按六轴更新，加速度为零的通道只积分角速度；
+//   - dt 为各通道的步长，为 0 的通道保持原姿态（如本次没有新样本的设备）；
+//   - Mahony 的积分项（陀螺零偏补偿）在加速度为零的通道上仍然生效，只是不再累加。
+// EKF 状态含 6x6 协方差，不提供批量版本，algorithm 为 NONE / EKF 时 enabled() 返回 false
+class AHRSBatch {
+public:
+    explicit AHRSBatch(const AHRSConfig& config = AHRSConfig());
+
+    bool enabled() const {
+        return algorithm_ == AHRSAlgorithm::MADGWICK || algorithm_ == AHRSAlgorithm::MAHONY;
+    }
+
+    void update(const float* gx, const float* gy, const float* gz,
+                const float* ax, const float* ay, const float* az,
+                const float* mx, const float* my, const float* mz, const float* dt);
+
+    Quatf orientation(int lane) const { return {qw_[lane], qx_[lane], qy_[lane], qz_[lane]}; }
+
+    void reset();
+
+private:
+    template <bool Mag>
+    void updateMadgwick(const float* gx, const float* gy, const float* gz,
+                        const float* ax, const float* ay, const float* az,
+                        const float* mx, const float* my, const float* mz, const float* dt);
+    template <bool Mag>
+    void updateMahony(const float* gx, const float* gy, const float* gz,
+                      const float* ax, const float* ay, const float* az,
+                      const float* mx, const float* my, const float* mz, const float* dt);
+
+    AHRSAlgorithm algorithm_;
+    float beta_;
+    float kp_;
+    float ki_;
+    alignas(32) float qw_[AHRS_BATCH_LANES];
+    alignas(32) float qx_[AHRS_BATCH_LANES];
+    alignas(32) float qy_[AHRS_BATCH_LANES];
+    alignas(32) float qz_[AHRS_BATCH_LANES];
+    alignas(32) float ix_[AHRS_BATCH_LANES];  // Mahony 积分项
+    alignas(32) float iy_[AHRS_BATCH_LANES];
+    alignas(32) float iz_[AHRS_BATCH_LANES];
+};
+
+#endif // AHRS_H
@@ -0,0 +1,80 @@
+/*
+    * @file allan_variance.h
+    * @brief 流式重叠 Allan 方差（有界内存）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef ALLAN_VARIANCE_H
+#define ALLAN_VARIANCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 每个抽取层级保存的累积和个数：簇大小 m = q * 2^L，q ∈ [ALLAN_LEVEL_MIN_Q, 2*ALLAN_LEVEL_MIN_Q)
+constexpr int ALLAN_LEVEL_MIN_Q = 16;
+constexpr int ALLAN_LEVEL_RING = 4 * ALLAN_LEVEL_MIN_Q;
+
+// 单个簇大小的结果
+struct AllanPoint {
+    uint64_t cluster_size = 0;  // 簇大小 m（样本数）
+    double avar = 0.0;          // Allan 方差（输入单位²）
+    uint64_t terms = 0;         // 参与平均的二次差分项数
+};
+
+// 按对数间隔生成簇大小（每十倍频程 points_per_decade 个），并对齐到所在层级的步长
+std::vector<uint64_t> allanClusterSizes(uint64_t max_cluster, int points_per_decade = 10);
+
+// 单通道流式重叠 Allan 方差
+// 簇大小 m < 2*ALLAN_LEVEL_MIN_Q 时按步长 1 完全重叠；更大的 m 在层级 L 上以步长 2^L 重叠，
+// 只需保存该层级最近 ALLAN_LEVEL_RING 个累积和，内存与记录长度无关。
+// 步长不超过 m/ALLAN_LEVEL_MIN_Q，与完全重叠的估计差异可以忽略
+class AllanVarianceAccumulator {
+public:
+    // cluster_sizes 需由 allanClusterSizes() 生成（或其子集）
+    explicit AllanVarianceAccumulator(const std::vector<uint64_t>& cluster_sizes);
+
+    // 输入一个样本
+    void add(double value);
+
+    // 批量输入
+    void add(const float* values, size_t count, size_t stride = 1);
+
+    uint64_t samples() const { return n_; }
+
+    // 当前结果（terms 为 0 的簇大小不输出）
+    std::vector<AllanPoint> result() const;
+
+private:
+    struct Cluster {
+        uint64_t m;         // 簇大小
+        int q;              // 以层级步长计的簇大小
+        double sum_sq;      // 二次差分平方和
+        uint64_t terms;
+    };
+
+    struct Level {
+        uint64_t stride;            // 2^L
+        double ring[ALLAN_LEVEL_RING];
+        uint64_t count;             // 已写入的累积和个数
+        std::vector<Cluster> clusters;
+    };
+
+    std::vector<Level> levels_;
+    double theta_;                  // 去均值后的累积和
+    double offset_;                 // 首样本值，减去以控制累积和量级
+    uint64_t n_;
+};
+
+// 从 Allan 偏差曲线提取噪声参数（tau 单位 s，adev 与输入同单位）
+struct AllanNoiseParams {
+    double random_walk = 0.0;       // 角度/速度随机游走，σ(1s)（斜率 -1/2 段）
+    double bias_instability = 0.0;  // 零偏不稳定性 = 最小偏差 / 0.664
+    double bias_instability_tau = 0.0;
+    double rate_random_walk = 0.0;  // 速率随机游走，σ(3s)（斜率 +1/2 段）
+};
+
+AllanNoiseParams extractAllanNoise(const std::vector<double>& tau, const std::vector<double>& adev);
+
+#endif // ALLAN_VARIANCE_H
@@ -0,0 +1,220 @@
+/*
+    * @file async_logger.h
+    * @brief 异步无锁日志头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <type_traits>
+
+// 日志等级
+enum class LogLevel : uint8_t {
+    TRACE = 0,  // 逐帧日志
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    OFF
+};
+
+constexpr int LOG_MAX_ARGS = 8;         // 每条日志最多参数个数
+constexpr int LOG_TEXT_BYTES = 96;      // 字符串参数拷贝区大小
+constexpr size_t LOG_RING_CAPACITY = 1024;  // 每线程环形缓冲条数（2的幂）
+
+// 日志参数类型
+enum class LogArgType : uint8_t {
+    I64 = 0,
+    U64,
+    F64,
+    STR
+};
+
+// 日志记录：格式串指针作为格式 id，参数按原始值保存，由后台线程格式化
+struct LogRecord {
+    const char* fmt;            // 静态格式串，占位符 {} / {:x} / {:02x} / {:.1f}
+    uint64_t time_ns;
+    LogLevel level;
+    uint8_t nargs;
+    uint8_t text_len;
+    LogArgType types[LOG_MAX_ARGS];
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        uint16_t str_off;
+    } args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+};
+
+// 单生产者单消费者环形缓冲（生产者为写日志的线程，消费者为后台线程）
+class LogRing {
+public:
+    LogRing() : head_(0), tail_(0) {}
+
+    // 取得可写槽位，满时返回 nullptr
+    LogRecord* reserve() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= LOG_RING_CAPACITY) {
+            return nullptr;
+        }
+        return &records_[head & (LOG_RING_CAPACITY - 1)];
+    }
+
+    // 发布 reserve() 得到的槽位，返回发布前消费者是否已取空（此时需唤醒消费者）
+    // head_ 写入与 tail_ 读取之间的全屏障与 pop() 配对：返回 false 时消费者取出前一条后必能看到这一条
+    bool commit() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return tail_.load(std::memory_order_relaxed) == head;
+    }
+
+    // 消费者：取出最早一条，空时返回 nullptr
+    const LogRecord* front() const {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &records_[tail & (LOG_RING_CAPACITY - 1)];
+    }
+
+    // 消费者：释放 front() 返回的槽位
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    bool empty() const {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+    LogRecord records_[LOG_RING_CAPACITY];
+};
+
+// 异步日志
+// 热路径只检查等级并把格式串指针与原始参数写入本线程环形缓冲，
+// 格式化与 iostream 输出全部在后台线程完成；缓冲满时丢弃并计数，从不阻塞调用者。
+// 后台线程空闲时阻塞在条件变量上，只有缓冲由空变为非空的那一条日志才加锁唤醒它
+class AsyncLogger {
+public:
+    // 运行时修改日志等级（任意线程）
+    static void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    static LogLevel level() { return level_.load(std::memory_order_relaxed); }
+    static bool enabled(LogLevel level) {
+        return static_cast<uint8_t>(level) >= static_cast<uint8_t>(level_.load(std::memory_order_relaxed));
+    }
+
+    // 解析等级名称 (trace/debug/info/warn/error/off)，无法识别时返回 fallback
+    static LogLevel parseLevel(const std::string& name, LogLevel fallback);
+
+    // 写入一条日志
+    template <typename... Args>
+    static void log(LogLevel level, const char* fmt, const Args&... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+        if (!enabled(level)) {
+            return;
+        }
+        LogRing* ring = threadRing();
+        LogRecord* rec = ring->reserve();
+        if (rec == nullptr) {
+            instance().dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        rec->fmt = fmt;
+        rec->time_ns = nowNs();
+        rec->level = level;
+        rec->nargs = 0;
+        rec->text_len = 0;
+        (encode(*rec, args), ...);
+        if (ring->commit()) {
+            instance().wake();
+        }
+    }
+
+    // 等待所有已写入的日志输出完成
+    static void flush();
+
+    // 丢弃的日志条数
+    static uint64_t droppedCount() { return instance().dropped_.load(std::memory_order_relaxed); }
+
+    ~AsyncLogger();
+
+private:
+    AsyncLogger();
+
+    static AsyncLogger& instance();
+    static LogRing* threadRing();
+    static uint64_t nowNs();
+
+    // 参数编码
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    encode(LogRecord& rec, const T& v) {
+        rec.types[rec.nargs] = LogArgType::I64;
+        rec.args[rec.nargs++].i = v;
+    }
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+    encode(LogRecord& rec, const T& v) {
+        rec.types[rec.nargs] = LogArgType::U64;
+        rec.args[rec.nargs++].u = v;
+    }
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    encode(LogRecord& rec, const T& v) {
+        rec.types[rec.nargs] = LogArgType::F64;
+        rec.args[rec.nargs++].d = v;
+    }
+    template <typename T>
+    static void encode(LogRecord& rec, const std::atomic<T>& v) { encode(rec, v.load(std::memory_order_relaxed)); }
+    static void encode(LogRecord& rec, const char* s) { encodeText(rec, s, s ? strlen(s) : 0); }
+    static void encode(LogRecord& rec, const std::string& s) { encodeText(rec, s.data(), s.size()); }
+
+    // 字符串参数拷贝到记录内（超长截断）
+    static void encodeText(LogRecord& rec, const char* s, size_t len);
+
+    // 后台线程
+    void writerThread();
+    void drainAll();
+    void wake();
+    bool allEmpty();
+
+    static std::atomic<LogLevel> level_;
+
+    std::mutex rings_mutex_;  // 仅在线程首次写日志注册缓冲时使用
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t reported_dropped_;  // 已提示过的丢弃条数（仅后台线程访问）
+
+    // 后台线程的唤醒与空闲状态，由 wake_mutex_ 保护
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;   // 唤醒后台线程
+    std::condition_variable idle_cv_;   // 后台线程完成一轮输出，flush() 等待它
+    bool pending_;                      // 有缓冲由空变为非空，尚未输出
+    bool draining_;                     // 后台线程正在输出
+    bool running_;
+    std::thread writer_thread_;
+};
+
+#define LOG_TRACE(...) AsyncLogger::log(LogLevel::TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) AsyncLogger::log(LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  AsyncLogger::log(LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(...)  AsyncLogger::log(LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) AsyncLogger::log(LogLevel::ERROR, __VA_ARGS__)
+
+#endif // ASYNC_LOGGER_H
@@ -10,10 +10,19 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+// 两份配置之间变化的键
+struct ConfigChange {
+    std::string section;
+    std::string key;
+    std::string old_value;      // 为空表示新增
+    std::string new_value;      // 为空表示删除
+};
+
 // 配置文件解析器
 class ConfigParser {
 public:
@@ -32,11 +41,25 @@ public:
     // 获取浮点数值
     float getFloat(const std::string& section, const std::string& key, float default_value = 0.0f);
 
+    // 获取逗号分隔的浮点数列表，键不存在时返回默认值
+    std::vector<float> getFloatList(const std::string& section, const std::string& key,
+                                    const std::vector<float>& default_value = {});
+
     // 获取布尔值
     bool getBool(const std::string& section, const std::string& key, bool default_value = false);
 
+    // 与另一份配置比较，按节、键顺序返回取值不同的键（值按原文比较）
+    std::vector<ConfigChange> diff(const ConfigParser& other) const;
+
+    // 节名，按在文件中首次出现的顺序
+    const std::vector<std::string>& sections() const { return section_order_; }
+
+    // 节内全部键值（按键名有序），节不存在时返回 nullptr
+    const std::map<std::string, std::string>* section(const std::string& name) const;
+
 private:
     std::map<std::string, std::map<std::string, std::string>> config_data_;
+    std::vector<std::string> section_order_;
 
     // 去除字符串首尾空白
     std::string trim(const std::string& str);
@@ -0,0 +1,52 @@
+/*
+    * @file config_watcher.h
+    * @brief 基于 inotify 的配置文件变更监视头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+// 配置文件变更回调（在监视线程调用）
+using ConfigChangedCallback = std::function<void()>;
+
+// 配置文件监视
+// 监视文件所在目录而不是文件本身：编辑器常以“写临时文件再改名”的方式保存，
+// 直接监视文件会在改名后失效。目录中同名文件写入完成 (IN_CLOSE_WRITE) 或被改名/移动到此
+// (IN_MOVED_TO) 时记为一次变更，之后 debounce_ms 内没有新事件才调用回调，
+// 避免一次保存触发多次重载。停止通过 eventfd 唤醒 poll()，不依赖超时
+class ConfigWatcher {
+public:
+    ConfigWatcher();
+    ~ConfigWatcher();
+
+    // 开始监视 filename，失败（如系统不支持 inotify）时返回 false
+    bool start(const std::string& filename, int debounce_ms, ConfigChangedCallback callback);
+
+    // 停止监视线程
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+private:
+    void watchThread();
+
+    // 读取并匹配 inotify 事件，返回是否涉及被监视的文件
+    bool readEvents();
+
+    std::string basename_;
+    int debounce_ms_;
+    int inotify_fd_;
+    int wake_fd_;
+    ConfigChangedCallback callback_;
+    std::thread watch_thread_;
+    std::atomic<bool> running_;
+};
+
+#endif // CONFIG_WATCHER_H
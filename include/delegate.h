@@ -0,0 +1,60 @@
+/*
+    * @file delegate.h
+    * @brief 无堆分配的轻量回调头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef DELEGATE_H
+#define DELEGATE_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity = 2 * sizeof(void*)>
+class Delegate;
+
+// 轻量回调
+// 可调用对象（函数指针、lambda）按值保存在内部定长缓冲区中，没有堆分配回退：超出容量、
+// 对齐要求过高或不可平凡拷贝/析构的对象在编译期报错。调用为一次间接跳转，拷贝为按位拷贝。
+// 捕获 this 或少量引用的 lambda 均可直接使用；需要捕获 std::string 等对象时改用 std::function
+template <typename R, typename... Args, size_t Capacity>
+class Delegate<R(Args...), Capacity> {
+public:
+    Delegate() = default;
+    Delegate(std::nullptr_t) {}
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, Delegate>::value &&
+                                                      std::is_invocable_r<R, std::decay_t<F>&, Args...>::value>>
+    Delegate(F&& f) {
+        using Callable = std::decay_t<F>;
+        static_assert(sizeof(Callable) <= Capacity, "可调用对象超出 Delegate 容量");
+        static_assert(alignof(Callable) <= alignof(void*), "可调用对象对齐要求过高");
+        static_assert(std::is_trivially_copyable<Callable>::value && std::is_trivially_destructible<Callable>::value,
+                      "Delegate 只保存可平凡拷贝与析构的可调用对象");
+        Callable callable(std::forward<F>(f));
+        if constexpr (std::is_pointer<Callable>::value) {
+            if (callable == nullptr) {
+                return;
+            }
+        }
+        new (storage_) Callable(callable);
+        invoke_ = [](void* storage, Args... args) -> R {
+            return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+        };
+    }
+
+    R operator()(Args... args) const {
+        return invoke_(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+private:
+    R (*invoke_)(void*, Args...) = nullptr;
+    alignas(void*) unsigned char storage_[Capacity] = {};
+};
+
+#endif // DELEGATE_H
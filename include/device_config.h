@@ -0,0 +1,50 @@
+/*
+    * @file device_config.h
+    * @brief 多设备配置节解析与校验头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef DEVICE_CONFIG_H
+#define DEVICE_CONFIG_H
+
+#include "config_parser.h"
+#include <string>
+#include <vector>
+
+// 设备数上限
+constexpr int IMU_MAX_DEVICES = 32;
+
+// 多设备配置节名前缀：[IMU.<name>]
+constexpr const char* IMU_DEVICE_SECTION_PREFIX = "IMU.";
+
+// 单个设备的串口与 IMU 参数（含义同 [Serial] 与 [IMU] 的同名选项）
+struct IMUDeviceConfig {
+    std::string name;               // 设备名，即 [IMU.<name>] 中的 name；单设备配置为空
+    std::string port = "/dev/ttyUSB0";
+    int baudrate = 115200;
+    int timeout = 1000;
+    int device_address = 255;
+    int report_rate = 60;
+    int subscribe_tag = 0x7F;
+    bool host_derive = false;
+    bool compass_on = false;
+    int barometer_filter = 2;
+    int gyro_filter = 1;
+    int acc_filter = 3;
+    int compass_filter = 5;
+};
+
+// 解析单设备配置（[Serial] 与 [IMU]），校验错误追加到 errors，无错误时返回 true
+bool parseDeviceConfig(const ConfigParser& config, IMUDeviceConfig& device, std::vector<std::string>& errors);
+
+// 解析多设备配置
+// 每个 [IMU.<name>] 节以 [Serial] 与 [IMU] 为默认值，只写与默认不同的键（串口键也写在该节内）；
+// inherit=<name> 改为以文件中在它之前的另一个设备为默认值。按节在文件中出现的顺序返回，
+// 没有 [IMU.<name>] 节时返回单个默认设备。
+// 一趟完成：默认节只解析一次，每个设备节的每个键只访问一次。全部错误（取值无效、超出范围、
+// 未知键、端口重复、设备数超限）一并追加到 errors，无错误时返回 true
+bool parseDeviceConfigs(const ConfigParser& config, std::vector<IMUDeviceConfig>& devices,
+                        std::vector<std::string>& errors);
+
+#endif // DEVICE_CONFIG_H
@@ -0,0 +1,42 @@
+/*
+    * @file fft.h
+    * @brief 自包含的基 2 实数 FFT 头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <vector>
+
+// 实数 FFT：长度 n（2 的幂，≥ 4）的实序列由 n/2 点复数 FFT 加后处理求得
+// 旋转因子与位反转表在构造时生成，forward() 不分配内存。非线程安全，每个线程各用一个实例
+class RealFFT {
+public:
+    explicit RealFFT(int n);
+
+    int size() const { return n_; }
+
+    // in 为 n 个实数，out 为 n/2 + 1 个复数（0 到 Nyquist）
+    void forward(const float* in, std::complex<float>* out);
+
+    // 逆变换：in 为 n/2 + 1 个复数，out 为 n 个实数（已除以 n）
+    void inverse(const std::complex<float>* in, float* out);
+
+    static bool isPowerOfTwo(int n) { return n >= 4 && (n & (n - 1)) == 0; }
+
+private:
+    // 原地 n/2 点复数 FFT，sign = -1 为正变换，+1 为逆变换
+    void complexFFT(std::complex<float>* data, int sign);
+
+    int n_;
+    int half_;
+    std::vector<int> bitrev_;
+    std::vector<std::complex<float>> twiddle_;       // exp(-2πi j / half)，j < half/2
+    std::vector<std::complex<float>> post_twiddle_;  // exp(-2πi k / n)，k ≤ half
+    std::vector<std::complex<float>> work_;
+};
+
+#endif // FFT_H
@@ -0,0 +1,34 @@
+/*
+    * @file field_derivation.h
+    * @brief 主机端字段推导（带宽优化订阅）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef FIELD_DERIVATION_H
+#define FIELD_DERIVATION_H
+
+#include "imu_parser.h"
+#include <cstdint>
+
+// 设备换算加速度时使用的重力常数 (SCALE_ACCEL = 16g / 32768)
+constexpr F32 DEVICE_GRAVITY = 9.8f;
+
+// 订阅规划结果
+struct DerivationPlan {
+    uint16_t requested_tag = 0;  // 用户需要的字段
+    uint16_t device_tag = 0;     // 实际向设备订阅的字段
+    uint16_t derive_tag = 0;     // 由主机推导的字段（0x01 和/或 0x40）
+};
+
+// 求数据体最小的设备订阅：
+//   欧拉角(0x40)       <- 四元数(0x20)
+//   加速度不含重力(0x01) <- 加速度含重力(0x02) + 四元数(0x20)
+// 只有在推导所需的额外字段比被推导字段更小（或已被订阅）时才推导
+DerivationPlan planDerivation(uint16_t requested_tag);
+
+// 按 derive_tag 填充推导字段，并在 subscribe_tag 中置位
+// 读取线程与虚拟 IMU 都是逐帧产出样本，推导在解析后的同一帧上就地完成
+void deriveFields(IMUData& data, uint16_t derive_tag);
+
+#endif // FIELD_DERIVATION_H
@@ -0,0 +1,120 @@
+/*
+    * @file field_statistics.h
+    * @brief IMUData 各字段滑动窗口统计（最小/最大/均值/标准差）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef FIELD_STATISTICS_H
+#define FIELD_STATISTICS_H
+
+#include "imu_parser.h"
+#include "seqlock.h"
+#include <cstdint>
+#include <vector>
+
+// 同时统计的窗口数上限
+constexpr int FIELD_STATS_MAX_WINDOWS = 4;
+
+// [Statistics] 配置
+struct FieldStatisticsConfig {
+    bool enabled = false;
+    std::vector<float> windows_s = {1.0f, 10.0f, 60.0f};  // 窗口长度（秒），最多 FIELD_STATS_MAX_WINDOWS 个
+    int publish_interval_ms = 100;  // 快照发布间隔（设备时间，0 = 每帧发布）
+};
+
+// 单个窗口的统计结果，数组下标同 IMU_FIELD_MEMBERS
+struct FieldWindowStats {
+    float seconds = 0.0f;           // 窗口长度
+    uint32_t samples = 0;           // 窗口内样本数（未填满时小于容量）
+    float min[IMU_FLOAT_FIELDS] = {};
+    float max[IMU_FLOAT_FIELDS] = {};
+    float mean[IMU_FLOAT_FIELDS] = {};
+    float stddev[IMU_FLOAT_FIELDS] = {};    // 样本标准差 (n - 1)
+};
+
+// 统计快照；未订阅字段按 0 参与统计，以 subscribe_tag 与 IMU_FIELD_TAGS 判断字段是否有效
+struct FieldStatsSnapshot {
+    uint32_t timestamp = 0;         // 最后一帧的设备时间戳
+    uint16_t subscribe_tag = 0;     // 最后一帧的订阅标签
+    int windows = 0;
+    FieldWindowStats window[FIELD_STATS_MAX_WINDOWS];
+};
+
+// 固定样本数的滑动窗口，所有字段共用同一时间线，按 [样本][字段] 结构数组存放
+// 均值与方差用 Welford 增量更新（新样本替换最旧样本）；最小/最大值用环形缓冲上的双栈队列：
+// 较旧的一段（出栈）保存到段尾的后缀最值，较新的一段（入栈）只维护整体最值，
+// 出栈耗尽时把整个窗口转为出栈并重算后缀最值，同时精确重算均值与方差以消除累积误差，
+// 均摊每样本 O(字段数)。各字段的内层循环相互独立，可被编译器向量化
+class SlidingFieldWindow {
+public:
+    SlidingFieldWindow();
+
+    // 分配容量为 capacity 个样本的缓冲（≥ 2）并清空
+    void configure(int capacity);
+
+    // 清空窗口，不释放缓冲
+    void reset();
+
+    // 加入一个样本（IMU_FLOAT_FIELDS 个值），窗口已满时替换最旧样本
+    void push(const float* sample);
+
+    // 填充统计结果（不含 seconds）
+    void fill(FieldWindowStats& out) const;
+
+    int capacity() const { return capacity_; }
+    int count() const { return count_; }
+
+private:
+    // 把整个窗口转为出栈段
+    void transfer();
+
+    int capacity_;
+    int head_;                      // 最旧样本所在槽位
+    int count_;
+    int out_count_;                 // 出栈段剩余样本数（从 head_ 开始）
+    std::vector<float> values_;     // capacity_ x IMU_FLOAT_FIELDS
+    std::vector<float> out_min_;    // 出栈段内从该槽位到段尾的最小值
+    std::vector<float> out_max_;
+    float in_min_[IMU_FLOAT_FIELDS];
+    float in_max_[IMU_FLOAT_FIELDS];
+    double mean_[IMU_FLOAT_FIELDS];
+    double m2_[IMU_FLOAT_FIELDS];   // 与均值差的平方和
+};
+
+// 多窗口字段统计
+// update() 仅由读取线程调用，运行中不分配内存；快照通过顺序锁发布，可在任意线程无锁读取
+class FieldStatistics {
+public:
+    FieldStatistics();
+
+    // 按输入采样率分配各窗口（在读取线程运行前调用）
+    void configure(const FieldStatisticsConfig& config, double sample_rate);
+
+    // 输入一帧
+    void update(const IMUData& data);
+
+    // 清空所有窗口
+    void reset();
+
+    // 与 staged（已按新采样率 configure()）交换配置与窗口缓冲并清空统计，不分配内存，已发布的快照保留；
+    // 供读取线程在上报频率变化时切换，原缓冲随 staged 在调用方线程释放
+    void adopt(FieldStatistics& staged);
+
+    // 最近发布的快照（可在任意线程调用）
+    FieldStatsSnapshot snapshot() const { return snapshot_.load(); }
+
+private:
+    void publish(const IMUData& data);
+
+    FieldStatisticsConfig config_;
+    int windows_;
+    float seconds_[FIELD_STATS_MAX_WINDOWS];
+    SlidingFieldWindow window_[FIELD_STATS_MAX_WINDOWS];
+    bool has_publish_;
+    uint32_t last_publish_ms_;
+
+    SeqLock<FieldStatsSnapshot> snapshot_;
+};
+
+#endif // FIELD_STATISTICS_H
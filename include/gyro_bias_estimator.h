@@ -0,0 +1,87 @@
+/*
+    * @file gyro_bias_estimator.h
+    * @brief 静止检测与随温度变化的陀螺零偏在线估计头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef GYRO_BIAS_ESTIMATOR_H
+#define GYRO_BIAS_ESTIMATOR_H
+
+#include "imu_parser.h"
+#include "imu_math.h"
+#include <string>
+
+// 静止检测窗口的最大样本数
+constexpr int GYRO_BIAS_WINDOW_MAX = 256;
+
+// [GyroBias] 配置
+struct GyroBiasConfig {
+    bool enabled = false;
+    int window_ms = 1000;           // 静止检测窗口
+    float accel_std = 0.05f;        // 窗口内加速度模长标准差阈值 m/s²
+    float gyro_std = 0.3f;          // 窗口内各轴角速度标准差阈值 dps
+    float gyro_max = 5.0f;          // 窗口内角速度均值上限 dps（超过视为在转动）
+    float forgetting = 0.99f;       // 每次静止观测前旧数据的衰减系数
+    std::string state_file;         // 零偏模型持久化文件（空=不保存）
+};
+
+// 陀螺零偏估计器
+// 静止判定：最近 window_ms 内加速度模长与三轴角速度的方差均低于阈值；
+// 每经过一个完整的静止窗口，以窗口均值作为一次零偏观测，按温度做加权线性回归
+// bias(T) = mean_b + slope * (T - mean_T)，温度跨度不足时退化为加权均值。
+// 所有统计为滑动和与回归累加量，每样本 O(1)，仅由读取线程调用
+class GyroBiasEstimator {
+public:
+    GyroBiasEstimator();
+
+    // 设置参数与期望帧间隔，清空窗口（保留已学习的零偏模型）
+    void configure(const GyroBiasConfig& config, double period_ms);
+
+    // 输入原始样本（需订阅角速度），返回当前是否静止
+    bool update(const IMUData& data);
+
+    // 从 data 的角速度中扣除对应温度下的零偏
+    void apply(IMUData& data) const;
+
+    // 指定温度下的零偏 dps
+    Vec3f biasAt(float temperature) const;
+
+    bool isStationary() const { return stationary_; }
+
+    // 已累计的静止观测次数
+    uint64_t observations() const { return observations_; }
+
+    // 保存 / 加载零偏模型（INI 格式）
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    // 清空窗口与零偏模型
+    void reset();
+
+private:
+    void clearWindow();
+
+    GyroBiasConfig config_;
+    int window_;
+
+    // 滑动窗口：通道 0-2 为角速度，3 为加速度模长
+    float ring_[GYRO_BIAS_WINDOW_MAX][4];
+    int head_;
+    int count_;
+    double sum_[4];
+    double sumsq_[4];
+    double temp_sum_;
+    int since_observation_;
+    bool stationary_;
+
+    // 加权回归累加量
+    double w_;
+    double wt_;
+    double wtt_;
+    double wb_[3];
+    double wtb_[3];
+    uint64_t observations_;
+};
+
+#endif // GYRO_BIAS_ESTIMATOR_H
@@ -0,0 +1,126 @@
+/*
+    * @file imu_frame_view.h
+    * @brief 传感器数据帧零拷贝视图头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef IMU_FRAME_VIEW_H
+#define IMU_FRAME_VIEW_H
+
+#include "imu_math.h"
+#include "imu_parser.h"
+#include "imu_raw_decode.h"
+#include <cstdint>
+
+// 字段组偏移表：offset[存在掩码][订阅标签位] 为该字段组在数据体中的起始偏移（不存在时为 -1），
+// offset[存在掩码][7] 为数据体有效字节数。由 IMU_RAW_GROUP_BYTES 在编译期生成
+struct IMUFrameOffsetTable {
+    int8_t offset[128][8];
+};
+
+constexpr IMUFrameOffsetTable makeIMUFrameOffsetTable() {
+    IMUFrameOffsetTable table{};
+    for (int present = 0; present < 128; present++) {
+        int size = 0;
+        for (int bit = 0; bit < 7; bit++) {
+            if (present & (1 << bit)) {
+                table.offset[present][bit] = static_cast<int8_t>(size);
+                size += IMU_RAW_GROUP_BYTES[bit];
+            } else {
+                table.offset[present][bit] = -1;
+            }
+        }
+        table.offset[present][7] = static_cast<int8_t>(size);
+    }
+    return table;
+}
+
+inline constexpr IMUFrameOffsetTable IMU_FRAME_OFFSETS = makeIMUFrameOffsetTable();
+
+// 传感器数据帧视图
+// 指向已校验帧的数据体，不拷贝也不预先解码：访问字段时查表得到偏移，只解码被访问的字段，
+// 数值与 IMUParser 的数据回调逐位一致。present 为数据体中完整出现的字段组（见 rawPresentGroups()）。
+// 视图只在回调期间有效，需要保留时用 toIMUData() 或 IMURawSample::assign() 拷贝
+class IMUFrameView {
+public:
+    IMUFrameView(const U8* payload, uint16_t present, uint32_t timestamp)
+        : payload_(payload), present_(present & 0x7F), timestamp_(timestamp) {}
+
+    uint32_t timestamp() const { return timestamp_; }
+
+    // 存在掩码（含义同订阅标签）
+    uint16_t subscribeTag() const { return present_; }
+
+    // 是否包含 group 的全部字段组
+    bool has(uint16_t group) const { return (present_ & group) == group; }
+
+    // 数据体起始地址与有效字节数
+    const U8* payload() const { return payload_; }
+    int payloadBytes() const { return IMU_FRAME_OFFSETS.offset[present_][7]; }
+
+    // 原始计数：group 为单个字段组位，index 为组内字段序号（温度组：0 温度，1 气压，2 高度）。
+    // 字段组不存在时返回 0
+    int32_t raw(uint16_t group, int index) const {
+        int bit = groupBit(group);
+        int base = bit < 7 ? offset(bit) : -1;
+        if (base < 0) {
+            return 0;
+        }
+        if (group == 0x0010) {
+            return index == 0 ? readS16(payload_ + base) : readS24(payload_ + base + 2 + (index - 1) * 3);
+        }
+        return readS16(payload_ + base + index * 2);
+    }
+
+    // 缩放后的物理量（字段组不存在时为零值）
+    Vec3f accel() const { return vec3(0, SCALE_ACCEL); }
+    Vec3f accelWithGravity() const { return vec3(1, SCALE_ACCEL); }
+    Vec3f gyro() const { return vec3(2, SCALE_ANGLE_SPEED); }
+    Vec3f mag() const { return vec3(3, SCALE_MAG); }
+    Vec3f euler() const { return vec3(6, SCALE_ANGLE); }
+    float temperature() const { return raw(0x0010, 0) * SCALE_TEMPERATURE; }
+    float pressure() const { return raw(0x0010, 1) * SCALE_AIR_PRESSURE; }
+    float height() const { return raw(0x0010, 2) * SCALE_HEIGHT; }
+    Quatf quat() const {
+        int base = offset(5);
+        if (base < 0) {
+            return Quatf{0.0f, 0.0f, 0.0f, 0.0f};
+        }
+        return Quatf{readS16(payload_ + base) * SCALE_QUAT, readS16(payload_ + base + 2) * SCALE_QUAT,
+                     readS16(payload_ + base + 4) * SCALE_QUAT, readS16(payload_ + base + 6) * SCALE_QUAT};
+    }
+
+    // 航向角（欧拉角 z）度，只解码 2 字节
+    float yaw() const { return raw(0x0040, 2) * SCALE_ANGLE; }
+
+    // 完整解码为 IMUData（不存在的字段为 0）
+    IMUData toIMUData() const;
+
+private:
+    int offset(int bit) const { return IMU_FRAME_OFFSETS.offset[present_][bit]; }
+
+    // 单个字段组位的序号，不是单个字段组位时返回 7
+    static int groupBit(uint16_t group) {
+        int bit = 0;
+        while (bit < 7 && (group >> bit) != 1) {
+            bit++;
+        }
+        return bit;
+    }
+
+    Vec3f vec3(int bit, float scale) const {
+        int base = offset(bit);
+        if (base < 0) {
+            return Vec3f{};
+        }
+        return Vec3f{readS16(payload_ + base) * scale, readS16(payload_ + base + 2) * scale,
+                     readS16(payload_ + base + 4) * scale};
+    }
+
+    const U8* payload_;
+    uint16_t present_;
+    uint32_t timestamp_;
+};
+
+#endif // IMU_FRAME_VIEW_H
@@ -0,0 +1,84 @@
+/*
+    * @file imu_math.h
+    * @brief 定长向量/四元数运算（无动态分配）
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef IMU_MATH_H
+#define IMU_MATH_H
+
+#include <cmath>
+
+constexpr float DEG_TO_RAD = 0.017453292519943295f;
+constexpr float RAD_TO_DEG = 57.29577951308232f;
+
+// 三维向量
+struct Vec3f {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+inline Vec3f operator+(const Vec3f& a, const Vec3f& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+inline Vec3f operator-(const Vec3f& a, const Vec3f& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+inline Vec3f operator*(const Vec3f& a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+inline float dot(const Vec3f& a, const Vec3f& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Vec3f cross(const Vec3f& a, const Vec3f& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+inline float norm(const Vec3f& v) { return std::sqrt(dot(v, v)); }
+inline Vec3f normalized(const Vec3f& v) {
+    float n = norm(v);
+    return n > 0.0f ? v * (1.0f / n) : v;
+}
+
+// 单位四元数，表示机体系到世界系的旋转（Hamilton 约定，w 为实部）
+struct Quatf {
+    float w = 1.0f, x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+inline Quatf operator*(const Quatf& a, const Quatf& b) {
+    return {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+}
+inline Quatf conjugate(const Quatf& q) { return {q.w, -q.x, -q.y, -q.z}; }
+inline Quatf normalized(const Quatf& q) {
+    float n = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    return n > 0.0f ? Quatf{q.w / n, q.x / n, q.y / n, q.z / n} : Quatf{};
+}
+
+// 机体系向量旋转到世界系
+inline Vec3f rotate(const Quatf& q, const Vec3f& v) {
+    Vec3f u{q.x, q.y, q.z};
+    Vec3f t = cross(u, v) * 2.0f;
+    return v + t * q.w + cross(u, t);
+}
+
+// 世界系向量旋转到机体系
+inline Vec3f rotateInverse(const Quatf& q, const Vec3f& v) {
+    return rotate(conjugate(q), v);
+}
+
+// 旋转向量（轴角，rad）对应的四元数
+inline Quatf quatFromRotationVector(const Vec3f& r) {
+    float angle = norm(r);
+    if (angle < 1e-6f) {
+        return normalized(Quatf{1.0f, 0.5f * r.x, 0.5f * r.y, 0.5f * r.z});
+    }
+    float s = std::sin(0.5f * angle) / angle;
+    return {std::cos(0.5f * angle), r.x * s, r.y * s, r.z * s};
+}
+
+// 四元数对应的旋转向量（rad）
+inline Vec3f rotationVectorFromQuat(const Quatf& q) {
+    Quatf p = q.w < 0.0f ? Quatf{-q.w, -q.x, -q.y, -q.z} : q;
+    Vec3f v{p.x, p.y, p.z};
+    float s = norm(v);
+    if (s < 1e-6f) {
+        return v * 2.0f;
+    }
+    return v * (2.0f * std::atan2(s, p.w) / s);
+}
+
+#endif // IMU_MATH_H
@@ -8,9 +8,11 @@
 #ifndef IMU_PARSER_H
 #define IMU_PARSER_H
 
+#include "delegate.h"
 #include <cstdint>
 #include <functional>
 #include <cmath>
+#include <atomic>
 
 // 数据类型定义
 typedef int8_t   S8;
@@ -69,37 +71,88 @@ struct IMUData {
     uint16_t subscribe_tag = 0;
 };
 
+// IMUData 的浮点字段数，以及按声明顺序排列的成员指针、名称与所属订阅标签位
+constexpr int IMU_FLOAT_FIELDS = 22;
+
+inline constexpr float IMUData::* IMU_FIELD_MEMBERS[IMU_FLOAT_FIELDS] = {
+    &IMUData::accel_x, &IMUData::accel_y, &IMUData::accel_z,
+    &IMUData::accel_with_gravity_x, &IMUData::accel_with_gravity_y, &IMUData::accel_with_gravity_z,
+    &IMUData::gyro_x, &IMUData::gyro_y, &IMUData::gyro_z,
+    &IMUData::mag_x, &IMUData::mag_y, &IMUData::mag_z,
+    &IMUData::temperature, &IMUData::pressure, &IMUData::height,
+    &IMUData::quat_w, &IMUData::quat_x, &IMUData::quat_y, &IMUData::quat_z,
+    &IMUData::euler_x, &IMUData::euler_y, &IMUData::euler_z,
+};
+
+inline constexpr const char* IMU_FIELD_NAMES[IMU_FLOAT_FIELDS] = {
+    "accel_x", "accel_y", "accel_z",
+    "accel_with_gravity_x", "accel_with_gravity_y", "accel_with_gravity_z",
+    "gyro_x", "gyro_y", "gyro_z",
+    "mag_x", "mag_y", "mag_z",
+    "temperature", "pressure", "height",
+    "quat_w", "quat_x", "quat_y", "quat_z",
+    "euler_x", "euler_y", "euler_z",
+};
+
+inline constexpr uint16_t IMU_FIELD_TAGS[IMU_FLOAT_FIELDS] = {
+    0x0001, 0x0001, 0x0001,
+    0x0002, 0x0002, 0x0002,
+    0x0004, 0x0004, 0x0004,
+    0x0008, 0x0008, 0x0008,
+    0x0010, 0x0010, 0x0010,
+    0x0020, 0x0020, 0x0020, 0x0020,
+    0x0040, 0x0040, 0x0040,
+};
+
 // 数据回调函数类型
 using IMUDataCallback = std::function<void(const IMUData&)>;
 
-// IMU数据包解析器
-class IMUParser {
-public:
-    IMUParser();
-    ~IMUParser() = default;
-
-    // 设置数据回调函数
-    void setDataCallback(IMUDataCallback callback);
+// 解析器数据回调与命令发送函数（无堆分配，见 delegate.h）
+using IMUDataDelegate = Delegate<void(const IMUData&)>;
+using IMUSendDelegate = Delegate<int(const U8*, size_t)>;
+
+// 原始计数样本回调（定义见 imu_raw_sample.h）
+struct IMURawSample;
+using IMURawDataCallback = std::function<void(const IMURawSample&)>;
+
+// 帧视图回调（定义见 imu_frame_view.h），视图只在回调期间有效
+class IMUFrameView;
+using IMUFrameViewCallback = std::function<void(const IMUFrameView&)>;
+
+// 解析器统计快照
+struct IMUParserStats {
+    uint64_t frames = 0;            // 校验通过的完整帧
+    uint64_t sensor_frames = 0;     // 传感器数据帧 (0x11)
+    uint64_t checksum_errors = 0;   // 校验失败
+    uint64_t end_errors = 0;        // 结束字节错误
+    uint64_t addr_mismatches = 0;   // 地址不匹配
+    uint64_t short_frames = 0;      // 数据长度不足
+    uint64_t unknown_commands = 0;  // 未知命令
+};
 
-    // 设置调试模式
-    void setDebugEnabled(bool enabled) { debug_enabled_ = enabled; }
+// 帧接收状态机
+// 逐字节组帧、校验并维护统计计数，IMUParser 与 IMUParserT 共用
+class IMUFrameReceiver {
+public:
+    IMUFrameReceiver();
 
-    // 处理接收到的字节
+    // 处理接收到的字节，收到地址匹配的完整帧时返回 true，数据体见 frameData()/frameLength()
     bool processByte(U8 byte);
 
-    // 打包并发送命令
-    static int packAndSend(U8* pDat, U8 dLen, U8 deviceAddr, std::function<int(const U8*, size_t)> sendFunc);
+    // 最近一个完整帧的数据体（命令字节起）与长度，在下一次 processByte() 之前有效
+    U8* frameData() { return &rx_buffer_[3]; }
+    U8 frameLength() const { return rx_index_ - 5; }
 
-    // 重置解析状态（用于热拔插恢复）
-    void reset();
+    // 按命令字节对完整帧分类计数，是可解析的传感器数据帧 (0x11) 时返回 true
+    bool acceptSensorFrame(const U8* buf, U8 dLen);
 
-private:
-    // 解析数据包
-    void unpackData(U8* buf, U8 dLen);
+    // 重置解析状态（用于热拔插恢复），不清零统计计数
+    void reset();
 
-    // 解析传感器数据 (0x11命令)
-    void parseSensorData(U8* buf, U8 dLen);
+    // 获取统计快照（计数器为原子量，可在任意线程调用）
+    IMUParserStats getStats() const;
 
+private:
     // 状态机状态
     enum RxState {
         RX_STATE_WAIT_BEGIN = 0,  // 等待起始码
@@ -117,8 +170,52 @@ private:
     U8 rx_checksum_;
     U8 target_device_addr_;
 
-    IMUDataCallback data_callback_;
-    bool debug_enabled_;
+    // 统计计数（仅读取线程写入）
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> sensor_frames_;
+    std::atomic<uint64_t> checksum_errors_;
+    std::atomic<uint64_t> end_errors_;
+    std::atomic<uint64_t> addr_mismatches_;
+    std::atomic<uint64_t> short_frames_;
+    std::atomic<uint64_t> unknown_commands_;
+};
+
+// IMU数据包解析器
+class IMUParser {
+public:
+    IMUParser() = default;
+    ~IMUParser() = default;
+
+    // 设置数据回调函数（lambda 只能捕获 this 或少量引用，见 delegate.h）
+    void setDataCallback(IMUDataDelegate callback);
+
+    // 设置原始计数样本回调（在数据回调之前调用；只设置该回调时不做浮点解码）
+    void setRawDataCallback(IMURawDataCallback callback);
+
+    // 设置帧视图回调（在数据回调之前调用，字段在访问时才解码；只设置该回调时不做浮点解码）
+    void setFrameViewCallback(IMUFrameViewCallback callback);
+
+    // 处理接收到的字节
+    bool processByte(U8 byte);
+
+    // 打包并发送命令
+    static int packAndSend(U8* pDat, U8 dLen, U8 deviceAddr, IMUSendDelegate sendFunc);
+
+    // 重置解析状态（用于热拔插恢复），不清零统计计数
+    void reset() { receiver_.reset(); }
+
+    // 获取统计快照（计数器为原子量，可在任意线程调用）
+    IMUParserStats getStats() const { return receiver_.getStats(); }
+
+private:
+    // 解析传感器数据 (0x11命令)
+    void parseSensorData(U8* buf, U8 dLen);
+
+    IMUFrameReceiver receiver_;
+
+    IMUDataDelegate data_callback_;
+    IMURawDataCallback raw_data_callback_;
+    IMUFrameViewCallback frame_view_callback_;
 };
 
 #endif // IMU_PARSER_H
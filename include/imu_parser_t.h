@@ -0,0 +1,74 @@
+/*
+    * @file imu_parser_t.h
+    * @brief 编译期回调解析器头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef IMU_PARSER_T_H
+#define IMU_PARSER_T_H
+
+#include "imu_frame_view.h"
+#include "imu_parser.h"
+#include "imu_raw_sample.h"
+#include <type_traits>
+#include <utility>
+
+// 编译期回调解析器
+// 与 IMUParser 共用帧接收状态机与统计，传感器数据帧直接交给 Sink：回调在编译期确定并可内联，
+// 没有间接调用。Sink 的调用形式决定解码方式（两者都可调用时取帧视图）：
+//   void(const IMUFrameView&)  按需解码，不构造 IMUData
+//   void(const IMUData&)       完整解码，数值与 IMUParser 的数据回调一致
+// 适合输出固定的高频场景；需要运行时设置回调或原始样本回调时使用 IMUParser
+template <typename Sink>
+class IMUParserT {
+public:
+    explicit IMUParserT(Sink sink = Sink()) : sink_(std::move(sink)) {}
+
+    // 处理接收到的字节，收到完整帧时返回 true
+    bool processByte(U8 byte) {
+        if (!receiver_.processByte(byte)) {
+            return false;
+        }
+        U8* buf = receiver_.frameData();
+        U8 dLen = receiver_.frameLength();
+        if (receiver_.acceptSensorFrame(buf, dLen)) {
+            dispatch(buf, dLen);
+        }
+        return true;
+    }
+
+    Sink& sink() { return sink_; }
+    const Sink& sink() const { return sink_; }
+
+    // 重置解析状态（用于热拔插恢复），不清零统计计数
+    void reset() { receiver_.reset(); }
+
+    // 获取统计快照（计数器为原子量，可在任意线程调用）
+    IMUParserStats getStats() const { return receiver_.getStats(); }
+
+private:
+    void dispatch(const U8* buf, U8 dLen) {
+        U16 subscribe_tag = ((U16)buf[2] << 8) | buf[1];
+        U32 timestamp = ((U32)buf[6] << 24) | ((U32)buf[5] << 16) |
+                        ((U32)buf[4] << 8) | buf[3];
+        U16 present = rawPresentGroups(subscribe_tag, dLen - 7);
+
+        if constexpr (std::is_invocable<Sink&, const IMUFrameView&>::value) {
+            sink_(IMUFrameView(buf + 7, present, timestamp));
+        } else {
+            static_assert(std::is_invocable<Sink&, const IMUData&>::value,
+                          "Sink 需可用 const IMUFrameView& 或 const IMUData& 调用");
+            IMUData data;
+            data.subscribe_tag = subscribe_tag;
+            data.timestamp = timestamp;
+            decodeRawPayload(buf + 7, present, data);
+            sink_(data);
+        }
+    }
+
+    IMUFrameReceiver receiver_;
+    Sink sink_;
+};
+
+#endif // IMU_PARSER_T_H
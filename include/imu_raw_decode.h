@@ -0,0 +1,31 @@
+/*
+    * @file imu_raw_decode.h
+    * @brief 数据体字段组布局与原始计数解码头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef IMU_RAW_DECODE_H
+#define IMU_RAW_DECODE_H
+
+#include "imu_parser.h"
+#include <cstdint>
+
+// 各字段组（订阅标签位 0-6）在数据体中的字节数
+inline constexpr uint8_t IMU_RAW_GROUP_BYTES[7] = {6, 6, 6, 6, 8, 8, 6};
+
+// 16 位有符号整数（小端）
+inline int32_t readS16(const U8* p) {
+    return static_cast<S16>((static_cast<U16>(p[1]) << 8) | p[0]);
+}
+
+// 24 位有符号整数（小端），符号扩展到 32 位
+inline int32_t readS24(const U8* p) {
+    U32 value = (static_cast<U32>(p[2]) << 16) | (static_cast<U32>(p[1]) << 8) | p[0];
+    if ((value & 0x800000) == 0x800000) {
+        value |= 0xff000000;
+    }
+    return static_cast<S32>(value);
+}
+
+#endif // IMU_RAW_DECODE_H
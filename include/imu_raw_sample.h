@@ -0,0 +1,82 @@
+/*
+    * @file imu_raw_sample.h
+    * @brief 原始计数紧凑样本头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef IMU_RAW_SAMPLE_H
+#define IMU_RAW_SAMPLE_H
+
+#include "imu_frame_view.h"
+#include "imu_math.h"
+#include "imu_parser.h"
+#include "imu_raw_decode.h"
+#include <cstddef>
+#include <cstdint>
+
+// 全部字段组的数据体字节数（订阅 0x7F）
+constexpr int IMU_RAW_MAX_PAYLOAD = 46;
+
+// 紧凑记录的头部字节数：订阅标签 (LE16) + 时间戳 (LE32)
+constexpr int IMU_RAW_HEADER_BYTES = 6;
+
+// 数据体中完整出现的字段组：与 IMUParser 相同，放不下的字段组跳过，后续字段组从当前位置继续。
+// payload_len 为时间戳之后的字节数，payload_bytes 返回有效字节数（可为 nullptr）
+uint16_t rawPresentGroups(uint16_t subscribe_tag, size_t payload_len, int* payload_bytes = nullptr);
+
+// 按存在掩码把紧凑数据体解码为物理量写入 data（不修改时间戳与订阅标签）
+void decodeRawPayload(const uint8_t* payload, uint16_t present, IMUData& data);
+
+// 原始计数样本
+// 按线路格式原样保存数据体：存在的字段组按订阅标签位顺序紧凑排列（小端 int16，气压与高度为 int24），
+// 不存在的字段组不占位置。subscribe_tag 即存在掩码，只含数据体中完整出现的字段组，
+// 因此不存在的字段不会与 0.0 混淆。缩放后的物理量在访问时计算，与 IMUParser 解码结果逐位一致。
+// 定长 52 字节（IMUData 为 96 字节），适合队列与环形缓冲；记录时用 serialize() 只写
+// 头部与实际数据体（订阅 0x02 时每帧 12 字节）
+struct IMURawSample {
+    uint32_t timestamp = 0;                 // 时间戳 ms
+    uint16_t subscribe_tag = 0;             // 存在掩码（含义同订阅标签）
+    uint8_t payload[IMU_RAW_MAX_PAYLOAD];   // 数据体原始字节，仅前 payloadBytes() 字节有效
+
+    // 由传感器数据帧 (0x11) 的数据体构建，buf[0] 为命令字节；长度不足 7 字节时返回 false
+    bool assign(const U8* buf, size_t len);
+
+    // 拷贝帧视图（在帧视图回调中保留数据）
+    void assign(const IMUFrameView& view);
+
+    // 本样本的视图，字段访问与 IMUFrameView 相同
+    IMUFrameView view() const { return IMUFrameView(payload, subscribe_tag, timestamp); }
+
+    // 是否包含 group 的全部字段组
+    bool has(uint16_t group) const { return (subscribe_tag & group) == group; }
+
+    // 数据体有效字节数
+    int payloadBytes() const { return view().payloadBytes(); }
+
+    // 原始计数：group 为单个字段组位，index 为组内字段序号（温度组：0 温度，1 气压，2 高度）。
+    // 字段组不存在时返回 0
+    int32_t raw(uint16_t group, int index) const { return view().raw(group, index); }
+
+    // 缩放后的物理量（按需计算，字段组不存在时为零值）
+    Vec3f accel() const { return view().accel(); }
+    Vec3f accelWithGravity() const { return view().accelWithGravity(); }
+    Vec3f gyro() const { return view().gyro(); }
+    Vec3f mag() const { return view().mag(); }
+    Vec3f euler() const { return view().euler(); }
+    float temperature() const { return view().temperature(); }
+    float pressure() const { return view().pressure(); }
+    float height() const { return view().height(); }
+    Quatf quat() const { return view().quat(); }
+
+    // 转换为 IMUData（不存在的字段为 0）
+    IMUData toIMUData() const { return view().toIMUData(); }
+
+    // 紧凑记录：头部 + 数据体，返回写入的字节数（out 至少 IMU_RAW_HEADER_BYTES + IMU_RAW_MAX_PAYLOAD 字节）
+    size_t serialize(U8* out) const;
+
+    // 读取一条紧凑记录，返回消耗的字节数，数据不足或标签无效时返回 0
+    size_t deserialize(const U8* in, size_t len);
+};
+
+#endif // IMU_RAW_SAMPLE_H
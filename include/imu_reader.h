@@ -9,13 +9,75 @@
 #define IMU_READER_H
 
 #include "imu_parser.h"
+#include "imu_frame_view.h"
+#include "imu_raw_sample.h"
 #include "config_parser.h"
+#include "config_watcher.h"
+#include "device_config.h"
+#include "sample_loss_detector.h"
+#include "field_derivation.h"
+#include "field_statistics.h"
+#include "ahrs.h"
+#include "gyro_bias_estimator.h"
+#include "mag_calibrator.h"
+#include "orientation_predictor.h"
+#include "resampler.h"
+#include "strapdown.h"
+#include "vibration_monitor.h"
+#include "realtime.h"
+#include "seqlock.h"
 #include <serial/serial.h>
 #include <thread>
 #include <atomic>
 #include <mutex>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <string>
+
+class MetricsServer;
+
+// 带主机时间的数据回调：host_time_us 为该帧在主机单调时钟 (steady_clock) 上的时刻，
+// 由设备时间戳按最小延迟对齐得到（重采样时为输出网格时刻）
+using IMUTimedDataCallback = std::function<void(const IMUData& data, uint64_t host_time_us)>;
+
+// 回调耗时直方图桶数，上界见 CALLBACK_LATENCY_BOUNDS_US，最后一个桶为 +Inf
+constexpr int CALLBACK_LATENCY_BUCKETS = 8;
+constexpr uint32_t CALLBACK_LATENCY_BOUNDS_US[CALLBACK_LATENCY_BUCKETS - 1] = {
+    10, 50, 100, 500, 1000, 5000, 10000
+};
+
+// 数据流重置请求位：由热拔插线程等置位，读取线程在处理下一个字节前执行
+constexpr uint32_t STREAM_RESET_PARSER = 0x1;  // 丢弃解析器中的半帧
+constexpr uint32_t STREAM_RESET_TIMING = 0x2;  // 重新对齐设备时间戳
+
+// 读取器运行指标快照（全部来自原子量，读取时不加锁）
+struct IMUReaderMetrics {
+    std::string port;
+    int baudrate = 0;
+    int report_rate = 0;
+    bool running = false;
+    bool connected = false;
+    int reconnect_attempts = 0;     // 当前连续重连尝试次数
+    uint64_t reconnects = 0;        // 累计重连成功次数
+    uint64_t rx_bytes = 0;          // 累计接收字节数
+    IMUParserStats parser;
+    SampleLossStats loss;
+    uint64_t callback_latency[CALLBACK_LATENCY_BUCKETS] = {};  // 非累积计数
+    uint64_t callback_latency_sum_ns = 0;
+};
+
+// reconfigure() 参数，-1 表示保持当前值
+struct IMUReconfigureParams {
+    int report_rate = -1;       // 上报频率 Hz (0-255, 0 = 0.5Hz)
+    int subscribe_tag = -1;     // 需要的字段，含义同 [IMU] subscribe_tag
+    int compass_on = -1;        // 磁力计融合 (0/1)
+    int barometer_filter = -1;  // 以下滤波参数含义同 [IMU] 同名选项
+    int gyro_filter = -1;
+    int acc_filter = -1;
+    int compass_filter = -1;
+    int timeout_ms = 1000;      // 等待第一帧新格式数据的超时 ms
+};
 
 // IMU读取器（支持热拔插）
 class IMUReader {
@@ -23,9 +85,16 @@ public:
     IMUReader();
     ~IMUReader();
 
-    // 加载配置并初始化
+    // 加载配置并初始化（串口与 IMU 参数取自 [Serial] 与 [IMU]）
     bool initialize(const std::string& config_file);
 
+    // 以已解析的配置与设备参数初始化（IMUReaderSet 为每个设备调用）。
+    // 此时不单独启动指标服务与配置监视，由 IMUReaderSet 统一提供
+    bool initialize(const std::string& config_file, const ConfigParser& config, const IMUDeviceConfig& device);
+
+    // 设备名（单设备配置为空）
+    const std::string& deviceName() const { return device_.name; }
+
     // 启动读取线程
     bool start();
 
@@ -41,12 +110,85 @@ public:
     // 设置数据回调函数
     void setDataCallback(IMUDataCallback callback);
 
+    // 设置带主机时间的数据回调（与数据回调在同一线程、同一时机调用）
+    void setTimedDataCallback(IMUTimedDataCallback callback);
+
+    // 设置丢帧标记回调（在间隔后的第一帧数据回调之前调用）
+    void setGapCallback(IMUGapCallback callback);
+
+    // 设置原始计数样本回调（读取线程中、每帧解析后立即调用，早于丢帧检测与主机端处理，
+    // 值与设备输出逐位一致，适合紧凑记录；需在 start() 之前设置）
+    void setRawDataCallback(IMURawDataCallback callback) { parser_->setRawDataCallback(callback); }
+
+    // 设置帧视图回调（读取线程中、每帧解析后立即调用，视图指向接收缓冲区，只在回调期间有效；
+    // 只读取少数字段时可省去完整解码。调用时机同原始计数样本回调，需在 start() 之前设置）
+    void setFrameViewCallback(IMUFrameViewCallback callback) { parser_->setFrameViewCallback(callback); }
+
+    // 获取丢帧统计（可在任意线程调用）
+    SampleLossStats getSampleLossStats() const { return loss_detector_.getStats(); }
+
+    // 获取调度抖动统计（可在任意线程调用）
+    JitterStats getJitterStats() const { return jitter_monitor_.getStats(); }
+
+    // 获取当前磁力计标定结果，尚未求解时为空（可在任意线程调用）
+    std::shared_ptr<const MagCorrection> getMagCorrection() const { return mag_calibrator_.correction(); }
+
+    // 获取字段滑动窗口统计快照（顺序锁无锁读取，可在任意线程调用）
+    FieldStatsSnapshot getFieldStats() const { return field_stats_.snapshot(); }
+
+    // 外推到主机单调时钟 host_time_us 时刻的姿态，补偿采样到读取之间的延迟
+    // （需启用 [Prediction]，且数据含四元数与角速度；可在任意线程调用）
+    Quatf predictOrientationAt(uint64_t host_time_us) const {
+        return predictor_.predict(static_cast<int64_t>(host_time_us));
+    }
+
+    // 当前主机单调时钟 (steady_clock) 微秒，与 predictOrientationAt() 及重采样输出时间同一时基
+    static uint64_t hostNowUs();
+
+    // 获取捷联积分的导航状态（顺序锁无锁读取，可在任意线程调用）
+    StrapdownState getNavigationState() const { return navigation_.load(); }
+
+    // 请求在下一帧重新对准姿态并把速度、位置清零（可在任意线程调用）
+    void resetNavigation() { strapdown_reset_pending_ = true; }
+
+    // 设置振动频谱发布回调（在后台线程调用，需在 start() 之前设置）
+    void setVibrationCallback(VibrationCallback callback) { vibration_monitor_.setCallback(callback); }
+
+    // 获取最新振动频谱摘要，尚未发布时为空（可在任意线程调用）
+    std::shared_ptr<const VibrationSpectrum> getVibrationSpectrum() const { return vibration_monitor_.spectrum(); }
+
+    // 获取运行指标快照（仅读取原子量，不会阻塞读取线程）
+    IMUReaderMetrics getMetrics() const;
+
     // 发送命令
     bool sendCommand(const U8* cmd, size_t len);
 
     // 配置IMU参数
     bool configureIMU();
 
+    // 切换串口波特率（读取线程运行中）
+    // device_cmd 为设备端切换波特率的命令数据体（随设备型号而定，为空则只切换主机端），
+    // 以当前波特率发出后切换主机端，verify_timeout_ms 内未收到有效帧则恢复原波特率。
+    // 可配合 planBaudrate() 选出满足订阅标签与上报频率的最小波特率。
+    // 新波特率在重连与热重载（配置文件未修改 baudrate 时）中保留，但不写回配置文件：
+    // 进程重启后仍按配置文件中的波特率打开，需要长期使用时同步修改配置
+    bool switchBaudrate(int baudrate, const U8* device_cmd = nullptr, size_t cmd_len = 0,
+                        int verify_timeout_ms = 1000);
+
+    // 运行中修改上报频率与订阅标签，无需 stop()/start()
+    // 发送 0x12 参数命令后继续按旧格式处理数据，读取线程在第一帧新格式数据到达时
+    // （订阅标签变化时按帧内标签，仅频率变化时按帧间隔识别）一次性切换字段推导、丢帧检测周期、
+    // 重采样、零偏窗口等主机端状态，本函数在切换完成后返回；超时则恢复原参数并返回 false。
+    // 随频率变化的重采样系数与统计窗口在调用线程预先分配，读取线程切换时只交换，不分配内存也不启停线程。
+    // 只修改滤波参数时数据格式不变，命令发出即返回
+    bool reconfigure(const IMUReconfigureParams& params);
+
+    // 重新读取配置文件，与当前配置比较后只应用变化的项：
+    // 上报频率、订阅标签与滤波参数经 reconfigure() 在线修改；串口、波特率、超时与设备地址
+    // 交给热拔插线程关闭串口并按新参数快速重连；日志等级立即生效；其余项需重启生效。
+    // 启用 [HotReload] 时由监视线程在文件保存后调用，也可手动调用（需在 start() 之后）
+    bool reloadConfig();
+
     // 唤醒传感器
     bool wakeupSensor();
 
@@ -54,6 +196,9 @@ public:
     bool enableAutoReport();
 
 private:
+    // 按设备参数与 config_ 中的其他节初始化
+    bool applyConfig(const IMUDeviceConfig& device);
+
     // 读取线程函数
     void readThread();
 
@@ -72,37 +217,187 @@ private:
     // 发送数据包
     int sendPacket(const U8* data, size_t len);
 
+    // 构建并发送 0x12 参数命令（不等待设备生效）
+    bool sendParameters(int report_rate, uint16_t device_tag);
+
+    // 由需要的字段规划设备订阅与主机推导（考虑 host_derive 与主机姿态融合）
+    DerivationPlan planSubscription(uint16_t subscribe_tag) const;
+
+    // 按 report_rate_ 与 derivation_ 更新主机端的轻量状态（初始化后或读取线程切换格式时调用，不分配内存）
+    void applyStreamFormat();
+
+    // 生成按输入采样率配置好的重采样器（初始化时，或在 reconfigure() 调用线程为新频率预先生成）
+    std::unique_ptr<Resampler> makeResampler(double input_rate);
+
+    // 读取线程：当前帧已是重配置后的格式时切换主机端状态
+    void applyPendingFormat(const IMUData& data);
+
+    // 热拔插线程：按 pending_serial_ 关闭串口并以新参数重连
+    void reopenSerial();
+
+    // 获取当前串口句柄（无锁，持有期间端口对象不会被释放）
+    std::shared_ptr<serial::Serial> acquirePort() const { return std::atomic_load(&serial_); }
+
+    // 若 port 仍是当前句柄则将其摘除并标记断开；端口在最后一个持有者释放时关闭
+    void detachPort(const std::shared_ptr<serial::Serial>& port);
+
+    // 解析器数据回调：丢帧检测后转发给用户回调
+    void onParsedData(const IMUData& data);
+
+    // 调用用户回调并统计耗时
+    void deliverData(const IMUData& data, uint64_t host_time_us);
+
+    // 由设备时间戳计算积分步长 s（期望周期的整数倍）
+    double integrationStep(bool& has_last, uint32_t& last_timestamp, uint32_t timestamp) const;
+
+    // 主机端姿态融合，结果写入 data 的四元数字段
+    void updateAHRS(IMUData& data);
+
+    // 捷联积分并发布导航状态
+    void updateStrapdown(const IMUData& data);
+
+    // 输出调度抖动报告
+    void logJitterReport() const;
+
     ConfigParser config_;
-    std::unique_ptr<serial::Serial> serial_;
+    std::string config_file_;
+    IMUDeviceConfig device_;      // 最近一次从配置文件应用的设备参数（热重载据此比较）
+    bool managed_;                // 由 IMUReaderSet 管理：指标服务、配置监视与变化日志由集合统一提供
+    // 串口句柄：读/写路径通过 std::atomic_load 取得副本后直接访问，
+    // serial::Serial 内部的读锁与写锁保证读与写互不阻塞
+    std::shared_ptr<serial::Serial> serial_;
+    std::atomic<uint32_t> port_generation_;  // 句柄每次替换时递增，读取线程据此刷新缓存的句柄
+    std::atomic<uint32_t> stream_reset_;     // 待执行的数据流重置（STREAM_RESET_*），只由读取线程清除并执行
     std::unique_ptr<IMUParser> parser_;
+    SampleLossDetector loss_detector_;
+    JitterMonitor jitter_monitor_;
+    IMUDataCallback data_callback_;
+    IMUTimedDataCallback timed_data_callback_;
+    IMUGapCallback gap_callback_;
 
     std::thread read_thread_;
     std::thread hotplug_thread_;
     std::atomic<bool> running_;
     std::atomic<bool> connected_;
-    std::mutex serial_mutex_;
+    std::mutex lifecycle_mutex_;  // 仅串行化打开/关闭串口，读写路径不使用
+
+    // 运行指标
+    std::atomic<uint64_t> rx_bytes_;
+    std::atomic<uint64_t> reconnects_;
+    std::atomic<uint64_t> callback_latency_[CALLBACK_LATENCY_BUCKETS];
+    std::atomic<uint64_t> callback_latency_sum_ns_;
+    std::unique_ptr<MetricsServer> metrics_server_;
 
     // 配置参数
-    std::string port_;
-    int baudrate_;
+    std::string port_;           // 热重载时由热拔插线程修改，其他线程读取需持有 port_mutex_
+    mutable std::mutex port_mutex_;
+    std::atomic<int> baudrate_;  // 可由 switchBaudrate() 在运行中修改
     int timeout_;
-    U8 device_address_;
-    int report_rate_;
+    std::atomic<U8> device_address_;
+    std::atomic<int> report_rate_;  // 可由 reconfigure() 在运行中修改（读取线程切换）
     uint16_t subscribe_tag_;
+    bool host_derive_;            // 由主机推导可计算字段，设备只订阅最小集合
+    DerivationPlan derivation_;   // host_derive_ 开启时的订阅规划
     bool compass_on_;
     int barometer_filter_;
     int gyro_filter_;
     int acc_filter_;
     int compass_filter_;
 
+    // 运行中重配置：reconfigure() 发出命令后把新格式交给读取线程，切换后通知等待方
+    struct PendingFormat {
+        int report_rate = 0;
+        uint16_t subscribe_tag = 0;
+        DerivationPlan derivation;
+        bool match_tag = false;         // 按帧内订阅标签识别新格式
+        bool match_period = false;      // 按帧间隔识别新的上报频率
+        bool has_last = false;
+        uint32_t last_timestamp = 0;
+        // 上报频率变化时由 reconfigure() 调用线程按新频率预先分配，读取线程切换时只交换；
+        // 切换后这里是换下的旧对象，由调用线程释放
+        std::unique_ptr<Resampler> resampler;
+        std::unique_ptr<FieldStatistics> field_stats;
+    };
+    std::mutex reconfigure_mutex_;      // 串行化 reconfigure() 与重连时的参数下发
+    std::mutex format_mutex_;           // 保护 pending_format_ 与 format_switched_
+    std::condition_variable format_cv_;
+    PendingFormat pending_format_;
+    std::atomic<bool> format_pending_;
+    bool format_switched_;
+
     // 热拔插参数
     int check_interval_;
     int reconnect_interval_;
     int max_reconnect_;
-    int reconnect_count_;
+    std::atomic<int> reconnect_count_;
+
+    // 配置热重载：串口参数变化时由 reloadConfig() 登记，热拔插线程关闭串口后按新参数重连
+    struct SerialSettings {
+        std::string port;
+        int baudrate = 0;
+        int timeout = 0;
+        U8 device_address = 0;
+    };
+    bool hot_reload_enabled_;
+    int hot_reload_debounce_ms_;
+    ConfigWatcher config_watcher_;
+    std::mutex reload_mutex_;           // 串行化 reloadConfig()
+    std::mutex hotplug_mutex_;          // 保护 pending_serial_ 与 reopen_requested_
+    std::condition_variable hotplug_cv_;  // 唤醒热拔插线程（重开请求或停止）
+    SerialSettings pending_serial_;
+    bool reopen_requested_;
+
+    // 指标服务参数
+    bool metrics_enabled_;
+    std::string metrics_bind_;
+    int metrics_port_;
+    std::string metrics_name_;
+
+    // 陀螺零偏在线估计（仅读取线程访问）
+    GyroBiasConfig gyro_bias_config_;
+    GyroBiasEstimator gyro_bias_;
+
+    // 磁力计在线标定（累加在读取线程，求解在后台线程）
+    MagCalibrationConfig mag_cal_config_;
+    MagCalibrator mag_calibrator_;
+
+    // 主机端姿态融合（仅读取线程访问）
+    AHRSConfig ahrs_config_;
+    std::unique_ptr<AHRSFilter> ahrs_;
+    bool ahrs_has_last_;
+    uint32_t ahrs_last_timestamp_;
+
+    // 姿态外推（读取线程更新，任意线程外推）
+    PredictionConfig prediction_config_;
+    OrientationPredictor predictor_;
+    int prediction_latency_us_;
+
+    // 捷联积分（仅读取线程访问，导航状态经顺序锁发布）
+    StrapdownConfig strapdown_config_;
+    StrapdownIntegrator strapdown_;
+    bool strapdown_has_last_;
+    uint32_t strapdown_last_timestamp_;
+    std::atomic<bool> strapdown_reset_pending_;
+    SeqLock<StrapdownState> navigation_;
+
+    // 重采样到固定输出频率（仅读取线程访问，重配置时整体替换）
+    ResamplerConfig resample_config_;
+    std::unique_ptr<Resampler> resampler_;
+
+    // 字段滑动窗口统计（仅读取线程更新）
+    FieldStatisticsConfig stats_config_;
+    FieldStatistics field_stats_;
+
+    // 振动频谱监测（环形缓冲在读取线程，FFT 在后台线程）
+    VibrationConfig vibration_config_;
+    VibrationMonitor vibration_monitor_;
+
+    // 实时调度参数
+    RealTimeConfig realtime_;
 
     // 调试参数
     bool debug_enabled_;
+    std::string trace_file_;
 };
 
 #endif // IMU_READER_H
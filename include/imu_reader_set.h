@@ -0,0 +1,63 @@
+/*
+    * @file imu_reader_set.h
+    * @brief 多设备读取器集合头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef IMU_READER_SET_H
+#define IMU_READER_SET_H
+
+#include "config_parser.h"
+#include "config_watcher.h"
+#include "device_config.h"
+#include "imu_reader.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class MetricsServer;
+
+// 多设备读取器集合
+// 由同一配置文件的 [IMU.<name>] 节构造 N 个读取器：配置只解析一次，全部设备校验通过后才创建读取器，
+// 其余节（[HotPlug]、[AHRS] 等）对所有设备相同。各读取器独立读取与重连；指标服务与配置监视
+// 由集合统一提供（指标以设备名为 imu 标签，配置变化时依次调用各读取器的 reloadConfig()）
+class IMUReaderSet {
+public:
+    IMUReaderSet();
+    ~IMUReaderSet();
+
+    // 加载并校验配置，为每个设备初始化读取器；校验失败时一次输出全部错误并返回 false
+    bool initialize(const std::string& config_file);
+
+    // 启动全部读取器，任一设备启动失败时返回 false（其余设备保持运行，可用 isRunning() 检查）
+    bool start();
+
+    // 停止全部读取器
+    void stop();
+
+    size_t size() const { return readers_.size(); }
+
+    IMUReader& reader(size_t index) { return *readers_[index]; }
+    const IMUDeviceConfig& device(size_t index) const { return devices_[index]; }
+
+    // 按设备名查找读取器，不存在时返回 nullptr
+    IMUReader* find(const std::string& name);
+
+    // 最近一次 initialize() 的校验错误
+    const std::vector<std::string>& errors() const { return errors_; }
+
+private:
+    // 配置文件变化：输出变化的键并交给各读取器应用
+    void reloadConfig();
+
+    std::string config_file_;
+    ConfigParser config_;
+    std::vector<IMUDeviceConfig> devices_;
+    std::vector<std::unique_ptr<IMUReader>> readers_;
+    std::vector<std::string> errors_;
+    std::unique_ptr<MetricsServer> metrics_server_;
+    ConfigWatcher config_watcher_;
+};
+
+#endif // IMU_READER_SET_H
@@ -0,0 +1,154 @@
+/*
+    * @file latency_estimator.h
+    * @brief 多 IMU 间相对延迟的互相关估计头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef LATENCY_ESTIMATOR_H
+#define LATENCY_ESTIMATOR_H
+
+#include "fft.h"
+#include "imu_parser.h"
+#include "seqlock.h"
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 设备数上限
+constexpr int LATENCY_MAX_DEVICES = 8;
+
+// 每个设备读取线程到后台线程的样本队列长度（2 的幂）
+constexpr int LATENCY_RING = 1024;
+
+// 相对延迟估计配置
+struct LatencyEstimatorConfig {
+    double sample_rate = 200.0;     // 互相关网格采样率 Hz
+    int window = 1024;              // 互相关窗口点数（2 的幂，≥ 64）
+    int max_lag_ms = 100;           // 搜索的最大相对延迟 ms
+    int interval_ms = 1000;         // 估计周期 ms
+    int reference = 0;              // 参考设备
+    float min_correlation = 0.7f;   // 归一化相关峰下限
+    float min_motion_dps = 5.0f;    // 窗口内角速度模的标准差下限（静止时无法估计）
+    float smoothing = 0.3f;         // 估计值指数平滑系数 (0, 1]
+};
+
+// 单个设备相对参考设备的延迟估计
+struct LatencyEstimate {
+    bool valid = false;             // 是否已有可信估计
+    double delay_us = 0.0;          // 平滑后的相对延迟：正值表示该设备主机时间晚于参考设备
+    double last_delay_us = 0.0;     // 最近一次测量值
+    float correlation = 0.0f;       // 最近一次测量的归一化相关峰
+    uint64_t estimates = 0;         // 采纳的测量次数
+    uint64_t rejected = 0;          // 因运动不足或相关性低而放弃的次数
+    uint64_t dropped = 0;           // 队列已满而丢弃的样本数
+};
+
+// 延迟修正回调（在后台线程调用）：offset_us 应加到该设备的主机时间上
+using LatencyOffsetCallback = std::function<void(int device, int64_t offset_us)>;
+
+// 相对延迟估计
+// 各读取线程只把 (主机时间, 角速度模) 写入该设备的单生产者队列，队满丢弃，从不等待。
+// 后台线程周期取出样本，线性插值到主机时钟上 1/sample_rate 的公共网格（每设备保留 2·window 点），
+// 每个估计周期对各设备与参考设备最近的公共窗口去均值、补零后做 FFT 互相关
+// r(τ) = Σ x[n]·y[n+τ] = IFFT(conj(X)·Y)，按重叠段归一化为相关系数后在 ±max_lag 内取峰值，
+// 三点抛物线插值得到亚采样延迟。
+// 角速度模与安装方向无关，适用于刚性安装的 IMU 阵列；内存占用固定
+class LatencyEstimator {
+public:
+    LatencyEstimator();
+    ~LatencyEstimator();
+
+    // 分配缓冲并启动后台线程（在读取线程运行前调用）
+    bool start(const LatencyEstimatorConfig& config, int device_count);
+
+    // 停止后台线程
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+    // 在 start() 之前设置
+    void setOffsetCallback(LatencyOffsetCallback callback) { offset_callback_ = callback; }
+
+    // 输入一帧（由该设备的读取线程调用，需订阅角速度 0x04）
+    void push(int device, const IMUData& data, uint64_t host_time_us);
+
+    // 获取设备的延迟估计（可在任意线程调用）
+    LatencyEstimate estimate(int device) const;
+
+private:
+    struct Sample {
+        int64_t time_us;
+        float value;
+    };
+
+    // 读取线程到后台线程的单生产者单消费者队列
+    struct Queue {
+        Sample ring[LATENCY_RING];
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> tail{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    // 前缀和：sum = Σx，square = Σx²
+    struct Prefix {
+        double sum = 0.0;
+        double square = 0.0;
+    };
+
+    // 后台线程私有：网格化后的序列，网格点 k 对应主机时间 k·period_us_
+    struct Series {
+        bool has_last = false;
+        int64_t last_time_us = 0;
+        float last_value = 0.0f;
+        std::vector<float> grid;    // 下标 k % (2·window)
+        int64_t newest = 0;         // 最新网格点 k
+        int64_t count = 0;          // 截至 newest 的连续网格点数
+    };
+
+    void workerThread();
+
+    // 取出设备队列中的样本并插值到网格
+    void drain(int device);
+
+    // 估计设备相对参考设备的延迟，成功返回 true
+    bool measure(int device, double& delay_us, float& correlation);
+
+    LatencyEstimatorConfig config_;
+    int device_count_;
+    double period_us_;
+    int max_lag_;
+    int64_t max_gap_us_;
+
+    Queue queues_[LATENCY_MAX_DEVICES];
+
+    // 后台线程私有
+    Series series_[LATENCY_MAX_DEVICES];
+    std::unique_ptr<RealFFT> fft_;
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> r_;
+    std::vector<std::complex<float>> spectrum_x_;
+    std::vector<std::complex<float>> spectrum_y_;
+    std::vector<Prefix> prefix_x_;
+    std::vector<Prefix> prefix_y_;
+    std::vector<double> rho_;       // 各延迟的相关系数，下标 τ + max_lag_
+    LatencyEstimate state_[LATENCY_MAX_DEVICES];
+    int64_t applied_offset_us_[LATENCY_MAX_DEVICES];
+
+    SeqLock<LatencyEstimate> estimates_[LATENCY_MAX_DEVICES];
+    LatencyOffsetCallback offset_callback_;
+
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    std::thread worker_thread_;
+    std::atomic<bool> running_;
+};
+
+#endif // LATENCY_ESTIMATOR_H
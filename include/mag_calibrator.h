@@ -0,0 +1,100 @@
+/*
+    * @file mag_calibrator.h
+    * @brief 磁力计硬铁/软铁在线标定（增量椭球拟合）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef MAG_CALIBRATOR_H
+#define MAG_CALIBRATOR_H
+
+#include "imu_parser.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// 椭球一般式 a x² + b y² + c z² + 2f yz + 2g xz + 2h xy + 2p x + 2q y + 2r z = 1 的参数个数
+constexpr int MAG_FIT_PARAMS = 9;
+
+// [MagCalibration] 配置
+struct MagCalibrationConfig {
+    bool enabled = false;
+    int min_samples = 300;          // 参与拟合的最少样本数
+    int solve_interval_ms = 2000;   // 求解间隔（设备时间）
+    float min_spacing = 2.0f;       // 与上一个入选样本的最小距离 uT，避免静止时样本集中
+    float max_axis_ratio = 3.0f;    // 椭球长短轴比上限，超过视为拟合无效
+};
+
+// 标定结果：corrected = soft_iron * (raw - offset)
+struct MagCorrection {
+    float offset[3] = {0.0f, 0.0f, 0.0f};                   // 硬铁偏移 uT
+    float soft_iron[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; // 软铁矩阵（对称）
+    float field_strength = 0.0f;    // 校正后的磁场模长 uT
+    float rms_residual = 0.0f;      // 拟合残差（归一化）
+    uint64_t samples = 0;           // 参与拟合的样本数
+};
+
+// 磁力计在线标定器
+// 读取线程每样本只向 9x9 正规方程累加量中加入一项 (O(1))，
+// 到达求解间隔时用 try_lock 把累加量交给后台线程，锁被占用则推迟到下一样本，读取线程从不等待；
+// 后台线程解方程并以 shared_ptr 原子替换标定结果，读取线程原子读取后直接应用
+class MagCalibrator {
+public:
+    MagCalibrator();
+    ~MagCalibrator();
+
+    // 启动后台求解线程
+    void start(const MagCalibrationConfig& config);
+
+    // 停止后台求解线程
+    void stop();
+
+    // 输入原始样本（读取线程调用，需订阅磁力计 0x08）
+    void addSample(const IMUData& data);
+
+    // 对 data 的磁力计字段应用当前标定结果（尚无结果时不修改）
+    void apply(IMUData& data) const;
+
+    // 当前标定结果，可能为空（可在任意线程调用）
+    std::shared_ptr<const MagCorrection> correction() const { return std::atomic_load(&correction_); }
+
+    // 清空累加量与标定结果（读取线程调用，或在读取线程运行前调用）
+    void reset();
+
+    // 由正规方程求解标定结果，失败返回 false
+    static bool solve(const double normal[MAG_FIT_PARAMS][MAG_FIT_PARAMS], const double rhs[MAG_FIT_PARAMS],
+                      double count, float max_axis_ratio, MagCorrection& out);
+
+private:
+    // 正规方程累加量
+    struct NormalEquations {
+        double normal[MAG_FIT_PARAMS][MAG_FIT_PARAMS];
+        double rhs[MAG_FIT_PARAMS];
+        double count;
+    };
+
+    void solveThread();
+
+    MagCalibrationConfig config_;
+
+    // 读取线程私有
+    NormalEquations sums_;
+    float last_sample_[3];
+    bool has_last_sample_;
+    bool has_last_publish_;
+    uint32_t last_publish_ms_;
+
+    // 读取线程与求解线程交接
+    std::mutex handoff_mutex_;
+    std::condition_variable handoff_cv_;
+    NormalEquations handoff_;
+    bool handoff_ready_;
+
+    std::shared_ptr<const MagCorrection> correction_;
+    std::thread solve_thread_;
+    std::atomic<bool> running_;
+};
+
+#endif // MAG_CALIBRATOR_H
@@ -0,0 +1,52 @@
+/*
+    * @file metrics_server.h
+    * @brief Prometheus 文本格式指标服务头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "imu_reader.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// 轻量 HTTP 指标服务（GET /metrics）
+// 独立线程处理请求，抓取时只读取各读取器的原子量，不会阻塞读取线程
+class MetricsServer {
+public:
+    MetricsServer();
+    ~MetricsServer();
+
+    // 注册读取器，name 作为 imu 标签（需在 start() 之前调用）
+    void addReader(const std::string& name, const IMUReader* reader);
+
+    // 在 bind_address:port 上监听
+    bool start(const std::string& bind_address, int port);
+
+    // 停止服务
+    void stop();
+
+    // 是否正在运行
+    bool isRunning() const { return running_; }
+
+    // 生成全部读取器的文本格式指标
+    std::string render() const;
+
+private:
+    // 服务线程函数
+    void serveThread();
+
+    // 处理一个客户端连接
+    void handleClient(int client_fd);
+
+    std::vector<std::pair<std::string, const IMUReader*>> readers_;
+    std::thread serve_thread_;
+    std::atomic<bool> running_;
+    int listen_fd_;
+};
+
+#endif // METRICS_SERVER_H
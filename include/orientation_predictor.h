@@ -0,0 +1,78 @@
+/*
+    * @file orientation_predictor.h
+    * @brief 基于陀螺外推的姿态延迟补偿头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef ORIENTATION_PREDICTOR_H
+#define ORIENTATION_PREDICTOR_H
+
+#include "imu_math.h"
+#include "imu_parser.h"
+#include "seqlock.h"
+#include <cstdint>
+#include <string>
+
+// 外推方式
+enum class PredictionMode {
+    CONSTANT_RATE,  // 角速度保持不变
+    SECOND_ORDER    // 角速度按估计的角加速度线性变化
+};
+
+// 解析外推方式名 (constant/second_order)，无法识别时返回 fallback
+PredictionMode parsePredictionMode(const std::string& name, PredictionMode fallback = PredictionMode::CONSTANT_RATE);
+
+// [Prediction] 配置
+struct PredictionConfig {
+    bool enabled = false;
+    PredictionMode mode = PredictionMode::CONSTANT_RATE;
+    int max_horizon_ms = 100;       // 外推时长上限（前后双向），超过时按上限外推
+    int latency_offset_us = -1;     // 采样时刻早于"最小延迟到达时刻"的时长（-1 = 按帧长与波特率估算）
+    float alpha_smoothing = 0.3f;   // 角加速度一阶低通系数 (0, 1]
+};
+
+// 最近一帧的姿态与角速度（以主机单调时钟定位）
+struct OrientationSample {
+    Quatf orientation;              // 机体到世界
+    Vec3f gyro;                     // rad/s（机体系）
+    Vec3f angular_accel;            // rad/s²（机体系，低通后）
+    int64_t host_time_us = 0;       // 采样时刻（steady_clock 微秒）
+    bool valid = false;
+};
+
+// 姿态外推器
+// 读取线程每帧以最新四元数与角速度更新，并经顺序锁发布；predict() 可在任意线程无锁调用。
+// 外推旋转矢量：θ = ω·t（恒定角速度），或 θ = ω·t + α·t²/2 + (ω × α)·t³/12（角速度线性变化，
+// 含区间内的圆锥项），结果 q(t) = q ⊗ exp(θ)
+class OrientationPredictor {
+public:
+    OrientationPredictor();
+
+    void configure(const PredictionConfig& config);
+
+    // 输入一帧（读取线程调用，需含四元数 0x20 与角速度 0x04），host_time_us 为采样时刻
+    void update(const IMUData& data, int64_t host_time_us);
+
+    // 清空历史（重连或时间戳重置后调用）
+    void reset();
+
+    // 外推到 host_time_us 时刻的姿态；尚无数据时返回单位四元数（可在任意线程调用）
+    Quatf predict(int64_t host_time_us) const;
+
+    // 最近一帧（可在任意线程调用）
+    OrientationSample latest() const { return latest_.load(); }
+
+    // 按给定样本与方式外推 dt 秒
+    static Quatf extrapolate(const OrientationSample& sample, float dt, PredictionMode mode);
+
+private:
+    PredictionConfig config_;
+    bool has_last_;
+    Vec3f last_gyro_;
+    int64_t last_host_us_;
+    Vec3f angular_accel_;
+    SeqLock<OrientationSample> latest_;
+};
+
+#endif // ORIENTATION_PREDICTOR_H
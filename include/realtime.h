@@ -0,0 +1,91 @@
+/*
+    * @file realtime.h
+    * @brief 读取线程实时调度与调度抖动统计头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 单个线程的实时参数
+struct RealTimeThreadConfig {
+    int cpu = -1;           // 绑定的 CPU 编号 (-1 = 不绑定)
+    int priority = 0;       // SCHED_FIFO 优先级 (1-99, 0 = 保持 SCHED_OTHER)
+};
+
+// [RealTime] 配置
+struct RealTimeConfig {
+    RealTimeThreadConfig read_thread;
+    RealTimeThreadConfig hotplug_thread;
+    bool lock_memory = false;       // mlockall(MCL_CURRENT | MCL_FUTURE)
+    int prefault_stack_kb = 0;      // 线程启动时预先触碰的栈大小 KB (0 = 不预取)
+    bool jitter_report = false;     // 周期输出调度抖动报告
+};
+
+// 在当前线程上应用 CPU 绑定、调度策略与栈预取，失败时输出警告并继续
+void applyThreadRealTime(const RealTimeThreadConfig& config, int prefault_stack_kb, const char* thread_name);
+
+// 锁定进程内存，避免缺页导致的延迟
+bool lockProcessMemory();
+
+// 调度抖动直方图桶数，上界见 JITTER_BOUNDS_US，最后一个桶为溢出。
+// 抖动由 1ms 精度的设备时间戳得到，桶宽不小于 1ms；第一个桶 (<=1ms) 为量化噪声，不代表实际延迟
+constexpr int JITTER_BUCKETS = 8;
+constexpr uint32_t JITTER_BOUNDS_US[JITTER_BUCKETS - 1] = {1000, 2000, 3000, 5000, 10000, 20000, 50000};
+
+// 调度抖动快照
+struct JitterStats {
+    uint64_t samples = 0;
+    double mean_us = 0.0;
+    uint32_t max_us = 0;
+    uint64_t histogram[JITTER_BUCKETS] = {};
+};
+
+// 调度抖动统计
+// 以 (主机到达时间 - 设备时间戳) 的滑动最小值为基线，超出基线的部分即为
+// 串口传输之外的额外延迟（读取线程被抢占、唤醒延迟等）。
+// 基线每个窗口重新取最小值，以跟随主机与设备时钟的漂移。
+// update() 仅由读取线程调用；计数器为原子量，可在任意线程读取
+class JitterMonitor {
+public:
+    JitterMonitor();
+
+    // 记录一帧：host_us 为主机单调时钟微秒，device_ms 为设备时间戳
+    void update(uint64_t host_us, uint32_t device_ms);
+
+    // 按当前基线把设备时间戳换算为主机单调时钟微秒（最小延迟对齐，需先 update()）
+    int64_t hostTimeUs(uint32_t device_ms) const {
+        return device_base_us_ + static_cast<int64_t>(static_cast<int32_t>(device_ms - last_device_ms_)) * 1000 +
+               baseline_us_;
+    }
+
+    // 重置基线（重连后调用），保留累计计数
+    void resync() { has_baseline_ = false; }
+
+    // 清零所有计数
+    void clearStats();
+
+    // 获取统计快照
+    JitterStats getStats() const;
+
+private:
+    bool has_baseline_;
+    uint64_t window_start_us_;
+    int64_t baseline_us_;        // 上一窗口与当前窗口最小偏移中的较小者
+    int64_t prev_window_min_us_;
+    int64_t window_min_us_;
+    int64_t device_base_us_;     // 设备时间戳展开（处理 32 位回绕）
+    uint32_t last_device_ms_;
+
+    std::atomic<uint64_t> samples_;
+    std::atomic<uint64_t> sum_us_;
+    std::atomic<uint32_t> max_us_;
+    std::atomic<uint64_t> histogram_[JITTER_BUCKETS];
+};
+
+#endif // REALTIME_H
@@ -0,0 +1,89 @@
+/*
+    * @file resampler.h
+    * @brief 多相 FIR 重采样到固定主机输出频率头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include "imu_parser.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 参与重采样的 IMUData 浮点字段数
+constexpr int RESAMPLE_CHANNELS = IMU_FLOAT_FIELDS;
+
+// 输入历史环形缓冲长度（2 的幂，需大于最大抽头数）
+constexpr int RESAMPLE_RING = 128;
+constexpr int RESAMPLE_MAX_TAPS = 64;
+
+// [Resample] 配置
+struct ResamplerConfig {
+    bool enabled = false;
+    double output_rate = 200.0;     // 输出频率 Hz
+    int taps = 16;                  // 上采样时每相抽头数，降采样时按频率比增加（不超过 RESAMPLE_MAX_TAPS）
+    int phases = 64;                // 相位数（分数延迟分辨率 1/phases 个输入周期）
+    int max_fill = 8;               // 丢帧不超过该帧数时线性插值补齐，否则重新开始
+    int clock_time_constant_ms = 1000;  // 输入时间基准的平滑时间常数 ms
+};
+
+// 重采样输出回调：host_time_us 为输出网格上的主机单调时钟时刻
+using ResampledCallback = std::function<void(const IMUData& data, uint64_t host_time_us)>;
+
+// 多相重采样器
+// 输入样本按设备时钟等间隔排列，并以平滑后的时间基准定位：主机同步时间戳只有 1ms 精度且随
+// 基线更新跳变，由二阶锁相环（alpha-beta 跟踪）估计最新样本时刻与输入周期；输出时刻为主机时钟上
+// 以 1/output_rate 为间隔的精确网格。每个输出时刻由所在分数位置的两相系数线性插值后
+// 与输入历史做点积得到，系数表在 configure() 中一次生成，按相位连续存放。
+// 欧拉角在滤波前展开、输出时折回 (-180, 180]；四元数与上一帧同号后滤波并归一化。
+// 输出相对输入有约 taps/2 个输入周期的群延迟。仅由读取线程调用
+class Resampler {
+public:
+    Resampler();
+
+    // 生成系数表并清空状态
+    void configure(const ResamplerConfig& config, double input_rate);
+
+    void setCallback(ResampledCallback callback) { callback_ = callback; }
+
+    // 输入一帧，host_time_us 为该帧的主机同步时间（未平滑）；可能触发零到多次回调
+    void push(const IMUData& data, int64_t host_time_us);
+
+    // 清空历史（设备时间戳重置或重连后调用）
+    void reset();
+
+    int taps() const { return taps_; }
+
+private:
+    void append(const float* sample);
+    void emit(double position, int64_t host_time_us);
+
+    // 以观测时刻 raw_us 更新时间基准，steps 为相对上一样本的输入周期数（0 表示重新开始）
+    void updateClock(int64_t raw_us, long steps);
+
+    ResamplerConfig config_;
+    double input_period_us_;
+    double output_period_us_;
+    int taps_;
+    int phases_;
+    std::vector<float> coeffs_;     // (phases_ + 1) x taps_，每相归一化到直流增益 1
+
+    // 输入历史：每个通道写入两次（i 与 i + RESAMPLE_RING），任意窗口都是连续内存
+    float history_[RESAMPLE_CHANNELS][2 * RESAMPLE_RING];
+    uint64_t count_;                // 已写入的输入样本数
+    float last_sample_[RESAMPLE_CHANNELS];
+    IMUData last_data_;
+    double clock_us_;               // 平滑后的最新输入样本主机时间
+    double clock_period_us_;        // 估计的输入周期（主机时钟）
+    double clock_gain_;             // 时刻校正增益 alpha
+    double clock_rate_gain_;        // 周期校正增益 beta
+    int64_t next_output_index_;     // 下一个输出时刻在主机时钟网格上的序号（时刻 = 序号 * 输出周期）
+    bool has_output_grid_;
+
+    ResampledCallback callback_;
+};
+
+#endif // RESAMPLER_H
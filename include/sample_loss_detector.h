@@ -0,0 +1,91 @@
+/*
+    * @file sample_loss_detector.h
+    * @brief 基于设备时间戳的丢帧检测器头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef SAMPLE_LOSS_DETECTOR_H
+#define SAMPLE_LOSS_DETECTOR_H
+
+#include "imu_parser.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// 间隔事件类型
+enum class IMUGapType : uint8_t {
+    GAP = 0,        // 丢帧（时间戳跳变超过期望周期）
+    DUPLICATE,      // 重复帧（时间戳未前进）
+    REORDER,        // 乱序帧（时间戳回退）
+    RESET           // 设备时间戳大幅回退（设备重启/重连）
+};
+
+// 间隔事件（丢帧标记），在下一帧数据回调之前发布
+struct IMUGapEvent {
+    IMUGapType type = IMUGapType::GAP;
+    uint32_t prev_timestamp = 0;    // 上一帧设备时间戳 ms
+    uint32_t timestamp = 0;         // 当前帧设备时间戳 ms
+    uint32_t lost_samples = 0;      // 估计丢失的帧数（仅 GAP 有效）
+};
+
+// 间隔事件回调函数类型
+using IMUGapCallback = std::function<void(const IMUGapEvent&)>;
+
+// 丢帧直方图桶数: 1, 2, 3-4, 5-8, 9-16, 17-32, 33-64, 65+
+constexpr int GAP_HISTOGRAM_BUCKETS = 8;
+
+// 丢帧统计快照
+struct SampleLossStats {
+    uint64_t samples = 0;           // 收到的帧数
+    uint64_t lost_samples = 0;      // 估计丢失的帧数
+    uint64_t gaps = 0;              // 丢帧事件次数
+    uint64_t duplicates = 0;        // 重复帧次数
+    uint64_t reorders = 0;          // 乱序帧次数
+    uint64_t resets = 0;            // 时间戳重置次数
+    uint64_t gap_histogram[GAP_HISTOGRAM_BUCKETS] = {};
+};
+
+// 丢帧检测器
+// update() 仅由读取线程调用；计数器为原子量，可在任意线程读取
+class SampleLossDetector {
+public:
+    SampleLossDetector();
+    ~SampleLossDetector() = default;
+
+    // 根据上报频率设置期望帧间隔 (0 = 0.5Hz)
+    void setReportRate(int report_rate);
+
+    // 期望帧间隔 ms
+    double expectedPeriodMs() const { return period_ms_; }
+
+    // 处理一帧，若检测到异常则填充 event 并返回 true
+    bool update(uint32_t timestamp, IMUGapEvent& event);
+
+    // 重置时间戳跟踪（重连后调用），保留累计计数
+    void resync() { has_last_ = false; }
+
+    // 清零所有计数
+    void clearStats();
+
+    // 获取统计快照
+    SampleLossStats getStats() const;
+
+    // 丢失帧数对应的直方图桶
+    static int histogramBucket(uint32_t lost_samples);
+
+private:
+    double period_ms_;
+    bool has_last_;
+    uint32_t last_timestamp_;
+
+    std::atomic<uint64_t> samples_;
+    std::atomic<uint64_t> lost_samples_;
+    std::atomic<uint64_t> gaps_;
+    std::atomic<uint64_t> duplicates_;
+    std::atomic<uint64_t> reorders_;
+    std::atomic<uint64_t> resets_;
+    std::atomic<uint64_t> gap_histogram_[GAP_HISTOGRAM_BUCKETS];
+};
+
+#endif // SAMPLE_LOSS_DETECTOR_H
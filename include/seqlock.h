@@ -0,0 +1,74 @@
+/*
+    * @file seqlock.h
+    * @brief 单写者顺序锁（无锁快照发布）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 单写者、多读者的顺序锁
+// 写者把序号置为奇数、写入数据、再置为偶数；读者复制数据前后序号一致且为偶数即为完整快照，
+// 否则重试。写者从不等待，读者不修改任何共享状态。
+// 数据按 64 位原子字存放，读写均为 relaxed 原子操作，不存在数据竞争
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock 只能存放可平凡复制的类型");
+
+public:
+    SeqLock()
+        : sequence_(0) {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // 发布新值（仅由单一写者线程调用）
+    void store(const T& value) {
+        uint64_t buffer[WORDS] = {};
+        memcpy(buffer, &value, sizeof(T));
+
+        uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // 读取最近一次发布的完整值（可在任意线程调用）
+    T load() const {
+        uint64_t buffer[WORDS];
+        uint32_t begin, end;
+        do {
+            begin = sequence_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            end = sequence_.load(std::memory_order_relaxed);
+        } while ((begin & 1) != 0 || begin != end);
+
+        T value;
+        memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // 已发布次数
+    uint32_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> words_[WORDS];
+    std::atomic<uint32_t> sequence_;
+};
+
+#endif // SEQLOCK_H
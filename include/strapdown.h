@@ -0,0 +1,100 @@
+/*
+    * @file strapdown.h
+    * @brief 捷联惯导积分（圆锥/划桨补偿、零速修正）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef STRAPDOWN_H
+#define STRAPDOWN_H
+
+#include "imu_math.h"
+#include "imu_parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// [Strapdown] 配置
+struct StrapdownConfig {
+    bool enabled = false;
+    float gravity = 9.8f;           // 当地重力 m/s²（与设备一致）
+    bool zupt = true;               // 启用内置静止检测的零速修正
+    float zupt_accel_tol = 0.3f;    // |比力模长 - gravity| 阈值 m/s²
+    float zupt_gyro_tol = 3.0f;     // 角速度模长阈值 dps
+    int zupt_samples = 20;          // 连续满足阈值的样本数
+};
+
+// 一个积分步的输入
+struct StrapdownSample {
+    Vec3f gyro;                     // 角速度 rad/s（机体系）
+    Vec3f accel;                    // 比力（含重力的加速度）m/s²（机体系）
+    float dt = 0.0f;                // 步长 s
+};
+
+// 导航状态：世界系 z 轴向上，attitude 为机体到世界的旋转
+struct StrapdownState {
+    Quatf attitude;
+    double velocity[3] = {0.0, 0.0, 0.0};   // m/s
+    double position[3] = {0.0, 0.0, 0.0};   // m，相对初始位置
+    double time = 0.0;                      // 自初始化起的积分时间 s
+    uint64_t samples = 0;                   // 已积分的样本数
+    uint64_t zupts = 0;                     // 已执行的零速修正次数
+    bool stationary = false;                // 最近一步是否判定为静止
+};
+
+// 由处理后的 IMUData 构造积分输入（需订阅角速度 0x04 与含重力加速度 0x02）
+StrapdownSample strapdownSampleFromIMU(const IMUData& data, float dt);
+
+// 零速检测钩子：返回 true 时在该步后把速度置零（替换内置检测）
+using ZeroVelocityDetector = std::function<bool(const StrapdownSample& sample, const StrapdownState& state)>;
+
+// 捷联积分器
+// 输入为等间隔采样的角速度与比力，相邻两个采样梯形积分得到区间内的角增量 Δθ 与速度增量 Δv；
+// 姿态以圆锥补偿后的旋转矢量 φ = Δθ + T²/12 · ω_a × ω_b 更新，
+// 速度增量加入旋转补偿 Δθ × Δv / 2 与划桨补偿 T²/12 · (ω_a × f_b + f_a × ω_b)，
+// 在上一步姿态下转到世界系后加上重力，位置按梯形积分。
+// 忽略地球自转与重力随位置的变化，适用于 GNSS 间隔内的短时推算。
+// 每样本 O(1)、不分配内存；非线程安全
+class StrapdownIntegrator {
+public:
+    StrapdownIntegrator();
+
+    void configure(const StrapdownConfig& config);
+
+    // 以给定姿态开始积分，速度与位置清零
+    void reset(const Quatf& attitude);
+
+    // 以给定姿态、速度与位置开始积分（如 GNSS 定位后）
+    void reset(const Quatf& attitude, const double velocity[3], const double position[3]);
+
+    // 是否已设置初始姿态
+    bool initialized() const { return initialized_; }
+
+    // 设置零速检测钩子，为空时使用内置的阈值检测（config.zupt 为 false 时均不修正）
+    void setZeroVelocityDetector(ZeroVelocityDetector detector) { detector_ = detector; }
+
+    // 外部零速修正（如足部触地检测），立即把速度置零
+    void applyZeroVelocity();
+
+    // 积分一步（需先 reset()）
+    void update(const StrapdownSample& sample);
+
+    // 批量积分，用于回放记录；trajectory 非空时写出每步后的状态（count 个）
+    void updateBatch(const StrapdownSample* samples, size_t count, StrapdownState* trajectory = nullptr);
+
+    const StrapdownState& state() const { return state_; }
+
+private:
+    bool detectStationary(const StrapdownSample& sample);
+
+    StrapdownConfig config_;
+    StrapdownState state_;
+    bool initialized_;
+    bool has_previous_;
+    Vec3f last_gyro_;               // 区间起点的采样
+    Vec3f last_accel_;
+    int still_count_;
+    ZeroVelocityDetector detector_;
+};
+
+#endif // STRAPDOWN_H
@@ -0,0 +1,41 @@
+/*
+    * @file throughput_planner.h
+    * @brief 串口吞吐量规划（订阅标签 / 上报频率 / 波特率）头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef THROUGHPUT_PLANNER_H
+#define THROUGHPUT_PLANNER_H
+
+#include <cstdint>
+#include <vector>
+
+// 规划结果
+struct ThroughputPlan {
+    int baudrate = 0;           // 波特率 bps
+    int frame_bytes = 0;        // 单帧线路字节数
+    double max_rate_hz = 0.0;   // 该波特率下的理论最大上报频率
+    double load = 0.0;          // 链路占用率 (report_rate / max_rate_hz)
+    double headroom = 0.0;      // 余量 (1 - load)
+    bool feasible = false;      // 余量是否满足要求
+};
+
+// 传感器数据体字节数：命令(1) + 订阅标签(2) + 时间戳(4) + 各订阅字段
+int sensorPayloadBytes(uint16_t subscribe_tag);
+
+// 单帧线路字节数 = 前导码(50) + 包头(3) + 数据体 + 校验(1) + 包尾(1)
+int sensorFrameBytes(uint16_t subscribe_tag);
+
+// 常用波特率（均可由 SerialImpl 直接或通过 termios2/BOTHER 设置）
+const std::vector<int>& standardBaudrates();
+
+// 评估给定波特率下的吞吐余量（8N1，每字节 10 bit）
+ThroughputPlan evaluateThroughput(uint16_t subscribe_tag, int report_rate, int baudrate,
+                                  double min_headroom = 0.1);
+
+// 选出满足 min_headroom 的最小波特率；都不满足时返回最大候选且 feasible=false
+ThroughputPlan planBaudrate(uint16_t subscribe_tag, int report_rate, double min_headroom = 0.1,
+                            const std::vector<int>& candidates = standardBaudrates());
+
+#endif // THROUGHPUT_PLANNER_H
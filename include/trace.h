@@ -0,0 +1,76 @@
+/*
+    * @file trace.h
+    * @brief Chrome trace 格式的流水线耗时跟踪头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// 跟踪点通过 CMake 选项 IMU_ENABLE_TRACE 开启；关闭时下列宏展开为空，不产生任何代码
+//   IMU_TRACE_SCOPE("name")   作用域耗时（Chrome trace "X" 事件）
+//   IMU_TRACE_INSTANT("name") 瞬时事件（Chrome trace "i" 事件）
+// name 必须为字符串字面量（只保存指针）
+
+constexpr size_t TRACE_BUFFER_EVENTS = 65536;  // 每线程保留的最近事件数（2的幂）
+
+// 跟踪事件
+struct TraceEvent {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t duration_ns;  // 0 表示瞬时事件
+};
+
+// 跟踪器：每个线程一个环形缓冲，写满后覆盖最旧事件
+class Tracer {
+public:
+    // 是否编译了跟踪支持
+    static bool compiledIn();
+
+    // 以 Chrome trace JSON 格式写出所有线程的事件（chrome://tracing 或 ui.perfetto.dev 打开）
+    // 写出期间各线程可继续记录；未编译跟踪支持时返回 false
+    static bool dump(const std::string& filename);
+
+    // 清空已记录的事件
+    static void clear();
+
+    // 当前单调时钟 ns
+    static uint64_t nowNs();
+
+    // 记录一个事件（由宏调用）
+    static void record(const char* name, uint64_t begin_ns, uint64_t duration_ns);
+};
+
+#ifdef IMU_ENABLE_TRACE
+
+// 作用域跟踪对象
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name_(name), begin_ns_(Tracer::nowNs()) {}
+    ~TraceScope() { Tracer::record(name_, begin_ns_, Tracer::nowNs() - begin_ns_); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t begin_ns_;
+};
+
+#define IMU_TRACE_CONCAT_INNER(a, b) a##b
+#define IMU_TRACE_CONCAT(a, b) IMU_TRACE_CONCAT_INNER(a, b)
+#define IMU_TRACE_SCOPE(name) TraceScope IMU_TRACE_CONCAT(imu_trace_scope_, __LINE__)(name)
+#define IMU_TRACE_INSTANT(name) Tracer::record(name, Tracer::nowNs(), 0)
+
+#else
+
+#define IMU_TRACE_SCOPE(name) ((void)0)
+#define IMU_TRACE_INSTANT(name) ((void)0)
+
+#endif // IMU_ENABLE_TRACE
+
+#endif // TRACE_H
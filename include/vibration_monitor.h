@@ -0,0 +1,146 @@
+/*
+    * @file vibration_monitor.h
+    * @brief 加速度振动频谱（滑动 FFT）监测头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef VIBRATION_MONITOR_H
+#define VIBRATION_MONITOR_H
+
+#include "fft.h"
+#include "imu_parser.h"
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 分析的轴数（accel_x/y/z）
+constexpr int VIBRATION_AXES = 3;
+
+// FFT 长度上限
+constexpr int VIBRATION_MAX_FFT = 8192;
+
+// 频带 [low_hz, high_hz)
+struct VibrationBandRange {
+    float low_hz = 0.0f;
+    float high_hz = 0.0f;
+};
+
+// [Vibration] 配置
+struct VibrationConfig {
+    bool enabled = false;
+    int fft_size = 256;             // 每帧样本数（2 的幂）
+    float overlap = 0.5f;           // 相邻帧重叠比例 [0, 0.9]
+    int publish_interval_ms = 1000; // 发布间隔（设备时间），期间各帧功率谱取平均
+    int peaks = 3;                  // 每轴输出的峰值个数
+    std::vector<VibrationBandRange> bands;  // 统计能量的频带
+};
+
+// 解析 "0-10,10-50,50-100" 形式的频带列表，格式错误的项输出警告后忽略
+std::vector<VibrationBandRange> parseVibrationBands(const std::string& text);
+
+// 频谱峰值
+struct VibrationPeak {
+    float frequency_hz = 0.0f;      // 对数抛物线插值后的频率
+    float amplitude = 0.0f;         // 正弦幅值估计 m/s²
+};
+
+// 一个发布周期的频谱摘要
+struct VibrationSpectrum {
+    uint32_t timestamp = 0;         // 最后一帧的设备时间戳
+    float sample_rate = 0.0f;       // 采样率 Hz
+    int fft_size = 0;
+    float resolution_hz = 0.0f;     // 频率分辨率 sample_rate / fft_size
+    uint32_t frames = 0;            // 本周期平均的帧数
+    uint64_t dropped_frames = 0;    // 累计因后台线程忙而跳过的帧数
+    float fft_us = 0.0f;            // 本周期每帧平均处理耗时（去均值、加窗、FFT、累加）
+    std::vector<VibrationBandRange> bands;
+    float rms[VIBRATION_AXES] = {};                     // 去均值后的总 RMS m/s²
+    std::vector<float> band_rms[VIBRATION_AXES];        // 各频带 RMS m/s²
+    std::vector<VibrationPeak> peaks[VIBRATION_AXES];   // 按幅值降序
+};
+
+// 频谱发布回调（在后台线程调用）
+using VibrationCallback = std::function<void(const VibrationSpectrum& spectrum)>;
+
+// 振动频谱监测
+// 读取线程把加速度写入预分配的环形缓冲（每个样本写两次，任意一帧都是连续内存），
+// 每前进 hop 个样本用 try_lock 把最新一帧复制给后台线程，锁被占用则跳过该帧，读取线程从不等待；
+// 后台线程去均值、加 Hann 窗后做实数 FFT，按发布间隔平均功率谱并计算频带能量与峰值，
+// 以 shared_ptr 原子替换最新结果并调用回调
+class VibrationMonitor {
+public:
+    VibrationMonitor();
+    ~VibrationMonitor();
+
+    // 分配缓冲并启动后台线程（在读取线程运行前调用），sample_rate 为输入采样率
+    bool start(const VibrationConfig& config, double sample_rate);
+
+    // 停止后台线程
+    void stop();
+
+    // 在 start() 之前设置
+    void setCallback(VibrationCallback callback) { callback_ = callback; }
+
+    // 输入一帧（读取线程调用，优先使用含重力加速度 0x02，其次 0x01）
+    void addSample(const IMUData& data);
+
+    // 丢弃缓冲中的样本，重新积累一整帧（丢帧、时间戳重置或重连后由读取线程调用）；
+    // 其后的第一帧在后台线程开始新的发布周期，设备时间戳重新计数时周期不会停在旧时刻
+    void restart();
+
+    // 上报频率变化后由读取线程调用：FFT 长度与缓冲不变，只重新积累整帧；
+    // 新采样率随下一帧交给后台线程，后台线程丢弃旧频率下的平均后按新频率发布
+    void setSampleRate(double sample_rate);
+
+    // 最新频谱摘要，可能为空（可在任意线程调用）
+    std::shared_ptr<const VibrationSpectrum> spectrum() const { return std::atomic_load(&spectrum_); }
+
+private:
+    void workerThread();
+    void publish(uint32_t timestamp, uint32_t frames, uint64_t elapsed_ns, double sample_rate);
+
+    VibrationConfig config_;
+    double sample_rate_;            // 读取线程当前的输入采样率
+    int fft_size_;
+    int hop_;
+
+    // 读取线程私有：每轴 2 * fft_size_，样本 i 写在 i 与 i + fft_size_
+    std::vector<float> ring_[VIBRATION_AXES];
+    uint64_t count_;
+    int since_frame_;
+    uint32_t generation_;           // restart() 次数，随帧交接
+
+    // 读取线程与后台线程交接
+    std::mutex handoff_mutex_;
+    std::condition_variable handoff_cv_;
+    std::vector<float> handoff_[VIBRATION_AXES];
+    uint32_t handoff_timestamp_;
+    double handoff_sample_rate_;
+    uint32_t handoff_generation_;
+    bool handoff_ready_;
+    std::atomic<uint64_t> dropped_frames_;
+
+    // 后台线程私有
+    std::unique_ptr<RealFFT> fft_;
+    std::vector<float> window_;
+    double window_power_;           // Σw²
+    double window_sum_;             // Σw
+    std::vector<float> frame_;
+    std::vector<std::complex<float>> bins_;
+    std::vector<double> power_[VIBRATION_AXES];     // 本周期 |X[k]|² 累加
+    double mean_square_[VIBRATION_AXES];            // 本周期去均值后的均方累加
+
+    VibrationCallback callback_;
+    std::shared_ptr<const VibrationSpectrum> spectrum_;
+    std::thread worker_thread_;
+    std::atomic<bool> running_;
+};
+
+#endif // VIBRATION_MONITOR_H
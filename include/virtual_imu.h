@@ -0,0 +1,152 @@
+/*
+    * @file virtual_imu.h
+    * @brief 多 IMU 阵列融合为单个虚拟 IMU 头文件
+    *
+    * Author : Jetson LV <ljhao1994@163.com>
+    * Created: 2026-10-17
+*/
+#ifndef VIRTUAL_IMU_H
+#define VIRTUAL_IMU_H
+
+#include "ahrs.h"
+#include "imu_math.h"
+#include "imu_parser.h"
+#include "imu_reader.h"
+#include "latency_estimator.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// 设备数上限
+constexpr int VIRTUAL_IMU_MAX_DEVICES = 8;
+
+// 每个设备的对齐缓冲长度（2 的幂）
+constexpr int VIRTUAL_IMU_RING = 64;
+
+// 虚拟 IMU 配置
+struct VirtualIMUConfig {
+    double output_rate = 200.0;     // 输出频率 Hz（主机时钟网格）
+    int max_wait_ms = 20;           // 某设备迟迟没有新样本时，超过该时长后不再等待它
+    float outlier_mad = 4.0f;       // 离群阈值：偏离中位数超过 outlier_mad 倍鲁棒标准差 (1.4826·MAD)
+    float accel_floor = 0.3f;       // 离群阈值下限 m/s²
+    float gyro_floor = 1.0f;        // 离群阈值下限 dps
+    float mag_floor = 3.0f;         // 离群阈值下限 uT
+    float quat_floor = 0.03f;       // 离群阈值下限（四元数分量距离，约 3.4°）
+    AHRSConfig ahrs;                // 各设备姿态由主机融合（madgwick / mahony），none 时使用设备四元数
+};
+
+// 单个设备的统计（可在任意线程读取）
+struct VirtualIMUDeviceStats {
+    uint64_t samples = 0;           // 收到的样本数
+    uint64_t overflows = 0;         // 对齐缓冲已满而丢弃的样本数
+    uint64_t contributions = 0;     // 参与输出的次数
+    uint64_t rejections = 0;        // 被判为离群的次数（任一字段组）
+    uint64_t stale = 0;             // 超时未到、未参与输出的次数
+};
+
+// 虚拟 IMU
+// 各读取器通过 attach() 以带主机时间的回调推入样本（写入该设备的单生产者环形缓冲，不加锁）；
+// 之后用 try_lock 获取合成锁，按主机时钟上 1/output_rate 的网格逐个合成输出，锁被占用时
+// 由持有者在释放后重新检查，读取线程从不等待。每个网格时刻：
+//   1. 各设备取前后两个样本线性插值（四元数同号后插值），再乘以外参旋转到虚拟机体系；
+//   2. 加速度、角速度、磁场、四元数各字段组以分量中位数为参考，偏离超过阈值的设备不参与该组；
+//   3. 按设备权重加权平均（[字段][设备] 结构数组，内层对设备的循环可向量化），四元数归一化，
+//      有四元数时欧拉角由合成四元数推导。
+// 配置 ahrs 时，第 1 步之后各设备（订阅了含重力加速度与角速度）的姿态由 AHRSBatch 按设备并行更新，
+// 每个网格时刻一次、步长为输出周期，输入已旋转到虚拟机体系，结果直接作为该设备的四元数参与合成；
+// 该时刻未参与的设备不更新。
+// 各设备的主机时间修正可手动设置，也可由 startLatencyEstimation() 按角速度互相关自动估计。
+// 输出与 IMUReader 的数据回调约定相同；回调在某个读取线程中调用，但不会并发
+class VirtualIMU {
+public:
+    explicit VirtualIMU(const VirtualIMUConfig& config = VirtualIMUConfig());
+
+    // 添加设备（在推入样本前调用）：extrinsic 把设备机体系向量旋转到虚拟机体系，返回设备序号，超出上限返回 -1
+    int addDevice(const Quatf& extrinsic = Quatf{}, float weight = 1.0f);
+
+    // 把读取器的带主机时间回调接到指定设备（在读取器 start() 之前调用）
+    void attach(IMUReader& reader, int device);
+
+    // 推入一帧（由该设备的读取线程调用）
+    void push(int device, const IMUData& data, uint64_t host_time_us);
+
+    // 设备时间修正：推入时加到主机时间上（可在任意线程调用）
+    void setTimeOffset(int device, int64_t offset_us);
+    int64_t timeOffset(int device) const;
+
+    // 启动相对延迟自动估计（addDevice() 之后、读取器 start() 之前调用），
+    // 估计结果自动写入 setTimeOffset()，参考设备的修正保持为 0
+    bool startLatencyEstimation(const LatencyEstimatorConfig& config = LatencyEstimatorConfig());
+    void stopLatencyEstimation() { latency_estimator_.stop(); }
+
+    // 获取设备相对参考设备的延迟估计（可在任意线程调用）
+    LatencyEstimate latencyEstimate(int device) const { return latency_estimator_.estimate(device); }
+
+    void setDataCallback(IMUDataCallback callback) { data_callback_ = callback; }
+    void setTimedDataCallback(IMUTimedDataCallback callback) { timed_data_callback_ = callback; }
+
+    int deviceCount() const { return device_count_; }
+
+    // 获取设备统计
+    VirtualIMUDeviceStats deviceStats(int device) const;
+
+    // 已输出的帧数
+    uint64_t outputs() const { return outputs_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        IMUData data;
+        int64_t time_us;
+    };
+
+    // 单生产者（读取线程）单消费者（持有合成锁的线程）环形缓冲
+    struct Device {
+        Quatf extrinsic;
+        float weight = 1.0f;
+        Slot ring[VIRTUAL_IMU_RING];
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> tail{0};
+        std::atomic<int64_t> offset_us{0};
+        std::atomic<int64_t> newest_us{0};
+        std::atomic<uint64_t> samples{0};
+        std::atomic<uint64_t> overflows{0};
+        std::atomic<uint64_t> contributions{0};
+        std::atomic<uint64_t> rejections{0};
+        std::atomic<uint64_t> stale{0};
+    };
+
+    // 合成所有已就绪的网格时刻（持有 combine_mutex_）
+    void combineReady();
+
+    // 合成 tick_us 时刻并输出，返回是否有设备参与
+    bool emit(int64_t tick_us, const bool* usable);
+
+    // 释放不再需要的旧样本：只保留时刻不晚于 tick_us 的最后一个及其之后的样本
+    void release(Device& device, int64_t tick_us);
+
+    // 取设备在 tick_us 时刻的插值样本，失败返回 false
+    bool sampleAt(Device& device, int64_t tick_us, float* values, uint16_t& tag);
+
+    // 以 [字段][设备] 数组中各参与设备的样本批量更新主机姿态，写回四元数并在 tags 中置位
+    void fuseOrientation(float (*x)[VIRTUAL_IMU_MAX_DEVICES], const int* members, int n, uint16_t* tags);
+
+    VirtualIMUConfig config_;
+    int64_t period_us_;
+    Device devices_[VIRTUAL_IMU_MAX_DEVICES];
+    int device_count_;
+
+    std::mutex combine_mutex_;
+    std::atomic<uint32_t> pending_;
+    bool has_tick_;
+    int64_t next_tick_us_;
+    std::atomic<uint64_t> outputs_;
+    AHRSBatch ahrs_;  // 仅持有合成锁的线程访问
+
+    IMUDataCallback data_callback_;
+    IMUTimedDataCallback timed_data_callback_;
+
+    // 最先析构，其后台线程停止后才释放设备状态
+    LatencyEstimator latency_estimator_;
+};
+
+#endif // VIRTUAL_IMU_H
@@ -0,0 +1,567 @@
+/**
+ * @file ahrs.cpp
+ * @brief 主机端姿态融合实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   Madgwick / Mahony 按原论文的展开式实现；EKF 在姿态误差上使用局部扰动
+ *   q_true = q ⊗ Exp(δθ)，加速度观测的雅可比为 [h]×，h 为预测的机体系重力方向。
+ *   所有状态与矩阵均为定长数组，update() 不分配内存。
+ *   AHRSBatch 的九轴 Madgwick 使用一般形式的梯度（不化简单位四元数约束），
+ *   磁场为零时磁场残差项为零、梯度退化为六轴形式，因此无需按通道分支。
+ */
+#include "ahrs.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr float GRAVITY = 9.80665f;
+
+inline float invSqrt(float x) {
+    return x > 0.0f ? 1.0f / std::sqrt(x) : 0.0f;
+}
+
+// 多通道版本：加上最小正规格化数代替条件判断（条件块中的除法会阻止循环向量化），
+// 对正常幅值的平方和没有影响；x=0 时结果有限，与之相乘的分量均为 0，归一化结果仍为零向量
+inline float laneInvSqrt(float x) {
+    return 1.0f / std::sqrt(x + std::numeric_limits<float>::min());
+}
+
+} // namespace
+
+Quatf alignToGravity(const Vec3f& accel, const Vec3f* mag) {
+    Vec3f a = normalized(accel);
+    float roll = std::atan2(a.y, a.z);
+    float pitch = std::atan2(-a.x, std::sqrt(a.y * a.y + a.z * a.z));
+    float yaw = 0.0f;
+    if (mag != nullptr) {
+        float cr = std::cos(roll), sr = std::sin(roll);
+        float cp = std::cos(pitch), sp = std::sin(pitch);
+        float mx = mag->x * cp + mag->y * sr * sp + mag->z * cr * sp;
+        float my = mag->y * cr - mag->z * sr;
+        yaw = std::atan2(-my, mx);
+    }
+    float cr = std::cos(0.5f * roll), sr = std::sin(0.5f * roll);
+    float cp = std::cos(0.5f * pitch), sp = std::sin(0.5f * pitch);
+    float cy = std::cos(0.5f * yaw), sy = std::sin(0.5f * yaw);
+    return {cr * cp * cy + sr * sp * sy,
+            sr * cp * cy - cr * sp * sy,
+            cr * sp * cy + sr * cp * sy,
+            cr * cp * sy - sr * sp * cy};
+}
+
+AHRSAlgorithm parseAHRSAlgorithm(const std::string& name, AHRSAlgorithm fallback) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "none") return AHRSAlgorithm::NONE;
+    if (lower == "madgwick") return AHRSAlgorithm::MADGWICK;
+    if (lower == "mahony") return AHRSAlgorithm::MAHONY;
+    if (lower == "ekf") return AHRSAlgorithm::EKF;
+    return fallback;
+}
+
+// ---------------------------------------------------------------------------
+// Madgwick
+
+MadgwickFilter::MadgwickFilter(float beta)
+    : beta_(beta) {
+}
+
+void MadgwickFilter::update(const Vec3f& gyro, const Vec3f& accel, const Vec3f* mag, float dt) {
+    float q0 = q_.w, q1 = q_.x, q2 = q_.y, q3 = q_.z;
+    float gx = gyro.x, gy = gyro.y, gz = gyro.z;
+
+    // 陀螺积分项
+    float qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    float recipNorm = invSqrt(accel.x * accel.x + accel.y * accel.y + accel.z * accel.z);
+    if (recipNorm > 0.0f) {
+        float ax = accel.x * recipNorm, ay = accel.y * recipNorm, az = accel.z * recipNorm;
+        float s0, s1, s2, s3;
+
+        float mnorm = mag ? invSqrt(mag->x * mag->x + mag->y * mag->y + mag->z * mag->z) : 0.0f;
+        if (mnorm > 0.0f) {
+            float mx = mag->x * mnorm, my = mag->y * mnorm, mz = mag->z * mnorm;
+
+            float _2q0mx = 2.0f * q0 * mx, _2q0my = 2.0f * q0 * my, _2q0mz = 2.0f * q0 * mz;
+            float _2q1mx = 2.0f * q1 * mx;
+            float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+            float _2q0q2 = 2.0f * q0 * q2, _2q2q3 = 2.0f * q2 * q3;
+            float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+            float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+            float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+            // 地磁参考方向
+            float hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 + _2q1 * mz * q3
+                       - mx * q2q2 - mx * q3q3;
+            float hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 + my * q2q2
+                       + _2q2 * mz * q3 - my * q3q3;
+            float _2bx = std::sqrt(hx * hx + hy * hy);
+            float _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 + _2q2 * my * q3
+                         - mz * q2q2 + mz * q3q3;
+            float _4bx = 2.0f * _2bx, _4bz = 2.0f * _2bz;
+
+            // 目标函数梯度
+            float fax = 2.0f * q1q3 - _2q0q2 - ax;
+            float fay = 2.0f * q0q1 + _2q2q3 - ay;
+            float faz = 1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az;
+            float fmx = _2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx;
+            float fmy = _2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my;
+            float fmz = _2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz;
+
+            s0 = -_2q2 * fax + _2q1 * fay - _2bz * q2 * fmx + (-_2bx * q3 + _2bz * q1) * fmy + _2bx * q2 * fmz;
+            s1 = _2q3 * fax + _2q0 * fay - 4.0f * q1 * faz + _2bz * q3 * fmx + (_2bx * q2 + _2bz * q0) * fmy
+                 + (_2bx * q3 - _4bz * q1) * fmz;
+            s2 = -_2q0 * fax + _2q3 * fay - 4.0f * q2 * faz + (-_4bx * q2 - _2bz * q0) * fmx
+                 + (_2bx * q1 + _2bz * q3) * fmy + (_2bx * q0 - _4bz * q2) * fmz;
+            s3 = _2q1 * fax + _2q2 * fay + (-_4bx * q3 + _2bz * q1) * fmx + (-_2bx * q0 + _2bz * q2) * fmy
+                 + _2bx * q1 * fmz;
+        } else {
+            float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+            float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+            float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+            float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+            s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+            s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+            s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+            s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        }
+
+        recipNorm = invSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        qDot1 -= beta_ * s0 * recipNorm;
+        qDot2 -= beta_ * s1 * recipNorm;
+        qDot3 -= beta_ * s2 * recipNorm;
+        qDot4 -= beta_ * s3 * recipNorm;
+    }
+
+    q_ = normalized(Quatf{q0 + qDot1 * dt, q1 + qDot2 * dt, q2 + qDot3 * dt, q3 + qDot4 * dt});
+}
+
+// ---------------------------------------------------------------------------
+// Mahony
+
+MahonyFilter::MahonyFilter(float kp, float ki)
+    : kp_(kp)
+    , ki_(ki) {
+}
+
+void MahonyFilter::reset() {
+    q_ = Quatf{};
+    integral_ = Vec3f{};
+}
+
+void MahonyFilter::update(const Vec3f& gyro, const Vec3f& accel, const Vec3f* mag, float dt) {
+    float q0 = q_.w, q1 = q_.x, q2 = q_.y, q3 = q_.z;
+    Vec3f g = gyro;
+
+    float recipNorm = invSqrt(accel.x * accel.x + accel.y * accel.y + accel.z * accel.z);
+    if (recipNorm > 0.0f) {
+        float ax = accel.x * recipNorm, ay = accel.y * recipNorm, az = accel.z * recipNorm;
+        float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+        float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+        float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+        // 估计的重力方向与观测的叉积即为误差
+        float halfvx = q1q3 - q0q2;
+        float halfvy = q0q1 + q2q3;
+        float halfvz = q0q0 - 0.5f + q3q3;
+        float halfex = ay * halfvz - az * halfvy;
+        float halfey = az * halfvx - ax * halfvz;
+        float halfez = ax * halfvy - ay * halfvx;
+
+        float mnorm = mag ? invSqrt(mag->x * mag->x + mag->y * mag->y + mag->z * mag->z) : 0.0f;
+        if (mnorm > 0.0f) {
+            float mx = mag->x * mnorm, my = mag->y * mnorm, mz = mag->z * mnorm;
+            float hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+            float hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+            float bx = std::sqrt(hx * hx + hy * hy);
+            float bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+            float halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+            float halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+            float halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+            halfex += my * halfwz - mz * halfwy;
+            halfey += mz * halfwx - mx * halfwz;
+            halfez += mx * halfwy - my * halfwx;
+        }
+
+        if (ki_ > 0.0f) {
+            integral_ = integral_ + Vec3f{halfex, halfey, halfez} * (2.0f * ki_ * dt);
+            g = g + integral_;
+        }
+        g = g + Vec3f{halfex, halfey, halfez} * (2.0f * kp_);
+    }
+
+    g = g * (0.5f * dt);
+    q_ = normalized(Quatf{q0 - q1 * g.x - q2 * g.y - q3 * g.z,
+                          q1 + q0 * g.x + q2 * g.z - q3 * g.y,
+                          q2 + q0 * g.y - q1 * g.z + q3 * g.x,
+                          q3 + q0 * g.z + q1 * g.y - q2 * g.x});
+}
+
+// ---------------------------------------------------------------------------
+// 误差状态 EKF
+
+ErrorStateEKF::ErrorStateEKF(const AHRSConfig& config)
+    : config_(config) {
+    reset();
+}
+
+void ErrorStateEKF::reset() {
+    q_ = Quatf{};
+    bias_ = Vec3f{};
+    memset(P_, 0, sizeof(P_));
+    // 姿态初值由首帧加速度对准，仍保留较大的航向不确定度
+    for (int i = 0; i < 3; i++) {
+        P_[i][i] = 0.1f;
+        P_[i + 3][i + 3] = 1e-4f;
+    }
+    initialized_ = false;
+}
+
+void ErrorStateEKF::update(const Vec3f& gyro, const Vec3f& accel, const Vec3f* mag, float dt) {
+    if (!initialized_) {
+        if (norm(accel) > 0.0f) {
+            q_ = alignToGravity(accel, mag);
+            initialized_ = true;
+        }
+        return;
+    }
+
+    // 预测：名义状态积分
+    Vec3f w = gyro - bias_;
+    q_ = normalized(q_ * quatFromRotationVector(w * dt));
+
+    // 误差状态转移 F = [[I - [w]x dt, -I dt], [0, I]]
+    float F[6][6] = {};
+    for (int i = 0; i < 6; i++) {
+        F[i][i] = 1.0f;
+    }
+    F[0][1] = w.z * dt;  F[0][2] = -w.y * dt;
+    F[1][0] = -w.z * dt; F[1][2] = w.x * dt;
+    F[2][0] = w.y * dt;  F[2][1] = -w.x * dt;
+    F[0][3] = F[1][4] = F[2][5] = -dt;
+
+    float FP[6][6] = {};
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 6; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 6; k++) {
+                sum += F[i][k] * P_[k][j];
+            }
+            FP[i][j] = sum;
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 6; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 6; k++) {
+                sum += FP[i][k] * F[j][k];
+            }
+            P_[i][j] = sum;
+        }
+    }
+    float qa = config_.gyro_noise * dt;
+    float qb = config_.gyro_bias_noise * config_.gyro_bias_noise * dt;
+    for (int i = 0; i < 3; i++) {
+        P_[i][i] += qa * qa;
+        P_[i + 3][i + 3] += qb;
+    }
+
+    // 加速度观测：比力偏离 1g 时按偏离程度放大噪声，抑制运动加速度的影响
+    float a_norm = norm(accel);
+    if (a_norm > 0.0f) {
+        float deviation = std::fabs(a_norm / GRAVITY - 1.0f);
+        float noise = config_.accel_noise * (1.0f + 20.0f * deviation);
+        correct(accel * (1.0f / a_norm), rotateInverse(q_, Vec3f{0.0f, 0.0f, 1.0f}), noise);
+    }
+
+    // 磁场观测：参考方向取当前估计下磁场的水平分量对齐世界系 x 轴
+    if (mag != nullptr && norm(*mag) > 0.0f) {
+        Vec3f m = normalized(*mag);
+        Vec3f mw = rotate(q_, m);
+        Vec3f ref = normalized(Vec3f{std::sqrt(mw.x * mw.x + mw.y * mw.y), 0.0f, mw.z});
+        correct(m, rotateInverse(q_, ref), config_.mag_noise);
+    }
+}
+
+void ErrorStateEKF::correct(const Vec3f& z, const Vec3f& h, float noise) {
+    // H = [[h]x, 0]
+    float H[3][6] = {};
+    H[0][1] = -h.z; H[0][2] = h.y;
+    H[1][0] = h.z;  H[1][2] = -h.x;
+    H[2][0] = -h.y; H[2][1] = h.x;
+
+    // PHt = P H^T (6x3)，S = H P H^T + R (3x3)
+    float PHt[6][3] = {};
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 3; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 6; k++) {
+                sum += P_[i][k] * H[j][k];
+            }
+            PHt[i][j] = sum;
+        }
+    }
+    float S[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 6; k++) {
+                sum += H[i][k] * PHt[k][j];
+            }
+            S[i][j] = sum + (i == j ? noise * noise : 0.0f);
+        }
+    }
+
+    // 3x3 求逆（伴随矩阵）
+    float det = S[0][0] * (S[1][1] * S[2][2] - S[1][2] * S[2][1])
+              - S[0][1] * (S[1][0] * S[2][2] - S[1][2] * S[2][0])
+              + S[0][2] * (S[1][0] * S[2][1] - S[1][1] * S[2][0]);
+    if (std::fabs(det) < 1e-12f) {
+        return;
+    }
+    float inv_det = 1.0f / det;
+    float Si[3][3];
+    Si[0][0] = (S[1][1] * S[2][2] - S[1][2] * S[2][1]) * inv_det;
+    Si[0][1] = (S[0][2] * S[2][1] - S[0][1] * S[2][2]) * inv_det;
+    Si[0][2] = (S[0][1] * S[1][2] - S[0][2] * S[1][1]) * inv_det;
+    Si[1][0] = (S[1][2] * S[2][0] - S[1][0] * S[2][2]) * inv_det;
+    Si[1][1] = (S[0][0] * S[2][2] - S[0][2] * S[2][0]) * inv_det;
+    Si[1][2] = (S[0][2] * S[1][0] - S[0][0] * S[1][2]) * inv_det;
+    Si[2][0] = (S[1][0] * S[2][1] - S[1][1] * S[2][0]) * inv_det;
+    Si[2][1] = (S[0][1] * S[2][0] - S[0][0] * S[2][1]) * inv_det;
+    Si[2][2] = (S[0][0] * S[1][1] - S[0][1] * S[1][0]) * inv_det;
+
+    // K = PHt S^-1 (6x3)
+    float K[6][3];
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 3; j++) {
+            K[i][j] = PHt[i][0] * Si[0][j] + PHt[i][1] * Si[1][j] + PHt[i][2] * Si[2][j];
+        }
+    }
+
+    // 误差状态估计并注入名义状态
+    float r[3] = {z.x - h.x, z.y - h.y, z.z - h.z};
+    float dx[6];
+    for (int i = 0; i < 6; i++) {
+        dx[i] = K[i][0] * r[0] + K[i][1] * r[1] + K[i][2] * r[2];
+    }
+    q_ = normalized(q_ * quatFromRotationVector(Vec3f{dx[0], dx[1], dx[2]}));
+    bias_ = bias_ + Vec3f{dx[3], dx[4], dx[5]};
+
+    // P = (I - K H) P = P - K (H P)，H P = PHt^T
+    float KHP[6][6];
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 6; j++) {
+            KHP[i][j] = K[i][0] * PHt[j][0] + K[i][1] * PHt[j][1] + K[i][2] * PHt[j][2];
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        for (int j = i; j < 6; j++) {
+            float v = 0.5f * ((P_[i][j] - KHP[i][j]) + (P_[j][i] - KHP[j][i]));
+            P_[i][j] = v;
+            P_[j][i] = v;
+        }
+    }
+}
+
+std::unique_ptr<AHRSFilter> createAHRSFilter(const AHRSConfig& config) {
+    switch (config.algorithm) {
+        case AHRSAlgorithm::MADGWICK:
+            return std::make_unique<MadgwickFilter>(config.beta);
+        case AHRSAlgorithm::MAHONY:
+            return std::make_unique<MahonyFilter>(config.kp, config.ki);
+        case AHRSAlgorithm::EKF:
+            return std::make_unique<ErrorStateEKF>(config);
+        default:
+            return nullptr;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 多通道 Madgwick / Mahony
+
+AHRSBatch::AHRSBatch(const AHRSConfig& config)
+    : algorithm_(config.algorithm)
+    , beta_(config.beta)
+    , kp_(config.kp)
+    , ki_(config.ki) {
+    reset();
+}
+
+void AHRSBatch::reset() {
+    for (int i = 0; i < AHRS_BATCH_LANES; i++) {
+        qw_[i] = 1.0f;
+        qx_[i] = qy_[i] = qz_[i] = 0.0f;
+        ix_[i] = iy_[i] = iz_[i] = 0.0f;
+    }
+}
+
+void AHRSBatch::update(const float* gx, const float* gy, const float* gz,
+                       const float* ax, const float* ay, const float* az,
+                       const float* mx, const float* my, const float* mz, const float* dt) {
+    if (algorithm_ == AHRSAlgorithm::MADGWICK) {
+        if (mx != nullptr) {
+            updateMadgwick<true>(gx, gy, gz, ax, ay, az, mx, my, mz, dt);
+        } else {
+            updateMadgwick<false>(gx, gy, gz, ax, ay, az, mx, my, mz, dt);
+        }
+    } else if (algorithm_ == AHRSAlgorithm::MAHONY) {
+        if (mx != nullptr) {
+            updateMahony<true>(gx, gy, gz, ax, ay, az, mx, my, mz, dt);
+        } else {
+            updateMahony<false>(gx, gy, gz, ax, ay, az, mx, my, mz, dt);
+        }
+    }
+}
+
+template <bool Mag>
+void AHRSBatch::updateMadgwick(const float* gx, const float* gy, const float* gz,
+                               const float* ax_in, const float* ay_in, const float* az_in,
+                               const float* mx_in, const float* my_in, const float* mz_in, const float* dt) {
+    const float beta = beta_;
+    for (int i = 0; i < AHRS_BATCH_LANES; i++) {
+        float q0 = qw_[i], q1 = qx_[i], q2 = qy_[i], q3 = qz_[i];
+
+        float qDot1 = 0.5f * (-q1 * gx[i] - q2 * gy[i] - q3 * gz[i]);
+        float qDot2 = 0.5f * (q0 * gx[i] + q2 * gz[i] - q3 * gy[i]);
+        float qDot3 = 0.5f * (q0 * gy[i] - q1 * gz[i] + q3 * gx[i]);
+        float qDot4 = 0.5f * (q0 * gz[i] + q1 * gy[i] - q2 * gx[i]);
+
+        float an = ax_in[i] * ax_in[i] + ay_in[i] * ay_in[i] + az_in[i] * az_in[i];
+        float recipNorm = laneInvSqrt(an);
+        float ax = ax_in[i] * recipNorm, ay = ay_in[i] * recipNorm, az = az_in[i] * recipNorm;
+
+        float s0, s1, s2, s3;
+        if (Mag) {
+            float mnorm = laneInvSqrt(mx_in[i] * mx_in[i] + my_in[i] * my_in[i] + mz_in[i] * mz_in[i]);
+            float mx = mx_in[i] * mnorm, my = my_in[i] * mnorm, mz = mz_in[i] * mnorm;
+
+            float _2q0mx = 2.0f * q0 * mx, _2q0my = 2.0f * q0 * my, _2q0mz = 2.0f * q0 * mz;
+            float _2q1mx = 2.0f * q1 * mx;
+            float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+            float _2q0q2 = 2.0f * q0 * q2, _2q2q3 = 2.0f * q2 * q3;
+            float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+            float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+            float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+            float hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 + _2q1 * mz * q3
+                       - mx * q2q2 - mx * q3q3;
+            float hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 + my * q2q2
+                       + _2q2 * mz * q3 - my * q3q3;
+            float _2bx = std::sqrt(hx * hx + hy * hy);
+            float _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 + _2q2 * my * q3
+                         - mz * q2q2 + mz * q3q3;
+            float _4bx = 2.0f * _2bx, _4bz = 2.0f * _2bz;
+
+            float fax = 2.0f * q1q3 - _2q0q2 - ax;
+            float fay = 2.0f * q0q1 + _2q2q3 - ay;
+            float faz = 1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az;
+            float fmx = _2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx;
+            float fmy = _2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my;
+            float fmz = _2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz;
+
+            s0 = -_2q2 * fax + _2q1 * fay - _2bz * q2 * fmx + (-_2bx * q3 + _2bz * q1) * fmy + _2bx * q2 * fmz;
+            s1 = _2q3 * fax + _2q0 * fay - 4.0f * q1 * faz + _2bz * q3 * fmx + (_2bx * q2 + _2bz * q0) * fmy
+                 + (_2bx * q3 - _4bz * q1) * fmz;
+            s2 = -_2q0 * fax + _2q3 * fay - 4.0f * q2 * faz + (-_4bx * q2 - _2bz * q0) * fmx
+                 + (_2bx * q1 + _2bz * q3) * fmy + (_2bx * q0 - _4bz * q2) * fmz;
+            s3 = _2q1 * fax + _2q2 * fay + (-_4bx * q3 + _2bz * q1) * fmx + (-_2bx * q0 + _2bz * q2) * fmy
+                 + _2bx * q1 * fmz;
+        } else {
+            float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+            s0 = 4.0f * q0 * q2q2 + 2.0f * q2 * ax + 4.0f * q0 * q1q1 - 2.0f * q1 * ay;
+            s1 = 4.0f * q1 * q3q3 - 2.0f * q3 * ax + 4.0f * q0q0 * q1 - 2.0f * q0 * ay - 4.0f * q1
+                 + 8.0f * q1 * q1q1 + 8.0f * q1 * q2q2 + 4.0f * q1 * az;
+            s2 = 4.0f * q0q0 * q2 + 2.0f * q0 * ax + 4.0f * q2 * q3q3 - 2.0f * q3 * ay - 4.0f * q2
+                 + 8.0f * q2 * q1q1 + 8.0f * q2 * q2q2 + 4.0f * q2 * az;
+            s3 = 4.0f * q1q1 * q3 - 2.0f * q1 * ax + 4.0f * q2q2 * q3 - 2.0f * q2 * ay;
+        }
+
+        // 加速度为零的通道不做校正
+        float gain = an > 0.0f ? beta : 0.0f;
+        float k = gain * laneInvSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        q0 += (qDot1 - k * s0) * dt[i];
+        q1 += (qDot2 - k * s1) * dt[i];
+        q2 += (qDot3 - k * s2) * dt[i];
+        q3 += (qDot4 - k * s3) * dt[i];
+
+        float qn = laneInvSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        qw_[i] = q0 * qn;
+        qx_[i] = q1 * qn;
+        qy_[i] = q2 * qn;
+        qz_[i] = q3 * qn;
+    }
+}
+
+template <bool Mag>
+void AHRSBatch::updateMahony(const float* gx, const float* gy, const float* gz,
+                             const float* ax_in, const float* ay_in, const float* az_in,
+                             const float* mx_in, const float* my_in, const float* mz_in, const float* dt) {
+    const float kp2 = 2.0f * kp_;
+    const float ki2 = 2.0f * ki_;
+    for (int i = 0; i < AHRS_BATCH_LANES; i++) {
+        float q0 = qw_[i], q1 = qx_[i], q2 = qy_[i], q3 = qz_[i];
+
+        float an = ax_in[i] * ax_in[i] + ay_in[i] * ay_in[i] + az_in[i] * az_in[i];
+        float recipNorm = laneInvSqrt(an);
+        float ax = ax_in[i] * recipNorm, ay = ay_in[i] * recipNorm, az = az_in[i] * recipNorm;
+        float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+        float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+        float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+        float halfvx = q1q3 - q0q2;
+        float halfvy = q0q1 + q2q3;
+        float halfvz = q0q0 - 0.5f + q3q3;
+        float halfex = ay * halfvz - az * halfvy;
+        float halfey = az * halfvx - ax * halfvz;
+        float halfez = ax * halfvy - ay * halfvx;
+
+        if (Mag) {
+            float mnorm = laneInvSqrt(mx_in[i] * mx_in[i] + my_in[i] * my_in[i] + mz_in[i] * mz_in[i]);
+            float mx = mx_in[i] * mnorm, my = my_in[i] * mnorm, mz = mz_in[i] * mnorm;
+            float hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+            float hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+            float bx = std::sqrt(hx * hx + hy * hy);
+            float bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+            float halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+            float halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+            float halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+            halfex += my * halfwz - mz * halfwy;
+            halfey += mz * halfwx - mx * halfwz;
+            halfez += mx * halfwy - my * halfwx;
+        }
+
+        // 加速度为零的通道增益取 0，不做校正、积分项不累加（只在增益上按通道选择，保持循环无分支）
+        float kp = an > 0.0f ? kp2 : 0.0f;
+        float ki_dt = (an > 0.0f ? ki2 : 0.0f) * dt[i];
+        ix_[i] += halfex * ki_dt;
+        iy_[i] += halfey * ki_dt;
+        iz_[i] += halfez * ki_dt;
+        float wx = gx[i] + ix_[i] + kp * halfex;
+        float wy = gy[i] + iy_[i] + kp * halfey;
+        float wz = gz[i] + iz_[i] + kp * halfez;
+
+        float h = 0.5f * dt[i];
+        wx *= h;
+        wy *= h;
+        wz *= h;
+        float n0 = q0 - q1 * wx - q2 * wy - q3 * wz;
+        float n1 = q1 + q0 * wx + q2 * wz - q3 * wy;
+        float n2 = q2 + q0 * wy - q1 * wz + q3 * wx;
+        float n3 = q3 + q0 * wz + q1 * wy - q2 * wx;
+        float qn = laneInvSqrt(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+        qw_[i] = n0 * qn;
+        qx_[i] = n1 * qn;
+        qy_[i] = n2 * qn;
+        qz_[i] = n3 * qn;
+    }
+}
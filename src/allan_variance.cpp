@@ -0,0 +1,161 @@
+/**
+ * @file allan_variance.cpp
+ * @brief 流式重叠 Allan 方差实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   以样本为单位计算：θ_n = Σ x_i，AVAR(m) = <(θ_{k+2m} - 2θ_{k+m} + θ_k)²> / (2 m²)，
+ *   采样周期 τ0 在 θ 与 τ 中约去，只用于输出横轴。
+ */
+#include "allan_variance.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 簇大小所在的抽取层级
+int levelOf(uint64_t m) {
+    int level = 0;
+    while ((m >> level) >= 2 * static_cast<uint64_t>(ALLAN_LEVEL_MIN_Q)) {
+        level++;
+    }
+    return level;
+}
+
+} // namespace
+
+std::vector<uint64_t> allanClusterSizes(uint64_t max_cluster, int points_per_decade) {
+    std::vector<uint64_t> sizes;
+    for (int k = 0;; k++) {
+        double raw = std::pow(10.0, static_cast<double>(k) / points_per_decade);
+        if (raw > static_cast<double>(max_cluster)) {
+            break;
+        }
+        uint64_t m = static_cast<uint64_t>(std::llround(raw));
+        int level = levelOf(m);
+        uint64_t stride = 1ull << level;
+        m = std::max<uint64_t>(stride, (m + stride / 2) / stride * stride);
+        if (m <= max_cluster && (sizes.empty() || m > sizes.back())) {
+            sizes.push_back(m);
+        }
+    }
+    return sizes;
+}
+
+AllanVarianceAccumulator::AllanVarianceAccumulator(const std::vector<uint64_t>& cluster_sizes)
+    : theta_(0.0)
+    , offset_(0.0)
+    , n_(0) {
+    for (uint64_t m : cluster_sizes) {
+        int level = levelOf(m);
+        uint64_t stride = 1ull << level;
+        if (m % stride != 0) {
+            continue;
+        }
+        while (static_cast<int>(levels_.size()) <= level) {
+            Level l;
+            l.stride = 1ull << levels_.size();
+            l.count = 0;
+            levels_.push_back(l);
+        }
+        levels_[level].clusters.push_back({m, static_cast<int>(m / stride), 0.0, 0});
+    }
+    // 去掉没有簇大小的层级
+    levels_.erase(std::remove_if(levels_.begin(), levels_.end(),
+                                 [](const Level& l) { return l.clusters.empty(); }),
+                  levels_.end());
+    // θ_0 = 0 写入各层级
+    for (Level& level : levels_) {
+        level.ring[0] = 0.0;
+        level.count = 1;
+    }
+}
+
+void AllanVarianceAccumulator::add(double value) {
+    if (n_ == 0) {
+        offset_ = value;
+    }
+    theta_ += value - offset_;
+    n_++;
+
+    for (Level& level : levels_) {
+        if ((n_ & (level.stride - 1)) != 0) {
+            continue;
+        }
+        uint64_t c = level.count++;
+        level.ring[c % ALLAN_LEVEL_RING] = theta_;
+        for (Cluster& cluster : level.clusters) {
+            uint64_t q = static_cast<uint64_t>(cluster.q);
+            if (c < 2 * q) {
+                continue;
+            }
+            double d = theta_ - 2.0 * level.ring[(c - q) % ALLAN_LEVEL_RING] + level.ring[(c - 2 * q) % ALLAN_LEVEL_RING];
+            cluster.sum_sq += d * d;
+            cluster.terms++;
+        }
+    }
+}
+
+void AllanVarianceAccumulator::add(const float* values, size_t count, size_t stride) {
+    for (size_t i = 0; i < count; i++) {
+        add(static_cast<double>(values[i * stride]));
+    }
+}
+
+std::vector<AllanPoint> AllanVarianceAccumulator::result() const {
+    std::vector<AllanPoint> points;
+    for (const Level& level : levels_) {
+        for (const Cluster& cluster : level.clusters) {
+            if (cluster.terms == 0) {
+                continue;
+            }
+            AllanPoint p;
+            p.cluster_size = cluster.m;
+            p.terms = cluster.terms;
+            p.avar = cluster.sum_sq / (2.0 * static_cast<double>(cluster.m) * cluster.m * cluster.terms);
+            points.push_back(p);
+        }
+    }
+    std::sort(points.begin(), points.end(),
+              [](const AllanPoint& a, const AllanPoint& b) { return a.cluster_size < b.cluster_size; });
+    return points;
+}
+
+AllanNoiseParams extractAllanNoise(const std::vector<double>& tau, const std::vector<double>& adev) {
+    AllanNoiseParams params;
+    size_t n = std::min(tau.size(), adev.size());
+    if (n < 2) {
+        return params;
+    }
+
+    // 最小偏差处为零偏不稳定性
+    size_t min_index = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (adev[i] < adev[min_index]) {
+            min_index = i;
+        }
+    }
+    params.bias_instability = adev[min_index] / 0.664;
+    params.bias_instability_tau = tau[min_index];
+
+    // 在最小值两侧分别寻找局部斜率最接近 -1/2 与 +1/2 的线段
+    double best_rw = 1e9, best_rrw = 1e9;
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (tau[i] <= 0 || tau[i + 1] <= 0 || adev[i] <= 0 || adev[i + 1] <= 0) {
+            continue;
+        }
+        double slope = std::log(adev[i + 1] / adev[i]) / std::log(tau[i + 1] / tau[i]);
+        double t = std::sqrt(tau[i] * tau[i + 1]);
+        double a = std::sqrt(adev[i] * adev[i + 1]);
+        if (i < min_index && std::fabs(slope + 0.5) < best_rw) {
+            best_rw = std::fabs(slope + 0.5);
+            params.random_walk = a * std::sqrt(t);
+        }
+        if (i >= min_index && std::fabs(slope - 0.5) < best_rrw) {
+            best_rrw = std::fabs(slope - 0.5);
+            params.rate_random_walk = a * std::sqrt(3.0 / t);
+        }
+    }
+    return params;
+}
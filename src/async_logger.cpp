@@ -0,0 +1,282 @@
+/**
+ * @file async_logger.cpp
+ * @brief 异步无锁日志实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   每个写日志的线程拥有一个 SPSC 环形缓冲，首次写日志时注册到全局列表。
+ *   后台线程按时间戳合并各缓冲中的记录，完成格式化后输出：
+ *   WARN/ERROR 写到 std::cerr，其余写到 std::cout，与原先的输出位置一致。
+ *   后台线程不轮询：生产者发布记录时若消费者已取空该缓冲（LogRing::commit() 返回 true），
+ *   才加锁置 pending_ 并唤醒；否则后台线程本轮取出前一条后必然还会取到这一条，
+ *   因此非空缓冲上的后续日志不触碰锁与条件变量，没有日志时后台线程不醒来。
+ */
+#include "async_logger.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+std::atomic<LogLevel> AsyncLogger::level_(LogLevel::INFO);
+
+namespace {
+
+// flush() 等待输出完成的上限
+constexpr auto FLUSH_TIMEOUT = std::chrono::seconds(1);
+
+// 按占位符格式化单个参数，spec 为 ':' 之后的部分，如 "02x"、".1f"
+void formatArg(std::string& out, const LogRecord& rec, int index, const std::string& spec) {
+    char fill = ' ';
+    int width = 0;
+    int precision = -1;
+    char type = '\0';
+
+    size_t i = 0;
+    if (i < spec.size() && spec[i] == '0') {
+        fill = '0';
+        i++;
+    }
+    while (i < spec.size() && isdigit(static_cast<unsigned char>(spec[i]))) {
+        width = width * 10 + (spec[i++] - '0');
+    }
+    if (i < spec.size() && spec[i] == '.') {
+        i++;
+        precision = 0;
+        while (i < spec.size() && isdigit(static_cast<unsigned char>(spec[i]))) {
+            precision = precision * 10 + (spec[i++] - '0');
+        }
+    }
+    if (i < spec.size()) {
+        type = spec[i];
+    }
+
+    char buf[64];
+    std::string fmt = "%";
+    if (fill == '0') fmt += '0';
+    if (width > 0) fmt += std::to_string(width);
+
+    switch (rec.types[index]) {
+        case LogArgType::I64:
+            fmt += (type == 'x') ? "llx" : "lld";
+            snprintf(buf, sizeof(buf), fmt.c_str(), static_cast<long long>(rec.args[index].i));
+            out += buf;
+            break;
+        case LogArgType::U64:
+            fmt += (type == 'x') ? "llx" : "llu";
+            snprintf(buf, sizeof(buf), fmt.c_str(), static_cast<unsigned long long>(rec.args[index].u));
+            out += buf;
+            break;
+        case LogArgType::F64:
+            if (precision >= 0) fmt += "." + std::to_string(precision);
+            fmt += (type == 'f' || precision >= 0) ? "f" : "g";
+            snprintf(buf, sizeof(buf), fmt.c_str(), rec.args[index].d);
+            out += buf;
+            break;
+        case LogArgType::STR: {
+            const char* s = rec.text + rec.args[index].str_off;
+            size_t len = strlen(s);
+            if (width > static_cast<int>(len)) out.append(width - len, fill);
+            out.append(s, len);
+            break;
+        }
+    }
+}
+
+// 将一条记录格式化为一行文本
+std::string formatRecord(const LogRecord& rec) {
+    std::string out;
+    int arg = 0;
+    for (const char* p = rec.fmt; *p; p++) {
+        if (*p == '{') {
+            const char* close = strchr(p, '}');
+            if (close != nullptr) {
+                std::string spec;
+                if (p[1] == ':') {
+                    spec.assign(p + 2, close);
+                }
+                if (arg < rec.nargs) {
+                    formatArg(out, rec, arg, spec);
+                }
+                arg++;
+                p = close;
+                continue;
+            }
+        }
+        out += *p;
+    }
+    return out;
+}
+
+} // namespace
+
+AsyncLogger::AsyncLogger()
+    : dropped_(0)
+    , reported_dropped_(0)
+    , pending_(false)
+    , draining_(false)
+    , running_(true) {
+    writer_thread_ = std::thread(&AsyncLogger::writerThread, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_ = false;
+    }
+    wake_cv_.notify_one();
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    drainAll();
+}
+
+AsyncLogger& AsyncLogger::instance() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+LogRing* AsyncLogger::threadRing() {
+    thread_local std::shared_ptr<LogRing> ring;
+    if (!ring) {
+        ring = std::make_shared<LogRing>();
+        AsyncLogger& logger = instance();
+        std::lock_guard<std::mutex> lock(logger.rings_mutex_);
+        logger.rings_.push_back(ring);
+    }
+    return ring.get();
+}
+
+uint64_t AsyncLogger::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LogLevel AsyncLogger::parseLevel(const std::string& name, LogLevel fallback) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "trace") return LogLevel::TRACE;
+    if (lower == "debug") return LogLevel::DEBUG;
+    if (lower == "info") return LogLevel::INFO;
+    if (lower == "warn" || lower == "warning") return LogLevel::WARN;
+    if (lower == "error") return LogLevel::ERROR;
+    if (lower == "off") return LogLevel::OFF;
+    return fallback;
+}
+
+void AsyncLogger::encodeText(LogRecord& rec, const char* s, size_t len) {
+    size_t avail = LOG_TEXT_BYTES - rec.text_len;
+    if (avail == 0) {
+        // 拷贝区已满，指向末尾的空串
+        rec.types[rec.nargs] = LogArgType::STR;
+        rec.args[rec.nargs++].str_off = LOG_TEXT_BYTES - 1;
+        return;
+    }
+    size_t n = std::min(len, avail - 1);
+    if (s != nullptr && n > 0) {
+        memcpy(rec.text + rec.text_len, s, n);
+    }
+    rec.text[rec.text_len + n] = '\0';
+    rec.types[rec.nargs] = LogArgType::STR;
+    rec.args[rec.nargs++].str_off = rec.text_len;
+    rec.text_len = static_cast<uint8_t>(rec.text_len + n + 1);
+}
+
+void AsyncLogger::flush() {
+    AsyncLogger& logger = instance();
+    std::unique_lock<std::mutex> lock(logger.wake_mutex_);
+    logger.idle_cv_.wait_for(lock, FLUSH_TIMEOUT, [&logger] {
+        return !logger.pending_ && !logger.draining_ && logger.allEmpty();
+    });
+}
+
+void AsyncLogger::wake() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        pending_ = true;
+    }
+    wake_cv_.notify_one();
+}
+
+bool AsyncLogger::allEmpty() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+        if (!ring->empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AsyncLogger::writerThread() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (true) {
+        wake_cv_.wait(lock, [this] { return pending_ || !running_; });
+        if (!running_) {
+            break;
+        }
+        pending_ = false;
+        draining_ = true;
+        lock.unlock();
+        drainAll();
+        lock.lock();
+        draining_ = false;
+        idle_cv_.notify_all();
+    }
+}
+
+void AsyncLogger::drainAll() {
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        // 移除已退出线程且已取空的缓冲
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                    [](const std::shared_ptr<LogRing>& r) {
+                                        return r.use_count() == 1 && r->empty();
+                                    }),
+                     rings_.end());
+        rings = rings_;
+    }
+
+    bool wrote_out = false;
+    bool wrote_err = false;
+
+    // 按时间戳合并各线程的记录
+    while (true) {
+        LogRing* next = nullptr;
+        const LogRecord* next_rec = nullptr;
+        for (const auto& ring : rings) {
+            const LogRecord* rec = ring->front();
+            if (rec != nullptr && (next_rec == nullptr || rec->time_ns < next_rec->time_ns)) {
+                next = ring.get();
+                next_rec = rec;
+            }
+        }
+        if (next == nullptr) {
+            break;
+        }
+
+        std::string line = formatRecord(*next_rec);
+        bool to_err = next_rec->level >= LogLevel::WARN;
+        next->pop();
+
+        if (to_err) {
+            std::cerr << line << '\n';
+            wrote_err = true;
+        } else {
+            std::cout << line << '\n';
+            wrote_out = true;
+        }
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped > reported_dropped_) {
+        std::cerr << "[日志] 缓冲已满，丢弃 " << (dropped - reported_dropped_) << " 条日志" << '\n';
+        reported_dropped_ = dropped;
+        wrote_err = true;
+    }
+
+    if (wrote_out) std::cout.flush();
+    if (wrote_err) std::cerr.flush();
+}
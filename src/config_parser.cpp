@@ -35,6 +35,10 @@ bool ConfigParser::load(const std::string& filename) {
         // 解析节名 [Section]
         if (line[0] == '[' && line.back() == ']') {
             current_section = line.substr(1, line.length() - 2);
+            if (config_data_.find(current_section) == config_data_.end()) {
+                config_data_[current_section];
+                section_order_.push_back(current_section);
+            }
             continue;
         }
 
@@ -87,6 +91,25 @@ float ConfigParser::getFloat(const std::string& section, const std::string& key,
     return std::stof(value);
 }
 
+std::vector<float> ConfigParser::getFloatList(const std::string& section, const std::string& key,
+                                              const std::vector<float>& default_value) {
+    std::string value = getString(section, key);
+    if (value.empty()) {
+        return default_value;
+    }
+
+    std::vector<float> result;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) {
+            result.push_back(std::stof(item));
+        }
+    }
+    return result;
+}
+
 bool ConfigParser::getBool(const std::string& section, const std::string& key, bool default_value) {
     std::string value = getString(section, key);
     if (value.empty()) {
@@ -99,6 +122,55 @@ bool ConfigParser::getBool(const std::string& section, const std::string& key, b
     return (value == "1" || value == "true" || value == "yes" || value == "on");
 }
 
+const std::map<std::string, std::string>* ConfigParser::section(const std::string& name) const {
+    auto it = config_data_.find(name);
+    return it == config_data_.end() ? nullptr : &it->second;
+}
+
+std::vector<ConfigChange> ConfigParser::diff(const ConfigParser& other) const {
+    static const std::map<std::string, std::string> empty;
+    std::vector<ConfigChange> changes;
+
+    // 两边节名的并集（std::map 有序，按节名归并）
+    auto a = config_data_.begin();
+    auto b = other.config_data_.begin();
+    while (a != config_data_.end() || b != other.config_data_.end()) {
+        const std::string* section;
+        const std::map<std::string, std::string>* old_keys = &empty;
+        const std::map<std::string, std::string>* new_keys = &empty;
+        if (b == other.config_data_.end() || (a != config_data_.end() && a->first < b->first)) {
+            section = &a->first;
+            old_keys = &(a++)->second;
+        } else if (a == config_data_.end() || b->first < a->first) {
+            section = &b->first;
+            new_keys = &(b++)->second;
+        } else {
+            section = &a->first;
+            old_keys = &(a++)->second;
+            new_keys = &(b++)->second;
+        }
+
+        auto x = old_keys->begin();
+        auto y = new_keys->begin();
+        while (x != old_keys->end() || y != new_keys->end()) {
+            if (y == new_keys->end() || (x != old_keys->end() && x->first < y->first)) {
+                changes.push_back({*section, x->first, x->second, ""});
+                ++x;
+            } else if (x == old_keys->end() || y->first < x->first) {
+                changes.push_back({*section, y->first, "", y->second});
+                ++y;
+            } else {
+                if (x->second != y->second) {
+                    changes.push_back({*section, x->first, x->second, y->second});
+                }
+                ++x;
+                ++y;
+            }
+        }
+    }
+    return changes;
+}
+
 std::string ConfigParser::trim(const std::string& str) {
     size_t first = str.find_first_not_of(" \t\r\n");
     if (first == std::string::npos) {
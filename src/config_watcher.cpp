@@ -0,0 +1,140 @@
+/**
+ * @file config_watcher.cpp
+ * @brief 基于 inotify 的配置文件变更监视实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   只在 Linux 下可用（inotify 与 eventfd）。目录被删除或卸载 (IN_IGNORED) 后不再收到事件，
+ *   监视线程输出警告后退出，读取照常进行。
+ */
+#include "config_watcher.h"
+#include "async_logger.h"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+ConfigWatcher::ConfigWatcher()
+    : debounce_ms_(200)
+    , inotify_fd_(-1)
+    , wake_fd_(-1)
+    , running_(false) {
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+bool ConfigWatcher::start(const std::string& filename, int debounce_ms, ConfigChangedCallback callback) {
+    stop();
+
+    size_t slash = filename.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : filename.substr(0, slash));
+    basename_ = slash == std::string::npos ? filename : filename.substr(slash + 1);
+    debounce_ms_ = debounce_ms > 0 ? debounce_ms : 0;
+    callback_ = callback;
+
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        LOG_WARN("警告: inotify 初始化失败: {}，配置热重载不可用", strerror(errno));
+        return false;
+    }
+    if (inotify_add_watch(inotify_fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_WARN("警告: 无法监视目录 {}: {}，配置热重载不可用", directory, strerror(errno));
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        LOG_WARN("警告: eventfd 创建失败: {}，配置热重载不可用", strerror(errno));
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    watch_thread_ = std::thread(&ConfigWatcher::watchThread, this);
+    LOG_INFO("配置热重载: 监视 {}", filename);
+    return true;
+}
+
+void ConfigWatcher::stop() {
+    if (watch_thread_.joinable()) {
+        running_ = false;
+        uint64_t one = 1;
+        if (write(wake_fd_, &one, sizeof(one)) < 0) {
+            // eventfd 计数溢出才会失败，此时线程已被唤醒
+        }
+        watch_thread_.join();
+    }
+    running_ = false;
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+}
+
+bool ConfigWatcher::readEvents() {
+    // inotify_event 后跟变长文件名，缓冲按其对齐
+    alignas(struct inotify_event) char buffer[4096];
+    bool matched = false;
+    while (true) {
+        ssize_t len = read(inotify_fd_, buffer, sizeof(buffer));
+        if (len <= 0) {
+            break;
+        }
+        for (char* p = buffer; p < buffer + len;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            if (event->mask & IN_IGNORED) {
+                LOG_WARN("警告: 配置目录已不可监视，停止配置热重载");
+                running_ = false;
+            } else if (event->len > 0 && basename_ == event->name) {
+                matched = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return matched;
+}
+
+void ConfigWatcher::watchThread() {
+    pollfd fds[2];
+    fds[0].fd = wake_fd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = inotify_fd_;
+    fds[1].events = POLLIN;
+
+    bool pending = false;
+    while (running_) {
+        // 有未处理的变更时，等待 debounce_ms 内的后续事件；否则一直等待
+        int ret = poll(fds, 2, pending ? debounce_ms_ : -1);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("配置监视 poll 失败: {}", strerror(errno));
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            break;
+        }
+        if (ret == 0) {
+            pending = false;
+            if (callback_) {
+                callback_();
+            }
+            continue;
+        }
+        if ((fds[1].revents & POLLIN) && readEvents()) {
+            pending = true;
+        }
+    }
+}
@@ -0,0 +1,218 @@
+/**
+ * @file device_config.cpp
+ * @brief 多设备配置节解析与校验实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   设备参数由键表描述（所属节、类型、取值范围），默认节与设备节共用同一套解析与校验。
+ *   默认节 [Serial]/[IMU] 中不属于设备参数的键保持忽略（兼容旧配置），设备节中的未知键视为错误，
+ *   以便发现拼写错误。错误信息统一为 "[节名] 键=值: 原因"，不抛出异常。
+ */
+#include "device_config.h"
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace {
+
+enum class KeyKind { STRING, INT, BOOL };
+
+// 设备参数键
+struct DeviceKey {
+    const char* key;
+    bool serial;                                    // 默认值取自 [Serial]（否则取自 [IMU]）
+    KeyKind kind;
+    std::string IMUDeviceConfig::*string_field;
+    int IMUDeviceConfig::*int_field;
+    bool IMUDeviceConfig::*bool_field;
+    int min_value;
+    int max_value;
+};
+
+const DeviceKey kDeviceKeys[] = {
+    {"port", true, KeyKind::STRING, &IMUDeviceConfig::port, nullptr, nullptr, 0, 0},
+    {"baudrate", true, KeyKind::INT, nullptr, &IMUDeviceConfig::baudrate, nullptr, 1, INT_MAX},
+    {"timeout", true, KeyKind::INT, nullptr, &IMUDeviceConfig::timeout, nullptr, 0, INT_MAX},
+    {"device_address", false, KeyKind::INT, nullptr, &IMUDeviceConfig::device_address, nullptr, 0, 255},
+    {"report_rate", false, KeyKind::INT, nullptr, &IMUDeviceConfig::report_rate, nullptr, 0, 255},
+    {"subscribe_tag", false, KeyKind::INT, nullptr, &IMUDeviceConfig::subscribe_tag, nullptr, 0x01, 0x7F},
+    {"host_derive", false, KeyKind::BOOL, nullptr, nullptr, &IMUDeviceConfig::host_derive, 0, 0},
+    {"compass_on", false, KeyKind::BOOL, nullptr, nullptr, &IMUDeviceConfig::compass_on, 0, 0},
+    {"barometer_filter", false, KeyKind::INT, nullptr, &IMUDeviceConfig::barometer_filter, nullptr, 0, 3},
+    {"gyro_filter", false, KeyKind::INT, nullptr, &IMUDeviceConfig::gyro_filter, nullptr, 0, 2},
+    {"acc_filter", false, KeyKind::INT, nullptr, &IMUDeviceConfig::acc_filter, nullptr, 0, 4},
+    {"compass_filter", false, KeyKind::INT, nullptr, &IMUDeviceConfig::compass_filter, nullptr, 0, 9},
+};
+
+const DeviceKey* findKey(const std::string& key) {
+    for (const DeviceKey& entry : kDeviceKeys) {
+        if (key == entry.key) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// 整数，支持 0x 前缀的十六进制（与 ConfigParser::getInt 一致），不抛出异常
+bool parseInt(const std::string& value, int& result) {
+    if (value.empty()) {
+        return false;
+    }
+    bool hex = value.length() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X');
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(value.c_str(), &end, hex ? 16 : 10);
+    if (*end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+        return false;
+    }
+    result = static_cast<int>(parsed);
+    return true;
+}
+
+// 布尔值：取值集合同 ConfigParser::getBool，但其他取值视为错误而不是 false
+bool parseBool(const std::string& value, bool& result) {
+    std::string lower = value;
+    for (char& c : lower) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (lower == "1" || lower == "true" || lower == "yes" || lower == "on") {
+        result = true;
+        return true;
+    }
+    if (lower == "0" || lower == "false" || lower == "no" || lower == "off") {
+        result = false;
+        return true;
+    }
+    return false;
+}
+
+void addError(std::vector<std::string>& errors, const std::string& section, const std::string& key,
+              const std::string& value, const std::string& reason) {
+    errors.push_back("[" + section + "] " + key + "=" + value + ": " + reason);
+}
+
+// 把一个键写入设备参数，取值无效时记录错误并保持原值
+void applyKey(const DeviceKey& entry, const std::string& section, const std::string& value,
+              IMUDeviceConfig& device, std::vector<std::string>& errors) {
+    switch (entry.kind) {
+    case KeyKind::STRING:
+        if (value.empty()) {
+            addError(errors, section, entry.key, value, "不能为空");
+        } else {
+            device.*entry.string_field = value;
+        }
+        break;
+    case KeyKind::INT: {
+        int parsed = 0;
+        if (!parseInt(value, parsed)) {
+            addError(errors, section, entry.key, value, "不是整数");
+        } else if (parsed < entry.min_value || parsed > entry.max_value) {
+            addError(errors, section, entry.key, value,
+                     "超出范围 (" + std::to_string(entry.min_value) + "-" + std::to_string(entry.max_value) + ")");
+        } else {
+            device.*entry.int_field = parsed;
+        }
+        break;
+    }
+    case KeyKind::BOOL: {
+        bool parsed = false;
+        if (!parseBool(value, parsed)) {
+            addError(errors, section, entry.key, value, "不是布尔值 (0/1)");
+        } else {
+            device.*entry.bool_field = parsed;
+        }
+        break;
+    }
+    }
+}
+
+// 应用默认节中属于该节的设备参数键，其他键忽略
+void applyDefaultSection(const ConfigParser& config, const char* section, bool serial, IMUDeviceConfig& device,
+                         std::vector<std::string>& errors) {
+    const std::map<std::string, std::string>* keys = config.section(section);
+    if (!keys) {
+        return;
+    }
+    for (const auto& kv : *keys) {
+        const DeviceKey* entry = findKey(kv.first);
+        if (entry && entry->serial == serial) {
+            applyKey(*entry, section, kv.second, device, errors);
+        }
+    }
+}
+
+}  // namespace
+
+bool parseDeviceConfig(const ConfigParser& config, IMUDeviceConfig& device, std::vector<std::string>& errors) {
+    size_t error_count = errors.size();
+    device = IMUDeviceConfig();
+    applyDefaultSection(config, "Serial", true, device, errors);
+    applyDefaultSection(config, "IMU", false, device, errors);
+    return errors.size() == error_count;
+}
+
+bool parseDeviceConfigs(const ConfigParser& config, std::vector<IMUDeviceConfig>& devices,
+                        std::vector<std::string>& errors) {
+    size_t error_count = errors.size();
+    devices.clear();
+
+    IMUDeviceConfig defaults;
+    parseDeviceConfig(config, defaults, errors);
+
+    const std::string prefix = IMU_DEVICE_SECTION_PREFIX;
+    std::unordered_map<std::string, size_t> device_index;
+    std::unordered_map<std::string, std::string> port_owner;
+    for (const std::string& section : config.sections()) {
+        if (section.compare(0, prefix.length(), prefix) != 0) {
+            continue;
+        }
+        std::string name = section.substr(prefix.length());
+        if (name.empty()) {
+            errors.push_back("[" + section + "] 设备名为空");
+            continue;
+        }
+        const std::map<std::string, std::string>& keys = *config.section(section);
+
+        IMUDeviceConfig device = defaults;
+        auto inherit = keys.find("inherit");
+        if (inherit != keys.end()) {
+            auto base = device_index.find(inherit->second);
+            if (base == device_index.end()) {
+                addError(errors, section, "inherit", inherit->second, "未找到在此之前定义的设备");
+            } else {
+                device = devices[base->second];
+            }
+        }
+        device.name = name;
+
+        for (const auto& kv : keys) {
+            if (kv.first == "inherit") {
+                continue;
+            }
+            const DeviceKey* entry = findKey(kv.first);
+            if (!entry) {
+                addError(errors, section, kv.first, kv.second, "未知的键");
+                continue;
+            }
+            applyKey(*entry, section, kv.second, device, errors);
+        }
+
+        auto owner = port_owner.emplace(device.port, name);
+        if (!owner.second) {
+            addError(errors, section, "port", device.port, "与 [" + prefix + owner.first->second + "] 重复");
+        }
+        device_index.emplace(name, devices.size());
+        devices.push_back(device);
+    }
+
+    if (devices.empty()) {
+        devices.push_back(defaults);
+    }
+    if (static_cast<int>(devices.size()) > IMU_MAX_DEVICES) {
+        errors.push_back("设备数 " + std::to_string(devices.size()) + " 超过上限 " + std::to_string(IMU_MAX_DEVICES));
+    }
+    return errors.size() == error_count;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file fft.cpp
+ * @brief 基 2 实数 FFT 实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   z[k] = x[2k] + i·x[2k+1] 做 n/2 点复数 FFT 得 Z，再由
+ *   X[k] = (Z[k] + Z*[h-k]) / 2 - i·W^k (Z[k] - Z*[h-k]) / 2，W = exp(-2πi/n)，h = n/2。
+ *   旋转因子以 double 计算后存为 float。
+ */
+#include "fft.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+}
+
+RealFFT::RealFFT(int n)
+    : n_(n)
+    , half_(n / 2) {
+    if (!isPowerOfTwo(n)) {
+        throw std::invalid_argument("RealFFT: 长度必须为 2 的幂且不小于 4");
+    }
+
+    int bits = 0;
+    while ((1 << bits) < half_) {
+        bits++;
+    }
+    bitrev_.resize(half_);
+    for (int i = 0; i < half_; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitrev_[i] = r;
+    }
+
+    twiddle_.resize(std::max(1, half_ / 2));
+    for (int j = 0; j < static_cast<int>(twiddle_.size()); j++) {
+        double a = -2.0 * PI * j / half_;
+        twiddle_[j] = std::complex<float>(static_cast<float>(std::cos(a)), static_cast<float>(std::sin(a)));
+    }
+    post_twiddle_.resize(half_ + 1);
+    for (int k = 0; k <= half_; k++) {
+        double a = -2.0 * PI * k / n_;
+        post_twiddle_[k] = std::complex<float>(static_cast<float>(std::cos(a)), static_cast<float>(std::sin(a)));
+    }
+    work_.resize(half_);
+}
+
+void RealFFT::complexFFT(std::complex<float>* data, int sign) {
+    for (int i = 0; i < half_; i++) {
+        int j = bitrev_[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for (int len = 2; len <= half_; len <<= 1) {
+        int step = half_ / len;
+        int mid = len / 2;
+        for (int start = 0; start < half_; start += len) {
+            for (int j = 0; j < mid; j++) {
+                std::complex<float> w = twiddle_[j * step];
+                if (sign > 0) {
+                    w = std::conj(w);
+                }
+                std::complex<float> t = w * data[start + j + mid];
+                std::complex<float> u = data[start + j];
+                data[start + j] = u + t;
+                data[start + j + mid] = u - t;
+            }
+        }
+    }
+}
+
+void RealFFT::forward(const float* in, std::complex<float>* out) {
+    for (int k = 0; k < half_; k++) {
+        work_[k] = std::complex<float>(in[2 * k], in[2 * k + 1]);
+    }
+    complexFFT(work_.data(), -1);
+
+    const std::complex<float> minus_i(0.0f, -1.0f);
+    for (int k = 0; k <= half_; k++) {
+        std::complex<float> zk = work_[k % half_];
+        std::complex<float> zc = std::conj(work_[(half_ - k) % half_]);
+        std::complex<float> even = 0.5f * (zk + zc);
+        std::complex<float> odd = 0.5f * (zk - zc);
+        out[k] = even + minus_i * post_twiddle_[k] * odd;
+    }
+}
+
+void RealFFT::inverse(const std::complex<float>* in, float* out) {
+    // 由 X 重建 Z[k] = E[k] + i·W^-k·O[k]
+    const std::complex<float> plus_i(0.0f, 1.0f);
+    for (int k = 0; k < half_; k++) {
+        std::complex<float> xk = in[k];
+        std::complex<float> xc = std::conj(in[half_ - k]);
+        std::complex<float> even = 0.5f * (xk + xc);
+        std::complex<float> odd = 0.5f * (xk - xc) * std::conj(post_twiddle_[k]);
+        work_[k] = even + plus_i * odd;
+    }
+    complexFFT(work_.data(), +1);
+    float scale = 1.0f / half_;
+    for (int k = 0; k < half_; k++) {
+        out[2 * k] = work_[k].real() * scale;
+        out[2 * k + 1] = work_[k].imag() * scale;
+    }
+}
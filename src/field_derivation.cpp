@@ -0,0 +1,77 @@
+/**
+ * @file field_derivation.cpp
+ * @brief 主机端字段推导实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   欧拉角按 Z-Y-X 顺序（euler_x=横滚, euler_y=俯仰, euler_z=航向）由四元数求得；
+ *   线加速度 = 含重力加速度 - 四元数旋转到机体系的重力，静止时含重力加速度 z 轴为 +g。
+ *   四元数为 16 位定点，推导的欧拉角与设备输出相差在 0.01° 量级。
+ */
+#include "field_derivation.h"
+#include "imu_math.h"
+#include "throughput_planner.h"
+#include <algorithm>
+
+namespace {
+
+// 推导 derive 所需的设备字段
+uint16_t requiredSources(uint16_t derive_tag) {
+    uint16_t sources = 0;
+    if (derive_tag & 0x0040) sources |= 0x0020;
+    if (derive_tag & 0x0001) sources |= 0x0002 | 0x0020;
+    return sources;
+}
+
+inline void deriveOne(IMUData& d, uint16_t derive_tag) {
+    const F32 w = d.quat_w, x = d.quat_x, y = d.quat_y, z = d.quat_z;
+
+    if (derive_tag & 0x0040) {
+        F32 sinp = std::min(1.0f, std::max(-1.0f, 2.0f * (w * y - z * x)));
+        d.euler_x = std::atan2(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)) * RAD_TO_DEG;
+        d.euler_y = std::asin(sinp) * RAD_TO_DEG;
+        d.euler_z = std::atan2(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z)) * RAD_TO_DEG;
+    }
+
+    if (derive_tag & 0x0001) {
+        // 旋转矩阵第三行即世界系 z 轴在机体系中的方向
+        d.accel_x = d.accel_with_gravity_x - DEVICE_GRAVITY * 2.0f * (x * z - w * y);
+        d.accel_y = d.accel_with_gravity_y - DEVICE_GRAVITY * 2.0f * (y * z + w * x);
+        d.accel_z = d.accel_with_gravity_z - DEVICE_GRAVITY * (w * w - x * x - y * y + z * z);
+    }
+
+    d.subscribe_tag |= derive_tag;
+}
+
+} // namespace
+
+DerivationPlan planDerivation(uint16_t requested_tag) {
+    DerivationPlan best;
+    best.requested_tag = requested_tag;
+    best.device_tag = requested_tag;
+
+    // 候选推导集合：{}, {0x01}, {0x40}, {0x01, 0x40}
+    const uint16_t derivable = requested_tag & (0x0001 | 0x0040);
+    int best_bytes = sensorPayloadBytes(requested_tag);
+    for (uint16_t derive : {uint16_t(0x0001), uint16_t(0x0040), uint16_t(0x0041)}) {
+        if ((derive & derivable) != derive) {
+            continue;
+        }
+        uint16_t device_tag = (requested_tag & ~derive) | requiredSources(derive);
+        int bytes = sensorPayloadBytes(device_tag);
+        // 同等带宽时优先使用设备输出
+        if (bytes < best_bytes) {
+            best_bytes = bytes;
+            best.device_tag = device_tag;
+            best.derive_tag = derive;
+        }
+    }
+    return best;
+}
+
+void deriveFields(IMUData& data, uint16_t derive_tag) {
+    if (derive_tag != 0) {
+        deriveOne(data, derive_tag);
+    }
+}
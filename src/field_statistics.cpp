@@ -0,0 +1,221 @@
+/**
+ * @file field_statistics.cpp
+ * @brief IMUData 各字段滑动窗口统计实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   窗口满后每个新样本 x 替换最旧样本 y（Welford 滑动形式）：
+ *   mean' = mean + (x - y) / n，M2' = M2 + (x - y)(x - mean' + y - mean)。
+ *   窗口按样本数计，丢帧时覆盖的时间略长于标称秒数。
+ *   内存约为 3 x 容量 x 22 x 4 字节/窗口，如 1000Hz 下 60 秒窗口约 16MB。
+ */
+#include "field_statistics.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+constexpr int FIELDS = IMU_FLOAT_FIELDS;
+
+SlidingFieldWindow::SlidingFieldWindow()
+    : capacity_(0) {
+    reset();
+}
+
+void SlidingFieldWindow::configure(int capacity) {
+    capacity_ = std::max(2, capacity);
+    values_.assign(static_cast<size_t>(capacity_) * FIELDS, 0.0f);
+    out_min_.assign(static_cast<size_t>(capacity_) * FIELDS, 0.0f);
+    out_max_.assign(static_cast<size_t>(capacity_) * FIELDS, 0.0f);
+    reset();
+}
+
+void SlidingFieldWindow::reset() {
+    head_ = 0;
+    count_ = 0;
+    out_count_ = 0;
+    for (int f = 0; f < FIELDS; f++) {
+        in_min_[f] = std::numeric_limits<float>::infinity();
+        in_max_[f] = -std::numeric_limits<float>::infinity();
+        mean_[f] = 0.0;
+        m2_[f] = 0.0;
+    }
+}
+
+void SlidingFieldWindow::push(const float* sample) {
+    if (capacity_ == 0) {
+        return;
+    }
+
+    if (count_ < capacity_) {
+        // 未满：追加到入栈段
+        float* slot = &values_[static_cast<size_t>((head_ + count_) % capacity_) * FIELDS];
+        count_++;
+        double inv = 1.0 / count_;
+        for (int f = 0; f < FIELDS; f++) {
+            double d = sample[f] - mean_[f];
+            mean_[f] += d * inv;
+            m2_[f] += d * (sample[f] - mean_[f]);
+            slot[f] = sample[f];
+            in_min_[f] = std::min(in_min_[f], sample[f]);
+            in_max_[f] = std::max(in_max_[f], sample[f]);
+        }
+        return;
+    }
+
+    if (out_count_ == 0) {
+        transfer();
+    }
+
+    // 弹出最旧样本，新样本写入同一槽位并成为入栈段最新的一个
+    float* slot = &values_[static_cast<size_t>(head_) * FIELDS];
+    double inv = 1.0 / count_;
+    for (int f = 0; f < FIELDS; f++) {
+        double x = sample[f];
+        double y = slot[f];
+        double mean = mean_[f] + (x - y) * inv;
+        m2_[f] += (x - y) * (x - mean + y - mean_[f]);
+        mean_[f] = mean;
+        slot[f] = sample[f];
+        in_min_[f] = std::min(in_min_[f], sample[f]);
+        in_max_[f] = std::max(in_max_[f], sample[f]);
+    }
+    out_count_--;
+    head_ = (head_ + 1) % capacity_;
+}
+
+void SlidingFieldWindow::transfer() {
+    float run_min[FIELDS], run_max[FIELDS];
+    double sum[FIELDS];
+    for (int f = 0; f < FIELDS; f++) {
+        run_min[f] = std::numeric_limits<float>::infinity();
+        run_max[f] = -std::numeric_limits<float>::infinity();
+        sum[f] = 0.0;
+    }
+
+    // 从最新到最旧计算后缀最值
+    for (int k = count_ - 1; k >= 0; k--) {
+        size_t offset = static_cast<size_t>((head_ + k) % capacity_) * FIELDS;
+        const float* v = &values_[offset];
+        float* out_min = &out_min_[offset];
+        float* out_max = &out_max_[offset];
+        for (int f = 0; f < FIELDS; f++) {
+            run_min[f] = std::min(run_min[f], v[f]);
+            run_max[f] = std::max(run_max[f], v[f]);
+            out_min[f] = run_min[f];
+            out_max[f] = run_max[f];
+            sum[f] += v[f];
+        }
+    }
+
+    // 精确重算均值与方差
+    double inv = 1.0 / count_;
+    for (int f = 0; f < FIELDS; f++) {
+        mean_[f] = sum[f] * inv;
+        m2_[f] = 0.0;
+    }
+    for (int k = 0; k < count_; k++) {
+        const float* v = &values_[static_cast<size_t>((head_ + k) % capacity_) * FIELDS];
+        for (int f = 0; f < FIELDS; f++) {
+            double d = v[f] - mean_[f];
+            m2_[f] += d * d;
+        }
+    }
+
+    out_count_ = count_;
+    for (int f = 0; f < FIELDS; f++) {
+        in_min_[f] = std::numeric_limits<float>::infinity();
+        in_max_[f] = -std::numeric_limits<float>::infinity();
+    }
+}
+
+void SlidingFieldWindow::fill(FieldWindowStats& out) const {
+    out.samples = static_cast<uint32_t>(count_);
+    if (count_ == 0) {
+        return;
+    }
+    const float* out_min = out_count_ > 0 ? &out_min_[static_cast<size_t>(head_) * FIELDS] : nullptr;
+    const float* out_max = out_count_ > 0 ? &out_max_[static_cast<size_t>(head_) * FIELDS] : nullptr;
+    for (int f = 0; f < FIELDS; f++) {
+        out.min[f] = out_min ? std::min(out_min[f], in_min_[f]) : in_min_[f];
+        out.max[f] = out_max ? std::max(out_max[f], in_max_[f]) : in_max_[f];
+        out.mean[f] = static_cast<float>(mean_[f]);
+        out.stddev[f] = count_ > 1 ? static_cast<float>(std::sqrt(std::max(m2_[f], 0.0) / (count_ - 1))) : 0.0f;
+    }
+}
+
+FieldStatistics::FieldStatistics()
+    : windows_(0)
+    , seconds_{}
+    , has_publish_(false)
+    , last_publish_ms_(0) {
+}
+
+void FieldStatistics::configure(const FieldStatisticsConfig& config, double sample_rate) {
+    config_ = config;
+    windows_ = 0;
+    for (float seconds : config.windows_s) {
+        if (seconds <= 0.0f) {
+            continue;
+        }
+        if (windows_ == FIELD_STATS_MAX_WINDOWS) {
+            LOG_WARN("警告: 统计窗口最多 {} 个，忽略其余窗口", FIELD_STATS_MAX_WINDOWS);
+            break;
+        }
+        seconds_[windows_] = seconds;
+        window_[windows_].configure(static_cast<int>(std::lround(seconds * sample_rate)));
+        windows_++;
+    }
+    reset();
+}
+
+void FieldStatistics::adopt(FieldStatistics& staged) {
+    std::swap(config_, staged.config_);
+    std::swap(windows_, staged.windows_);
+    for (int w = 0; w < FIELD_STATS_MAX_WINDOWS; w++) {
+        std::swap(seconds_[w], staged.seconds_[w]);
+        std::swap(window_[w], staged.window_[w]);
+    }
+    reset();
+}
+
+void FieldStatistics::reset() {
+    for (int w = 0; w < windows_; w++) {
+        window_[w].reset();
+    }
+    has_publish_ = false;
+    last_publish_ms_ = 0;
+}
+
+void FieldStatistics::update(const IMUData& data) {
+    float sample[FIELDS];
+    for (int f = 0; f < FIELDS; f++) {
+        sample[f] = data.*IMU_FIELD_MEMBERS[f];
+    }
+    for (int w = 0; w < windows_; w++) {
+        window_[w].push(sample);
+    }
+
+    // 设备时间戳回退（重启）时立即发布并以新时间重新计时
+    int32_t delta = static_cast<int32_t>(data.timestamp - last_publish_ms_);
+    if (has_publish_ && delta >= 0 && delta < config_.publish_interval_ms) {
+        return;
+    }
+    has_publish_ = true;
+    last_publish_ms_ = data.timestamp;
+    publish(data);
+}
+
+void FieldStatistics::publish(const IMUData& data) {
+    FieldStatsSnapshot snapshot;
+    snapshot.timestamp = data.timestamp;
+    snapshot.subscribe_tag = data.subscribe_tag;
+    snapshot.windows = windows_;
+    for (int w = 0; w < windows_; w++) {
+        snapshot.window[w].seconds = seconds_[w];
+        window_[w].fill(snapshot.window[w]);
+    }
+    snapshot_.store(snapshot);
+}
@@ -0,0 +1,201 @@
+/**
+ * @file gyro_bias_estimator.cpp
+ * @brief 陀螺零偏在线估计实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   滑动和使用 double 累加，float 样本在窗口内加减的舍入误差可以忽略。
+ *   未订阅温度 (0x10) 时所有观测的温度为 0，模型即为加权均值。
+ */
+#include "gyro_bias_estimator.h"
+#include "config_parser.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+// 温度方差低于该值 (℃²) 时不拟合斜率
+constexpr double MIN_TEMPERATURE_VARIANCE = 0.25;
+
+GyroBiasEstimator::GyroBiasEstimator()
+    : window_(GYRO_BIAS_WINDOW_MAX) {
+    reset();
+}
+
+void GyroBiasEstimator::configure(const GyroBiasConfig& config, double period_ms) {
+    config_ = config;
+    int window = period_ms > 0 ? static_cast<int>(config.window_ms / period_ms + 0.5) : GYRO_BIAS_WINDOW_MAX;
+    window_ = std::max(8, std::min(window, GYRO_BIAS_WINDOW_MAX));
+    clearWindow();
+}
+
+void GyroBiasEstimator::clearWindow() {
+    head_ = 0;
+    count_ = 0;
+    memset(sum_, 0, sizeof(sum_));
+    memset(sumsq_, 0, sizeof(sumsq_));
+    temp_sum_ = 0.0;
+    since_observation_ = 0;
+    stationary_ = false;
+}
+
+void GyroBiasEstimator::reset() {
+    clearWindow();
+    w_ = wt_ = wtt_ = 0.0;
+    memset(wb_, 0, sizeof(wb_));
+    memset(wtb_, 0, sizeof(wtb_));
+    observations_ = 0;
+}
+
+bool GyroBiasEstimator::update(const IMUData& data) {
+    if ((data.subscribe_tag & 0x0004) == 0) {
+        return false;
+    }
+
+    float accel_norm = (data.subscribe_tag & 0x0002)
+        ? norm(Vec3f{data.accel_with_gravity_x, data.accel_with_gravity_y, data.accel_with_gravity_z})
+        : norm(Vec3f{data.accel_x, data.accel_y, data.accel_z});
+    float sample[4] = {data.gyro_x, data.gyro_y, data.gyro_z, accel_norm};
+    float temperature = (data.subscribe_tag & 0x0010) ? data.temperature : 0.0f;
+
+    // 窗口已满时移出最旧样本
+    float* slot = ring_[head_];
+    if (count_ == window_) {
+        for (int c = 0; c < 4; c++) {
+            sum_[c] -= slot[c];
+            sumsq_[c] -= static_cast<double>(slot[c]) * slot[c];
+        }
+    } else {
+        count_++;
+    }
+    for (int c = 0; c < 4; c++) {
+        slot[c] = sample[c];
+        sum_[c] += sample[c];
+        sumsq_[c] += static_cast<double>(sample[c]) * sample[c];
+    }
+    head_ = (head_ + 1) % window_;
+    temp_sum_ += temperature;
+    since_observation_++;
+
+    if (count_ < window_) {
+        stationary_ = false;
+        return false;
+    }
+
+    double mean[4], var[4];
+    for (int c = 0; c < 4; c++) {
+        mean[c] = sum_[c] / count_;
+        var[c] = std::max(0.0, sumsq_[c] / count_ - mean[c] * mean[c]);
+    }
+    double gyro_var_limit = static_cast<double>(config_.gyro_std) * config_.gyro_std;
+    double accel_var_limit = static_cast<double>(config_.accel_std) * config_.accel_std;
+    stationary_ = var[3] < accel_var_limit &&
+                  var[0] < gyro_var_limit && var[1] < gyro_var_limit && var[2] < gyro_var_limit &&
+                  std::fabs(mean[0]) < config_.gyro_max && std::fabs(mean[1]) < config_.gyro_max &&
+                  std::fabs(mean[2]) < config_.gyro_max;
+
+    // 每满一个窗口取一次观测，相邻观测不重叠
+    double window_temp = temp_sum_ / since_observation_;
+    if (since_observation_ < window_) {
+        return stationary_;
+    }
+    since_observation_ = 0;
+    temp_sum_ = 0.0;
+
+    if (stationary_) {
+        double lambda = config_.forgetting;
+        w_ = w_ * lambda + 1.0;
+        wt_ = wt_ * lambda + window_temp;
+        wtt_ = wtt_ * lambda + window_temp * window_temp;
+        for (int c = 0; c < 3; c++) {
+            wb_[c] = wb_[c] * lambda + mean[c];
+            wtb_[c] = wtb_[c] * lambda + window_temp * mean[c];
+        }
+        observations_++;
+    }
+    return stationary_;
+}
+
+Vec3f GyroBiasEstimator::biasAt(float temperature) const {
+    if (w_ <= 0.0) {
+        return Vec3f{};
+    }
+    double mean_t = wt_ / w_;
+    double var_t = wtt_ / w_ - mean_t * mean_t;
+    double bias[3];
+    for (int c = 0; c < 3; c++) {
+        double mean_b = wb_[c] / w_;
+        bias[c] = mean_b;
+        if (var_t > MIN_TEMPERATURE_VARIANCE) {
+            double slope = (wtb_[c] / w_ - mean_t * mean_b) / var_t;
+            bias[c] += slope * (temperature - mean_t);
+        }
+    }
+    return Vec3f{static_cast<float>(bias[0]), static_cast<float>(bias[1]), static_cast<float>(bias[2])};
+}
+
+void GyroBiasEstimator::apply(IMUData& data) const {
+    if ((data.subscribe_tag & 0x0004) == 0 || w_ <= 0.0) {
+        return;
+    }
+    Vec3f bias = biasAt((data.subscribe_tag & 0x0010) ? data.temperature : 0.0f);
+    data.gyro_x -= bias.x;
+    data.gyro_y -= bias.y;
+    data.gyro_z -= bias.z;
+}
+
+bool GyroBiasEstimator::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR("无法写入陀螺零偏文件: {}", filename);
+        return false;
+    }
+    file << std::setprecision(17);
+    file << "# 陀螺零偏模型（由 GyroBiasEstimator 生成）\n";
+    file << "[GyroBiasState]\n";
+    file << "observations=" << observations_ << "\n";
+    file << "w=" << w_ << "\n";
+    file << "wt=" << wt_ << "\n";
+    file << "wtt=" << wtt_ << "\n";
+    static const char* kAxis[] = {"x", "y", "z"};
+    for (int c = 0; c < 3; c++) {
+        file << "wb_" << kAxis[c] << "=" << wb_[c] << "\n";
+        file << "wtb_" << kAxis[c] << "=" << wtb_[c] << "\n";
+    }
+    return file.good();
+}
+
+bool GyroBiasEstimator::load(const std::string& filename) {
+    std::ifstream probe(filename);
+    if (!probe.is_open()) {
+        return false;
+    }
+    probe.close();
+
+    ConfigParser state;
+    if (!state.load(filename)) {
+        return false;
+    }
+    auto number = [&state](const std::string& key) {
+        std::string value = state.getString("GyroBiasState", key);
+        return value.empty() ? 0.0 : std::stod(value);
+    };
+    try {
+        w_ = number("w");
+        wt_ = number("wt");
+        wtt_ = number("wtt");
+        static const char* kAxis[] = {"x", "y", "z"};
+        for (int c = 0; c < 3; c++) {
+            wb_[c] = number(std::string("wb_") + kAxis[c]);
+            wtb_[c] = number(std::string("wtb_") + kAxis[c]);
+        }
+        observations_ = static_cast<uint64_t>(number("observations"));
+    } catch (const std::exception& e) {
+        LOG_WARN("警告: 陀螺零偏文件格式错误 {}: {}", filename, e.what());
+        reset();
+        return false;
+    }
+    return true;
+}
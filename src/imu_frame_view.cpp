@@ -0,0 +1,19 @@
+/**
+ * @file imu_frame_view.cpp
+ * @brief 传感器数据帧零拷贝视图实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   字段访问器在头文件中内联，这里只有完整解码，与 IMUParser 共用 decodeRawPayload()。
+ */
+#include "imu_frame_view.h"
+#include "imu_raw_sample.h"
+
+IMUData IMUFrameView::toIMUData() const {
+    IMUData data;
+    data.timestamp = timestamp_;
+    data.subscribe_tag = present_;
+    decodeRawPayload(payload_, present_, data);
+    return data;
+}
@@ -7,23 +7,54 @@
  * description: imu Data Parser
  */
 #include "imu_parser.h"
+#include "imu_frame_view.h"
+#include "imu_raw_sample.h"
+#include "async_logger.h"
+#include "trace.h"
 #include <cstring>
-#include <iostream>
 
-IMUParser::IMUParser() 
+IMUFrameReceiver::IMUFrameReceiver()
     : rx_state_(RX_STATE_WAIT_BEGIN)
     , rx_index_(0)
     , rx_cmd_len_(0)
     , rx_checksum_(0)
     , target_device_addr_(255)
-    , debug_enabled_(false) {
+    , frames_(0)
+    , sensor_frames_(0)
+    , checksum_errors_(0)
+    , end_errors_(0)
+    , addr_mismatches_(0)
+    , short_frames_(0)
+    , unknown_commands_(0) {
 }
 
-void IMUParser::setDataCallback(IMUDataCallback callback) {
+void IMUParser::setDataCallback(IMUDataDelegate callback) {
     data_callback_ = callback;
 }
 
+void IMUParser::setRawDataCallback(IMURawDataCallback callback) {
+    raw_data_callback_ = callback;
+}
+
+void IMUParser::setFrameViewCallback(IMUFrameViewCallback callback) {
+    frame_view_callback_ = callback;
+}
+
 bool IMUParser::processByte(U8 byte) {
+    if (!receiver_.processByte(byte)) {
+        return false;
+    }
+
+    IMU_TRACE_SCOPE("unpack_frame");
+    U8* buf = receiver_.frameData();
+    U8 dLen = receiver_.frameLength();
+    if (receiver_.acceptSensorFrame(buf, dLen)) {
+        parseSensorData(buf, dLen);
+    }
+    return true;
+}
+
+bool IMUFrameReceiver::processByte(U8 byte) {
     rx_checksum_ += byte;
 
     switch (rx_state_) {
@@ -73,9 +104,8 @@ bool IMUParser::processByte(U8 byte) {
                 rx_state_ = RX_STATE_END;
             } else {
                 // 校验失败，重置
-                if (debug_enabled_) {
-                    std::cerr << "[调试] 校验失败: 期望=" << (int)byte << " 计算=" << (int)(rx_checksum_ & 0xFF) << std::endl;
-                }
+                checksum_errors_.fetch_add(1, std::memory_order_relaxed);
+                LOG_DEBUG("[调试] 校验失败: 期望={} 计算={}", byte, rx_checksum_ & 0xFF);
                 rx_state_ = RX_STATE_WAIT_BEGIN;
             }
             break;
@@ -88,24 +118,17 @@ bool IMUParser::processByte(U8 byte) {
                 U8 addr = rx_buffer_[1];
                 U8 data_len = rx_index_ - 5;
                 if (target_device_addr_ == 255 || target_device_addr_ == addr) {
-                    if (debug_enabled_) {
-                        std::cout << "[调试] 收到完整数据包: 地址=" << (int)addr 
-                                  << " 长度=" << (int)data_len 
-                                  << " 命令=0x" << std::hex << (int)rx_buffer_[3] << std::dec << std::endl;
-                    }
-                    unpackData(&rx_buffer_[3], data_len);
+                    frames_.fetch_add(1, std::memory_order_relaxed);
+                    IMU_TRACE_INSTANT("frame_complete");
+                    LOG_TRACE("[调试] 收到完整数据包: 地址={} 长度={} 命令=0x{:x}", addr, data_len, rx_buffer_[3]);
                     return true;
                 } else {
-                    if (debug_enabled_) {
-                        std::cerr << "[调试] 地址不匹配: 期望=" << (int)target_device_addr_ 
-                                  << " 收到=" << (int)addr << std::endl;
-                    }
+                    addr_mismatches_.fetch_add(1, std::memory_order_relaxed);
+                    LOG_DEBUG("[调试] 地址不匹配: 期望={} 收到={}", target_device_addr_, addr);
                 }
             } else {
-                if (debug_enabled_) {
-                    std::cerr << "[调试] 结束字节错误: 期望=0x4D 收到=0x" 
-                              << std::hex << (int)byte << std::dec << std::endl;
-                }
+                end_errors_.fetch_add(1, std::memory_order_relaxed);
+                LOG_DEBUG("[调试] 结束字节错误: 期望=0x4D 收到=0x{:x}", byte);
             }
             break;
     }
@@ -113,133 +136,65 @@ bool IMUParser::processByte(U8 byte) {
     return false;
 }
 
-void IMUParser::unpackData(U8* buf, U8 dLen) {
-    if (dLen == 0) return;
+bool IMUFrameReceiver::acceptSensorFrame(const U8* buf, U8 dLen) {
+    if (dLen == 0) return false;
 
     switch (buf[0]) {
         case 0x11:  // 传感器数据
-            parseSensorData(buf, dLen);
-            break;
+            sensor_frames_.fetch_add(1, std::memory_order_relaxed);
+            if (dLen < 7) {
+                short_frames_.fetch_add(1, std::memory_order_relaxed);
+                LOG_DEBUG("[调试] 数据长度不足: {}", dLen);
+                return false;
+            }
+            return true;
         default:
             // 其他命令响应，可在此扩展
-            if (debug_enabled_) {
-                std::cout << "[调试] 收到未知命令: 0x" << std::hex << (int)buf[0] << std::dec << std::endl;
-            }
-            break;
+            unknown_commands_.fetch_add(1, std::memory_order_relaxed);
+            LOG_DEBUG("[调试] 收到未知命令: 0x{:x}", buf[0]);
+            return false;
     }
 }
 
 void IMUParser::parseSensorData(U8* buf, U8 dLen) {
-    if (dLen < 7) {
-        if (debug_enabled_) {
-            std::cerr << "[调试] 数据长度不足: " << (int)dLen << std::endl;
-        }
-        return;
-    }
+    IMU_TRACE_SCOPE("parse_sensor_data");
 
-    IMUData data;
-    
     // 解析订阅标签和时间戳
-    data.subscribe_tag = ((U16)buf[2] << 8) | buf[1];
-    data.timestamp = ((U32)buf[6] << 24) | ((U32)buf[5] << 16) | 
+    U16 subscribe_tag = ((U16)buf[2] << 8) | buf[1];
+    U32 timestamp = ((U32)buf[6] << 24) | ((U32)buf[5] << 16) |
                     ((U32)buf[4] << 8) | buf[3];
-
-    U8 L = 7;  // 数据起始位置
-
-    // 解析加速度（不含重力）
-    if ((data.subscribe_tag & 0x0001) != 0 && L + 6 <= dLen) {
-        data.accel_x = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ACCEL;
-        L += 2;
-        data.accel_y = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ACCEL;
-        L += 2;
-        data.accel_z = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ACCEL;
-        L += 2;
-    }
-
-    // 解析加速度（含重力）
-    if ((data.subscribe_tag & 0x0002) != 0 && L + 6 <= dLen) {
-        data.accel_with_gravity_x = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ACCEL;
-        L += 2;
-        data.accel_with_gravity_y = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ACCEL;
-        L += 2;
-        data.accel_with_gravity_z = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ACCEL;
-        L += 2;
-    }
-
-    // 解析角速度
-    if ((data.subscribe_tag & 0x0004) != 0 && L + 6 <= dLen) {
-        data.gyro_x = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ANGLE_SPEED;
-        L += 2;
-        data.gyro_y = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ANGLE_SPEED;
-        L += 2;
-        data.gyro_z = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ANGLE_SPEED;
-        L += 2;
-    }
-
-    // 解析磁力计
-    if ((data.subscribe_tag & 0x0008) != 0 && L + 6 <= dLen) {
-        data.mag_x = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_MAG;
-        L += 2;
-        data.mag_y = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_MAG;
-        L += 2;
-        data.mag_z = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_MAG;
-        L += 2;
-    }
-
-    // 解析温度、气压、高度
-    if ((data.subscribe_tag & 0x0010) != 0 && L + 8 <= dLen) {
-        // 温度
-        data.temperature = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_TEMPERATURE;
-        L += 2;
-
-        // 气压 (24位有符号整数)
-        U32 tmpU32 = ((U32)buf[L+2] << 16) | ((U32)buf[L+1] << 8) | buf[L];
-        if ((tmpU32 & 0x800000) == 0x800000) {
-            tmpU32 |= 0xff000000;  // 符号扩展
+    U16 present = rawPresentGroups(subscribe_tag, dLen - 7);
+
+    // 帧视图直接指向接收缓冲区，原始计数样本按线路格式拷贝，均不做浮点解码
+    if (raw_data_callback_ || frame_view_callback_) {
+        IMUFrameView view(buf + 7, present, timestamp);
+        if (raw_data_callback_) {
+            IMURawSample raw;
+            raw.assign(view);
+            raw_data_callback_(raw);
         }
-        data.pressure = (S32)tmpU32 * SCALE_AIR_PRESSURE;
-        L += 3;
-
-        // 高度 (24位有符号整数)
-        tmpU32 = ((U32)buf[L+2] << 16) | ((U32)buf[L+1] << 8) | buf[L];
-        if ((tmpU32 & 0x800000) == 0x800000) {
-            tmpU32 |= 0xff000000;  // 符号扩展
+        if (frame_view_callback_) {
+            frame_view_callback_(view);
         }
-        data.height = (S32)tmpU32 * SCALE_HEIGHT;
-        L += 3;
     }
 
-    // 解析四元数
-    if ((data.subscribe_tag & 0x0020) != 0 && L + 8 <= dLen) {
-        data.quat_w = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_QUAT;
-        L += 2;
-        data.quat_x = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_QUAT;
-        L += 2;
-        data.quat_y = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_QUAT;
-        L += 2;
-        data.quat_z = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_QUAT;
-        L += 2;
+    if (!data_callback_) {
+        return;
     }
 
-    // 解析欧拉角
-    if ((data.subscribe_tag & 0x0040) != 0 && L + 6 <= dLen) {
-        data.euler_x = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ANGLE;
-        L += 2;
-        data.euler_y = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ANGLE;
-        L += 2;
-        data.euler_z = (S16)(((S16)buf[L+1] << 8) | buf[L]) * SCALE_ANGLE;
-        L += 2;
-    }
+    IMUData data;
+    data.subscribe_tag = subscribe_tag;
+    data.timestamp = timestamp;
+
+    // 数据体中完整出现的字段组依次解码（订阅标签保留帧内原值）
+    decodeRawPayload(buf + 7, present, data);
 
     // 调用回调函数
-    if (data_callback_) {
-        data_callback_(data);
-    }
+    data_callback_(data);
 }
 
-int IMUParser::packAndSend(U8* pDat, U8 dLen, U8 deviceAddr, 
-                           std::function<int(const U8*, size_t)> sendFunc) {
-    if (dLen == 0 || dLen > CMD_PACKET_MAX_DAT_SIZE_TX || pDat == nullptr) {
+int IMUParser::packAndSend(U8* pDat, U8 dLen, U8 deviceAddr, IMUSendDelegate sendFunc) {
+    if (dLen == 0 || dLen > CMD_PACKET_MAX_DAT_SIZE_TX || pDat == nullptr || !sendFunc) {
         return -1;
     }
 
@@ -271,7 +226,7 @@ int IMUParser::packAndSend(U8* pDat, U8 dLen, U8 deviceAddr,
     return sendFunc(buf, 55 + dLen);
 }
 
-void IMUParser::reset() {
+void IMUFrameReceiver::reset() {
     rx_state_ = RX_STATE_WAIT_BEGIN;
     rx_index_ = 0;
     rx_cmd_len_ = 0;
@@ -279,3 +234,15 @@ void IMUParser::reset() {
     memset(rx_buffer_, 0, sizeof(rx_buffer_));
 }
 
+
+IMUParserStats IMUFrameReceiver::getStats() const {
+    IMUParserStats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.sensor_frames = sensor_frames_.load(std::memory_order_relaxed);
+    stats.checksum_errors = checksum_errors_.load(std::memory_order_relaxed);
+    stats.end_errors = end_errors_.load(std::memory_order_relaxed);
+    stats.addr_mismatches = addr_mismatches_.load(std::memory_order_relaxed);
+    stats.short_frames = short_frames_.load(std::memory_order_relaxed);
+    stats.unknown_commands = unknown_commands_.load(std::memory_order_relaxed);
+    return stats;
+}
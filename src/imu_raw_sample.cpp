@@ -0,0 +1,128 @@
+/**
+ * @file imu_raw_sample.cpp
+ * @brief 原始计数紧凑样本实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   字段访问委托给 IMUFrameView（偏移查 IMU_FRAME_OFFSETS 表），样本本身只保存数据体。
+ *   数据体中放不下的字段组与 IMUParser 一样跳过且不推进位置，存在掩码中不含该组。
+ *   IMUParser 的浮点解码同样经 decodeRawPayload()，两条路径的数值逐位一致。
+ */
+#include "imu_raw_sample.h"
+#include <cstring>
+
+uint16_t rawPresentGroups(uint16_t subscribe_tag, size_t payload_len, int* payload_bytes) {
+    uint16_t present = 0;
+    size_t size = 0;
+    for (int bit = 0; bit < 7; bit++) {
+        uint16_t group = static_cast<uint16_t>(1u << bit);
+        if ((subscribe_tag & group) != 0 && size + IMU_RAW_GROUP_BYTES[bit] <= payload_len) {
+            size += IMU_RAW_GROUP_BYTES[bit];
+            present |= group;
+        }
+    }
+    if (payload_bytes) {
+        *payload_bytes = static_cast<int>(size);
+    }
+    return present;
+}
+
+bool IMURawSample::assign(const U8* buf, size_t len) {
+    if (len < 7) {
+        return false;
+    }
+    uint16_t tag = (static_cast<U16>(buf[2]) << 8) | buf[1];
+    timestamp = (static_cast<U32>(buf[6]) << 24) | (static_cast<U32>(buf[5]) << 16) |
+                (static_cast<U32>(buf[4]) << 8) | buf[3];
+
+    // 存在的字段组在线路上本就连续，一次拷贝
+    int size = 0;
+    subscribe_tag = rawPresentGroups(tag, len - 7, &size);
+    memcpy(payload, buf + 7, size);
+    return true;
+}
+
+void IMURawSample::assign(const IMUFrameView& view) {
+    timestamp = view.timestamp();
+    subscribe_tag = view.subscribeTag();
+    memcpy(payload, view.payload(), view.payloadBytes());
+}
+
+void decodeRawPayload(const uint8_t* payload, uint16_t present, IMUData& data) {
+    // 顺序遍历数据体，避免逐字段重新计算偏移
+    const uint8_t* p = payload;
+    if (present & 0x0001) {
+        data.accel_x = readS16(p) * SCALE_ACCEL;
+        data.accel_y = readS16(p + 2) * SCALE_ACCEL;
+        data.accel_z = readS16(p + 4) * SCALE_ACCEL;
+        p += 6;
+    }
+    if (present & 0x0002) {
+        data.accel_with_gravity_x = readS16(p) * SCALE_ACCEL;
+        data.accel_with_gravity_y = readS16(p + 2) * SCALE_ACCEL;
+        data.accel_with_gravity_z = readS16(p + 4) * SCALE_ACCEL;
+        p += 6;
+    }
+    if (present & 0x0004) {
+        data.gyro_x = readS16(p) * SCALE_ANGLE_SPEED;
+        data.gyro_y = readS16(p + 2) * SCALE_ANGLE_SPEED;
+        data.gyro_z = readS16(p + 4) * SCALE_ANGLE_SPEED;
+        p += 6;
+    }
+    if (present & 0x0008) {
+        data.mag_x = readS16(p) * SCALE_MAG;
+        data.mag_y = readS16(p + 2) * SCALE_MAG;
+        data.mag_z = readS16(p + 4) * SCALE_MAG;
+        p += 6;
+    }
+    if (present & 0x0010) {
+        data.temperature = readS16(p) * SCALE_TEMPERATURE;
+        data.pressure = readS24(p + 2) * SCALE_AIR_PRESSURE;
+        data.height = readS24(p + 5) * SCALE_HEIGHT;
+        p += 8;
+    }
+    if (present & 0x0020) {
+        data.quat_w = readS16(p) * SCALE_QUAT;
+        data.quat_x = readS16(p + 2) * SCALE_QUAT;
+        data.quat_y = readS16(p + 4) * SCALE_QUAT;
+        data.quat_z = readS16(p + 6) * SCALE_QUAT;
+        p += 8;
+    }
+    if (present & 0x0040) {
+        data.euler_x = readS16(p) * SCALE_ANGLE;
+        data.euler_y = readS16(p + 2) * SCALE_ANGLE;
+        data.euler_z = readS16(p + 4) * SCALE_ANGLE;
+    }
+}
+
+size_t IMURawSample::serialize(U8* out) const {
+    out[0] = subscribe_tag & 0xFF;
+    out[1] = (subscribe_tag >> 8) & 0xFF;
+    out[2] = timestamp & 0xFF;
+    out[3] = (timestamp >> 8) & 0xFF;
+    out[4] = (timestamp >> 16) & 0xFF;
+    out[5] = (timestamp >> 24) & 0xFF;
+    int size = payloadBytes();
+    memcpy(out + IMU_RAW_HEADER_BYTES, payload, size);
+    return IMU_RAW_HEADER_BYTES + size;
+}
+
+size_t IMURawSample::deserialize(const U8* in, size_t len) {
+    if (len < static_cast<size_t>(IMU_RAW_HEADER_BYTES)) {
+        return 0;
+    }
+    uint16_t tag = (static_cast<U16>(in[1]) << 8) | in[0];
+    if (tag > 0x7F) {
+        return 0;
+    }
+    size_t size = IMU_FRAME_OFFSETS.offset[tag][7];
+    if (len < IMU_RAW_HEADER_BYTES + size) {
+        return 0;
+    }
+    subscribe_tag = tag;
+    timestamp = (static_cast<U32>(in[5]) << 24) | (static_cast<U32>(in[4]) << 16) |
+                (static_cast<U32>(in[3]) << 8) | in[2];
+    memcpy(payload, in + IMU_RAW_HEADER_BYTES, size);
+    return IMU_RAW_HEADER_BYTES + size;
+}
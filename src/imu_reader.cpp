@@ -14,7 +14,8 @@
  *     - 提供回调接口将解析后的传感器数据发布给上层
  *
  * 设计要点：
- *   - 互斥保护：所有对 serial_ 对象的访问由 serial_mutex_ 保护
+ *   - 并发访问：serial_ 为原子替换的 shared_ptr 句柄，读线程与命令发送各自持有副本，
+ *     分别由 serial::Serial 内部的读锁/写锁保护；lifecycle_mutex_ 只串行化打开与关闭
  *   - 线程模型：独立的 read_thread_ 负责字节读取，hotplug_thread_ 负责检测与重连
  *   - 错误恢复：遇到串口异常时尝试重连并在重连成功后重新配置 IMU
  *   - 非阻塞安全：发送命令与数据写入使用封装的发送函数保证原子性
@@ -30,30 +31,71 @@
  */
 
 #include "imu_reader.h"
-#include <iostream>
-#include <iomanip>
+#include "metrics_server.h"
+#include "async_logger.h"
+#include "trace.h"
+#include "throughput_planner.h"
 #include <unistd.h>
 #include <sys/stat.h>
+#include <algorithm>
 #include <fstream>
+#include <cmath>
+
+namespace {
+
+// 主机端各模块使用的输入采样率（上报频率为 0 时按 0.5Hz 计）
+double streamInputRate(int report_rate) {
+    return report_rate > 0 ? report_rate : 0.5;
+}
+
+}  // namespace
 
 IMUReader::IMUReader()
-    : running_(false)
+    : managed_(false)
+    , port_generation_(0)
+    , stream_reset_(0)
+    , running_(false)
     , connected_(false)
+    , rx_bytes_(0)
+    , reconnects_(0)
+    , callback_latency_sum_ns_(0)
     , baudrate_(115200)
     , timeout_(1000)
     , device_address_(255)
     , report_rate_(60)
     , subscribe_tag_(0x7F)
+    , host_derive_(false)
     , compass_on_(false)
     , barometer_filter_(2)
     , gyro_filter_(1)
     , acc_filter_(3)
     , compass_filter_(5)
+    , format_pending_(false)
+    , format_switched_(false)
     , check_interval_(1000)
     , reconnect_interval_(2000)
     , max_reconnect_(0)
-    , reconnect_count_(0) {
+    , reconnect_count_(0)
+    , hot_reload_enabled_(false)
+    , hot_reload_debounce_ms_(200)
+    , reopen_requested_(false)
+    , metrics_enabled_(false)
+    , metrics_bind_("127.0.0.1")
+    , metrics_port_(9464)
+    , ahrs_has_last_(false)
+    , ahrs_last_timestamp_(0)
+    , prediction_latency_us_(0)
+    , strapdown_has_last_(false)
+    , strapdown_last_timestamp_(0)
+    , strapdown_reset_pending_(false) {
+    for (auto& bucket : callback_latency_) {
+        bucket = 0;
+    }
+    derivation_.requested_tag = subscribe_tag_;
+    derivation_.device_tag = subscribe_tag_;
     parser_ = std::make_unique<IMUParser>();
+    parser_->setDataCallback([this](const IMUData& data) { onParsedData(data); });
+    resampler_ = makeResampler(streamInputRate(report_rate_));
 }
 
 IMUReader::~IMUReader() {
@@ -63,46 +105,208 @@ IMUReader::~IMUReader() {
 bool IMUReader::initialize(const std::string& config_file) {
     // 加载配置文件
     if (!config_.load(config_file)) {
-        std::cerr << "加载配置文件失败: " << config_file << std::endl;
+        LOG_ERROR("加载配置文件失败: {}", config_file);
         return false;
     }
+    config_file_ = config_file;
+    managed_ = false;
+
+    // 读取并校验串口与 IMU 配置，一次输出全部错误
+    IMUDeviceConfig device;
+    std::vector<std::string> errors;
+    if (!parseDeviceConfig(config_, device, errors)) {
+        for (const std::string& error : errors) {
+            LOG_ERROR("配置错误: {}", error);
+        }
+        return false;
+    }
+    return applyConfig(device);
+}
 
-    // 读取串口配置
-    port_ = config_.getString("Serial", "port", "/dev/ttyUSB0");
-    baudrate_ = config_.getInt("Serial", "baudrate", 115200);
-    timeout_ = config_.getInt("Serial", "timeout", 1000);
+bool IMUReader::initialize(const std::string& config_file, const ConfigParser& config, const IMUDeviceConfig& device) {
+    config_ = config;
+    config_file_ = config_file;
+    managed_ = true;
+    return applyConfig(device);
+}
 
-    // 读取IMU配置
-    device_address_ = config_.getInt("IMU", "device_address", 255);
-    report_rate_ = config_.getInt("IMU", "report_rate", 60);
-    subscribe_tag_ = config_.getInt("IMU", "subscribe_tag", 0x7F);
-    compass_on_ = config_.getBool("IMU", "compass_on", false);
-    barometer_filter_ = config_.getInt("IMU", "barometer_filter", 2);
-    gyro_filter_ = config_.getInt("IMU", "gyro_filter", 1);
-    acc_filter_ = config_.getInt("IMU", "acc_filter", 3);
-    compass_filter_ = config_.getInt("IMU", "compass_filter", 5);
+bool IMUReader::applyConfig(const IMUDeviceConfig& device) {
+    // 串口与 IMU 参数（已校验）
+    device_ = device;
+    port_ = device.port;
+    baudrate_ = device.baudrate;
+    timeout_ = device.timeout;
+    device_address_ = static_cast<U8>(device.device_address);
+    report_rate_ = device.report_rate;
+    subscribe_tag_ = static_cast<uint16_t>(device.subscribe_tag);
+    host_derive_ = device.host_derive;
+    compass_on_ = device.compass_on;
+    barometer_filter_ = device.barometer_filter;
+    gyro_filter_ = device.gyro_filter;
+    acc_filter_ = device.acc_filter;
+    compass_filter_ = device.compass_filter;
 
     // 读取热拔插配置
     check_interval_ = config_.getInt("HotPlug", "check_interval", 1000);
     reconnect_interval_ = config_.getInt("HotPlug", "reconnect_interval", 2000);
     max_reconnect_ = config_.getInt("HotPlug", "max_reconnect", 0);
 
-    // 读取调试配置
+    // 读取配置热重载配置
+    hot_reload_enabled_ = config_.getBool("HotReload", "enabled", false);
+    hot_reload_debounce_ms_ = config_.getInt("HotReload", "debounce_ms", 200);
+
+    // 读取实时调度配置
+    realtime_.read_thread.cpu = config_.getInt("RealTime", "read_thread_cpu", -1);
+    realtime_.read_thread.priority = config_.getInt("RealTime", "read_thread_priority", 0);
+    realtime_.hotplug_thread.cpu = config_.getInt("RealTime", "hotplug_thread_cpu", -1);
+    realtime_.hotplug_thread.priority = config_.getInt("RealTime", "hotplug_thread_priority", 0);
+    realtime_.lock_memory = config_.getBool("RealTime", "lock_memory", false);
+    realtime_.prefault_stack_kb = config_.getInt("RealTime", "prefault_stack_kb", 0);
+    realtime_.jitter_report = config_.getBool("RealTime", "jitter_report", false);
+
+    // 读取指标服务配置
+    metrics_enabled_ = config_.getBool("Metrics", "enabled", false);
+    metrics_bind_ = config_.getString("Metrics", "bind_address", "127.0.0.1");
+    metrics_port_ = config_.getInt("Metrics", "port", 9464);
+    metrics_name_ = config_.getString("Metrics", "name", device.name.empty() ? port_ : device.name);
+
+    // 读取调试配置，log_level 未设置时由 debug_enabled 决定日志等级
     debug_enabled_ = config_.getBool("Debug", "debug_enabled", false);
+    trace_file_ = config_.getString("Debug", "trace_file");
+    AsyncLogger::setLevel(AsyncLogger::parseLevel(config_.getString("Debug", "log_level"),
+                                                  debug_enabled_ ? LogLevel::DEBUG : LogLevel::INFO));
+
+    // 读取陀螺零偏估计配置，并加载上次保存的零偏模型
+    gyro_bias_config_.enabled = config_.getBool("GyroBias", "enabled", false);
+    gyro_bias_config_.window_ms = config_.getInt("GyroBias", "window_ms", 1000);
+    gyro_bias_config_.accel_std = config_.getFloat("GyroBias", "accel_std", 0.05f);
+    gyro_bias_config_.gyro_std = config_.getFloat("GyroBias", "gyro_std", 0.3f);
+    gyro_bias_config_.gyro_max = config_.getFloat("GyroBias", "gyro_max", 5.0f);
+    gyro_bias_config_.forgetting = config_.getFloat("GyroBias", "forgetting", 0.99f);
+    gyro_bias_config_.state_file = config_.getString("GyroBias", "state_file");
+    gyro_bias_.reset();
+    if (gyro_bias_config_.enabled && !gyro_bias_config_.state_file.empty() &&
+        gyro_bias_.load(gyro_bias_config_.state_file)) {
+        LOG_INFO("已加载陀螺零偏模型: {} ({} 次静止观测)", gyro_bias_config_.state_file, gyro_bias_.observations());
+    }
 
-    // 设置解析器的调试模式
-    parser_->setDebugEnabled(debug_enabled_);
-
-    if (debug_enabled_) {
-        std::cout << "配置加载成功:" << std::endl;
-        std::cout << "  串口: " << port_ << " @ " << baudrate_ << " baud" << std::endl;
-        std::cout << "  设备地址: " << (int)device_address_ << std::endl;
-        std::cout << "  上报频率: " << report_rate_ << " Hz" << std::endl;
+    // 读取磁力计标定配置
+    mag_cal_config_.enabled = config_.getBool("MagCalibration", "enabled", false);
+    mag_cal_config_.min_samples = config_.getInt("MagCalibration", "min_samples", 300);
+    mag_cal_config_.solve_interval_ms = config_.getInt("MagCalibration", "solve_interval_ms", 2000);
+    mag_cal_config_.min_spacing = config_.getFloat("MagCalibration", "min_spacing", 2.0f);
+    mag_cal_config_.max_axis_ratio = config_.getFloat("MagCalibration", "max_axis_ratio", 3.0f);
+    mag_calibrator_.reset();
+
+    // 读取重采样配置
+    resample_config_.enabled = config_.getBool("Resample", "enabled", false);
+    resample_config_.output_rate = config_.getFloat("Resample", "output_rate", 200.0f);
+    resample_config_.taps = config_.getInt("Resample", "taps", 16);
+    resample_config_.phases = config_.getInt("Resample", "phases", 64);
+    resample_config_.max_fill = config_.getInt("Resample", "max_fill", 8);
+    resample_config_.clock_time_constant_ms = config_.getInt("Resample", "clock_time_constant_ms", 1000);
+
+    // 读取字段统计配置
+    stats_config_.enabled = config_.getBool("Statistics", "enabled", false);
+    stats_config_.windows_s = config_.getFloatList("Statistics", "windows", {1.0f, 10.0f, 60.0f});
+    stats_config_.publish_interval_ms = config_.getInt("Statistics", "publish_interval_ms", 100);
+
+    // 读取振动频谱配置
+    vibration_config_.enabled = config_.getBool("Vibration", "enabled", false);
+    vibration_config_.fft_size = config_.getInt("Vibration", "fft_size", 256);
+    vibration_config_.overlap = config_.getFloat("Vibration", "overlap", 0.5f);
+    vibration_config_.publish_interval_ms = config_.getInt("Vibration", "publish_interval_ms", 1000);
+    vibration_config_.peaks = config_.getInt("Vibration", "peaks", 3);
+    vibration_config_.bands = parseVibrationBands(config_.getString("Vibration", "bands", "0-10,10-50,50-100"));
+
+    // 读取姿态融合配置
+    ahrs_config_.algorithm = parseAHRSAlgorithm(config_.getString("AHRS", "algorithm", "none"));
+    ahrs_config_.use_mag = config_.getBool("AHRS", "use_mag", false);
+    ahrs_config_.beta = config_.getFloat("AHRS", "beta", 0.1f);
+    ahrs_config_.kp = config_.getFloat("AHRS", "kp", 0.5f);
+    ahrs_config_.ki = config_.getFloat("AHRS", "ki", 0.0f);
+    ahrs_config_.gyro_noise = config_.getFloat("AHRS", "gyro_noise", 0.01f);
+    ahrs_config_.gyro_bias_noise = config_.getFloat("AHRS", "gyro_bias_noise", 1e-4f);
+    ahrs_config_.accel_noise = config_.getFloat("AHRS", "accel_noise", 0.05f);
+    ahrs_config_.mag_noise = config_.getFloat("AHRS", "mag_noise", 0.1f);
+    ahrs_ = createAHRSFilter(ahrs_config_);
+    ahrs_has_last_ = false;
+
+    // 读取姿态外推配置
+    prediction_config_.enabled = config_.getBool("Prediction", "enabled", false);
+    prediction_config_.mode = parsePredictionMode(config_.getString("Prediction", "mode", "constant"));
+    prediction_config_.max_horizon_ms = config_.getInt("Prediction", "max_horizon_ms", 100);
+    prediction_config_.latency_offset_us = config_.getInt("Prediction", "latency_offset_us", -1);
+    prediction_config_.alpha_smoothing = config_.getFloat("Prediction", "alpha_smoothing", 0.3f);
+    predictor_.configure(prediction_config_);
+
+    // 读取捷联积分配置
+    strapdown_config_.enabled = config_.getBool("Strapdown", "enabled", false);
+    strapdown_config_.gravity = config_.getFloat("Strapdown", "gravity", 9.8f);
+    strapdown_config_.zupt = config_.getBool("Strapdown", "zupt", true);
+    strapdown_config_.zupt_accel_tol = config_.getFloat("Strapdown", "zupt_accel_tol", 0.3f);
+    strapdown_config_.zupt_gyro_tol = config_.getFloat("Strapdown", "zupt_gyro_tol", 3.0f);
+    strapdown_config_.zupt_samples = config_.getInt("Strapdown", "zupt_samples", 20);
+    strapdown_.configure(strapdown_config_);
+    strapdown_reset_pending_ = true;
+
+    // 带宽优化：subscribe_tag 表示需要的字段，设备只订阅无法推导的部分
+    derivation_ = planSubscription(subscribe_tag_);
+
+    // 与上报频率、设备订阅相关的主机端状态
+    applyStreamFormat();
+    resampler_ = makeResampler(streamInputRate(report_rate_));
+    if (stats_config_.enabled) {
+        field_stats_.configure(stats_config_, streamInputRate(report_rate_));
     }
 
+    LOG_DEBUG("配置加载成功:");
+    LOG_DEBUG("  串口: {} @ {} baud", port_, baudrate_);
+    LOG_DEBUG("  设备地址: {}", device_address_.load());
+    LOG_DEBUG("  上报频率: {} Hz", report_rate_);
+
     return true;
 }
 
+DerivationPlan IMUReader::planSubscription(uint16_t subscribe_tag) const {
+    DerivationPlan plan = planDerivation(subscribe_tag);
+    if (!host_derive_) {
+        plan.device_tag = subscribe_tag;
+        plan.derive_tag = 0;
+    }
+    if (ahrs_) {
+        // 四元数由主机融合给出，欧拉角与线加速度随之由主机四元数推导以保持一致
+        uint16_t sources = 0x0002 | 0x0004 | (ahrs_config_.use_mag ? 0x0008 : 0);
+        plan.derive_tag = subscribe_tag & (0x0001 | 0x0040);
+        plan.device_tag = (subscribe_tag & ~(0x0001 | 0x0020 | 0x0040)) | sources;
+    }
+    return plan;
+}
+
+void IMUReader::applyStreamFormat() {
+    // 根据上报频率设置丢帧检测的期望帧间隔
+    loss_detector_.setReportRate(report_rate_);
+    gyro_bias_.configure(gyro_bias_config_, loss_detector_.expectedPeriodMs());
+
+    // 帧间隔变化后重新计算积分步长
+    ahrs_has_last_ = false;
+    strapdown_has_last_ = false;
+
+    // 姿态外推的采样时刻：最小延迟到达时刻至少晚于采样时刻一帧的线路传输时间
+    prediction_latency_us_ = prediction_config_.latency_offset_us;
+    if (prediction_latency_us_ < 0) {
+        prediction_latency_us_ = static_cast<int>(
+            static_cast<int64_t>(sensorFrameBytes(derivation_.device_tag)) * 10 * 1000000 / baudrate_);
+    }
+}
+
+std::unique_ptr<Resampler> IMUReader::makeResampler(double input_rate) {
+    auto resampler = std::make_unique<Resampler>();
+    resampler->setCallback([this](const IMUData& data, uint64_t host_time_us) { deliverData(data, host_time_us); });
+    resampler->configure(resample_config_, input_rate);
+    return resampler;
+}
+
 bool IMUReader::start() {
     if (running_) {
         return true;
@@ -110,41 +314,70 @@ bool IMUReader::start() {
 
     // 打开串口
     if (!openSerial()) {
-        std::cerr << "打开串口失败" << std::endl;
+        LOG_ERROR("打开串口失败");
         return false;
     }
 
     // 配置IMU
     if (!configureIMU()) {
-        std::cerr << "配置IMU失败" << std::endl;
+        LOG_ERROR("配置IMU失败");
         return false;
     }
 
     // 唤醒传感器
     if (!wakeupSensor()) {
-        std::cerr << "唤醒传感器失败" << std::endl;
+        LOG_ERROR("唤醒传感器失败");
         return false;
     }
 
     // 启用主动上报
     if (!enableAutoReport()) {
-        std::cerr << "启用主动上报失败" << std::endl;
+        LOG_ERROR("启用主动上报失败");
         return false;
     }
 
-    if (debug_enabled_) {
-        std::cout << "IMU配置完成，等待数据..." << std::endl;
+    LOG_DEBUG("IMU配置完成，等待数据...");
+
+    // 锁定内存需在创建线程之前，使线程栈也被锁定
+    if (realtime_.lock_memory) {
+        lockProcessMemory();
     }
 
     running_ = true;
     reconnect_count_ = 0;
 
+    // 启动磁力计标定求解线程（需在读取线程之前）
+    if (mag_cal_config_.enabled) {
+        mag_calibrator_.start(mag_cal_config_);
+    }
+
+    // 启动振动频谱后台线程（需在读取线程之前）
+    if (vibration_config_.enabled) {
+        vibration_monitor_.start(vibration_config_, streamInputRate(report_rate_));
+    }
+
     // 启动读取线程
     read_thread_ = std::thread(&IMUReader::readThread, this);
 
     // 启动热拔插检测线程
     hotplug_thread_ = std::thread(&IMUReader::hotplugThread, this);
 
+    // 监视配置文件（失败不影响数据读取；多设备时由 IMUReaderSet 统一监视）
+    if (hot_reload_enabled_ && !config_file_.empty() && !managed_) {
+        config_watcher_.start(config_file_, hot_reload_debounce_ms_, [this] { reloadConfig(); });
+    }
+
+    // 启动指标服务（失败不影响数据读取；多设备时由 IMUReaderSet 统一提供）
+    if (metrics_enabled_ && !metrics_server_ && !managed_) {
+        metrics_server_ = std::make_unique<MetricsServer>();
+        metrics_server_->addReader(metrics_name_, this);
+        if (metrics_server_->start(metrics_bind_, metrics_port_)) {
+            LOG_INFO("指标服务已启动: http://{}:{}/metrics", metrics_bind_, metrics_port_);
+        } else {
+            metrics_server_.reset();
+        }
+    }
+
     return true;
 }
 
@@ -155,6 +388,19 @@ void IMUReader::stop() {
 
     running_ = false;
 
+    // 唤醒热拔插线程与等待重开的配置重载，再停止配置监视
+    {
+        std::lock_guard<std::mutex> lock(hotplug_mutex_);
+        hotplug_cv_.notify_all();
+    }
+    config_watcher_.stop();
+
+    // 先停止指标服务，避免抓取已停止的读取器
+    if (metrics_server_) {
+        metrics_server_->stop();
+        metrics_server_.reset();
+    }
+
     // 等待线程结束
     if (read_thread_.joinable()) {
         read_thread_.join();
@@ -164,23 +410,254 @@ void IMUReader::stop() {
     }
 
     closeSerial();
+    mag_calibrator_.stop();
+    vibration_monitor_.stop();
+
+    if (realtime_.jitter_report) {
+        logJitterReport();
+    }
+
+    // 保存陀螺零偏模型，下次启动时直接使用
+    if (gyro_bias_config_.enabled && !gyro_bias_config_.state_file.empty() && gyro_bias_.observations() > 0) {
+        gyro_bias_.save(gyro_bias_config_.state_file);
+    }
+
+    // 写出流水线跟踪数据（需以 IMU_ENABLE_TRACE 编译）
+    if (!trace_file_.empty()) {
+        Tracer::dump(trace_file_);
+    }
+
+    // 输出停止前积压的日志
+    AsyncLogger::flush();
 }
 
 void IMUReader::setDataCallback(IMUDataCallback callback) {
-    parser_->setDataCallback(callback);
+    data_callback_ = callback;
+}
+
+void IMUReader::setTimedDataCallback(IMUTimedDataCallback callback) {
+    timed_data_callback_ = callback;
+}
+
+void IMUReader::setGapCallback(IMUGapCallback callback) {
+    gap_callback_ = callback;
+}
+
+void IMUReader::onParsedData(const IMUData& data) {
+    // reconfigure() 发出命令后，在第一帧新格式数据处切换主机端状态
+    if (format_pending_.load(std::memory_order_acquire)) {
+        applyPendingFormat(data);
+    }
+
+    // 以帧完成时刻作为主机到达时间
+    jitter_monitor_.update(hostNowUs(), data.timestamp);
+
+    IMUGapEvent event;
+    bool has_event = loss_detector_.update(data.timestamp, event);
+    if (has_event) {
+        static const char* kTypeNames[] = {"丢帧", "重复帧", "乱序帧", "时间戳重置"};
+        if (event.type == IMUGapType::GAP) {
+            LOG_DEBUG("\n[调试] {}: {} -> {} ms (估计丢失 {} 帧)", kTypeNames[static_cast<int>(event.type)],
+                      event.prev_timestamp, event.timestamp, event.lost_samples);
+        } else {
+            LOG_DEBUG("\n[调试] {}: {} -> {} ms", kTypeNames[static_cast<int>(event.type)],
+                      event.prev_timestamp, event.timestamp);
+        }
+        if (gap_callback_) {
+            gap_callback_(event);
+        }
+        // 重复帧与乱序帧不再向下游发布，避免积分重复计入
+        if (event.type == IMUGapType::DUPLICATE || event.type == IMUGapType::REORDER) {
+            return;
+        }
+    }
+
+    // 振动频谱使用原始加速度；丢帧或时间戳重置后重新积累整帧，避免帧内拼接不连续的样本
+    if (vibration_config_.enabled) {
+        if (has_event && (event.type == IMUGapType::GAP || event.type == IMUGapType::RESET)) {
+            vibration_monitor_.restart();
+        }
+        vibration_monitor_.addSample(data);
+    }
+
+    // 主机端姿态融合与字段推导（融合状态需连续更新，与是否设置回调无关）
+    const IMUData* output = &data;
+    IMUData processed;
+    if (mag_cal_config_.enabled || gyro_bias_config_.enabled || ahrs_ || derivation_.derive_tag != 0) {
+        processed = data;
+        if (mag_cal_config_.enabled) {
+            mag_calibrator_.addSample(data);
+            mag_calibrator_.apply(processed);
+        }
+        if (gyro_bias_config_.enabled) {
+            gyro_bias_.update(data);
+            gyro_bias_.apply(processed);
+        }
+        if (ahrs_) {
+            updateAHRS(processed);
+        }
+        deriveFields(processed, derivation_.derive_tag);
+        output = &processed;
+    }
+
+    // 姿态外推使用最终输出的四元数（设备或主机融合）与修正后的角速度
+    if (prediction_config_.enabled) {
+        if (has_event && event.type == IMUGapType::RESET) {
+            predictor_.reset();
+        }
+        predictor_.update(*output, jitter_monitor_.hostTimeUs(output->timestamp) - prediction_latency_us_);
+    }
+
+    // 捷联积分使用零偏与标定修正后的数据
+    if (strapdown_config_.enabled) {
+        updateStrapdown(*output);
+    }
+
+    // 字段统计使用与回调相同的处理后数据（重采样前）
+    if (stats_config_.enabled) {
+        if (has_event && event.type == IMUGapType::RESET) {
+            field_stats_.reset();
+        }
+        field_stats_.update(*output);
+    }
+
+    // 重采样到固定输出频率，输出经回调进入 deliverData()
+    if (resample_config_.enabled) {
+        if (has_event && event.type == IMUGapType::RESET) {
+            resampler_->reset();
+        }
+        resampler_->push(*output, jitter_monitor_.hostTimeUs(output->timestamp));
+        return;
+    }
+
+    deliverData(*output, static_cast<uint64_t>(jitter_monitor_.hostTimeUs(output->timestamp)));
+}
+
+void IMUReader::deliverData(const IMUData& data, uint64_t host_time_us) {
+    if (data_callback_ || timed_data_callback_) {
+        IMU_TRACE_SCOPE("user_callback");
+        auto begin = std::chrono::steady_clock::now();
+        if (data_callback_) {
+            data_callback_(data);
+        }
+        if (timed_data_callback_) {
+            timed_data_callback_(data, host_time_us);
+        }
+        uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+
+        int bucket = 0;
+        while (bucket < CALLBACK_LATENCY_BUCKETS - 1 &&
+               elapsed_ns > CALLBACK_LATENCY_BOUNDS_US[bucket] * 1000ull) {
+            bucket++;
+        }
+        callback_latency_[bucket].fetch_add(1, std::memory_order_relaxed);
+        callback_latency_sum_ns_.fetch_add(elapsed_ns, std::memory_order_relaxed);
+    }
+}
+
+double IMUReader::integrationStep(bool& has_last, uint32_t& last_timestamp, uint32_t timestamp) const {
+    // 以期望周期的整数倍作为积分步长：设备时间戳只有 1ms 分辨率，
+    // 直接相减在 250Hz 下会有 ±25% 的步长抖动；丢帧时按丢失帧数放大步长
+    double period_s = loss_detector_.expectedPeriodMs() / 1000.0;
+    double dt = period_s;
+    if (has_last) {
+        int32_t delta_ms = static_cast<int32_t>(timestamp - last_timestamp);
+        long steps = std::lround(delta_ms / 1000.0 / period_s);
+        if (steps >= 1 && steps <= 100) {
+            dt = steps * period_s;
+        }
+    }
+    has_last = true;
+    last_timestamp = timestamp;
+    return dt;
+}
+
+void IMUReader::updateAHRS(IMUData& data) {
+    double dt = integrationStep(ahrs_has_last_, ahrs_last_timestamp_, data.timestamp);
+
+    Vec3f gyro{data.gyro_x * DEG_TO_RAD, data.gyro_y * DEG_TO_RAD, data.gyro_z * DEG_TO_RAD};
+    Vec3f accel{data.accel_with_gravity_x, data.accel_with_gravity_y, data.accel_with_gravity_z};
+    Vec3f mag{data.mag_x, data.mag_y, data.mag_z};
+    ahrs_->update(gyro, accel, ahrs_config_.use_mag ? &mag : nullptr, static_cast<float>(dt));
+
+    Quatf q = ahrs_->orientation();
+    data.quat_w = q.w;
+    data.quat_x = q.x;
+    data.quat_y = q.y;
+    data.quat_z = q.z;
+    data.subscribe_tag |= 0x0020;
+}
+
+void IMUReader::updateStrapdown(const IMUData& data) {
+    if ((data.subscribe_tag & 0x0006) != 0x0006) {
+        return;
+    }
+
+    // 初始化或外部请求重置：有四元数（设备输出或主机融合）时直接使用，否则按重力方向对准、航向为 0
+    if (strapdown_reset_pending_.exchange(false, std::memory_order_acquire) || !strapdown_.initialized()) {
+        Quatf attitude;
+        if (data.subscribe_tag & 0x0020) {
+            attitude = Quatf{data.quat_w, data.quat_x, data.quat_y, data.quat_z};
+        } else {
+            attitude = alignToGravity(Vec3f{data.accel_with_gravity_x, data.accel_with_gravity_y,
+                                            data.accel_with_gravity_z});
+        }
+        strapdown_.reset(attitude);
+        strapdown_has_last_ = false;
+    }
+
+    double dt = integrationStep(strapdown_has_last_, strapdown_last_timestamp_, data.timestamp);
+    strapdown_.update(strapdownSampleFromIMU(data, static_cast<float>(dt)));
+    navigation_.store(strapdown_.state());
+}
+
+uint64_t IMUReader::hostNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void IMUReader::logJitterReport() const {
+    JitterStats stats = jitter_monitor_.getStats();
+    const uint64_t* h = stats.histogram;
+    LOG_INFO("[调度抖动] 样本={} 平均={:.1f}us 最大={}us", stats.samples, stats.mean_us, stats.max_us);
+    LOG_INFO("  <=1ms(量化噪声):{} <=2ms:{} <=3ms:{} <=5ms:{}", h[0], h[1], h[2], h[3]);
+    LOG_INFO("  <=10ms:{} <=20ms:{} <=50ms:{} >50ms:{}", h[4], h[5], h[6], h[7]);
+}
+
+IMUReaderMetrics IMUReader::getMetrics() const {
+    IMUReaderMetrics metrics;
+    {
+        std::lock_guard<std::mutex> lock(port_mutex_);
+        metrics.port = port_;
+    }
+    metrics.baudrate = baudrate_;
+    metrics.report_rate = report_rate_;
+    metrics.running = running_;
+    metrics.connected = connected_;
+    metrics.reconnect_attempts = reconnect_count_;
+    metrics.reconnects = reconnects_.load(std::memory_order_relaxed);
+    metrics.rx_bytes = rx_bytes_.load(std::memory_order_relaxed);
+    metrics.parser = parser_->getStats();
+    metrics.loss = loss_detector_.getStats();
+    for (int i = 0; i < CALLBACK_LATENCY_BUCKETS; i++) {
+        metrics.callback_latency[i] = callback_latency_[i].load(std::memory_order_relaxed);
+    }
+    metrics.callback_latency_sum_ns = callback_latency_sum_ns_.load(std::memory_order_relaxed);
+    return metrics;
 }
 
 bool IMUReader::sendCommand(const U8* cmd, size_t len) {
-    std::lock_guard<std::mutex> lock(serial_mutex_);
-    
-    if (!connected_ || !serial_) {
+    // 只占用写锁，读取线程阻塞在 read() 时命令也能立即发出
+    std::shared_ptr<serial::Serial> port = acquirePort();
+    if (!connected_ || !port) {
         return false;
     }
 
     return IMUParser::packAndSend(const_cast<U8*>(cmd), len, device_address_,
-        [this](const U8* data, size_t len) -> int {
+        [&port](const U8* data, size_t len) -> int {
             try {
-                size_t written = serial_->write(data, len);
+                size_t written = port->write(data, len);
                 return (written == len) ? 0 : -1;
             } catch (...) {
                 return -1;
@@ -189,9 +666,23 @@ bool IMUReader::sendCommand(const U8* cmd, size_t len) {
 }
 
 bool IMUReader::configureIMU() {
+    if (derivation_.derive_tag != 0) {
+        LOG_DEBUG("  带宽优化: 需要 0x{:x}，设备订阅 0x{:x}，主机推导 0x{:x}",
+                  derivation_.requested_tag, derivation_.device_tag, derivation_.derive_tag);
+    }
+    if (!sendParameters(report_rate_, derivation_.device_tag)) {
+        return false;
+    }
+
+    usleep(200000);  // 等待200ms
+    LOG_DEBUG("IMU配置命令已发送 (report_rate={} Hz)", report_rate_);
+    return true;
+}
+
+bool IMUReader::sendParameters(int report_rate, uint16_t device_tag) {
     // 验证 report_rate 范围
-    if (report_rate_ < 0 || report_rate_ > 255) {
-        std::cerr << "错误: report_rate 超出范围 (0-255), 当前值: " << report_rate_ << std::endl;
+    if (report_rate < 0 || report_rate > 255) {
+        LOG_ERROR("错误: report_rate 超出范围 (0-255), 当前值: {}", report_rate);
         return false;
     }
     
@@ -202,184 +693,488 @@ bool IMUReader::configureIMU() {
     params[2] = 255;  // 静态归零速度
     params[3] = 0;  // 动态归零速度
     params[4] = ((barometer_filter_ & 3) << 1) | (compass_on_ ? 1 : 0);
-    params[5] = static_cast<U8>(report_rate_);  // 明确类型转换
+    params[5] = static_cast<U8>(report_rate);  // 明确类型转换
     params[6] = gyro_filter_;
     params[7] = acc_filter_;
     params[8] = compass_filter_;
-    params[9] = subscribe_tag_ & 0xFF;
-    params[10] = (subscribe_tag_ >> 8) & 0xFF;
-
-    // 计算数据包大小（根据订阅标签）
-    // 基础数据：命令头(1) + 订阅标签(2) + 时间戳(4) = 7字节
-    int data_packet_size = 7;
-    if (subscribe_tag_ & 0x0001) data_packet_size += 6;  // 加速度不含重力
-    if (subscribe_tag_ & 0x0002) data_packet_size += 6;  // 加速度含重力
-    if (subscribe_tag_ & 0x0004) data_packet_size += 6;  // 角速度
-    if (subscribe_tag_ & 0x0008) data_packet_size += 6;  // 磁力计
-    if (subscribe_tag_ & 0x0010) data_packet_size += 7;  // 温度气压高度
-    if (subscribe_tag_ & 0x0020) data_packet_size += 8;  // 四元数
-    if (subscribe_tag_ & 0x0040) data_packet_size += 6;  // 欧拉角
-    
-    // 完整数据包大小 = 前导码(50) + 包头(3) + 数据体 + 校验(1) + 包尾(1)
-    int full_packet_size = 50 + 3 + data_packet_size + 1 + 1;
-    
-    // 计算理论最大频率
-    // 115200 bps = 11520 字节/秒
-    double max_theoretical_rate = (baudrate_ / 10.0) / full_packet_size;
-    
-    if (debug_enabled_) {
-        std::cout << "  数据包大小分析:" << std::endl;
-        std::cout << "    数据体大小: " << data_packet_size << " 字节" << std::endl;
-        std::cout << "    完整包大小: " << full_packet_size << " 字节" << std::endl;
-        std::cout << "    理论最大频率: " << std::fixed << std::setprecision(1) 
-                  << max_theoretical_rate << " Hz" << std::endl;
-    }
-    
-    if (report_rate_ > max_theoretical_rate * 0.9) {  // 90%阈值
-        std::cerr << "警告: 配置的 report_rate=" << report_rate_ 
-                  << " Hz 可能超过当前波特率 " << baudrate_ 
-                  << " bps 的传输能力" << std::endl;
-        std::cerr << "      当前订阅标签 0x" << std::hex << subscribe_tag_ << std::dec
-                  << " 导致数据包大小为 " << full_packet_size << " 字节" << std::endl;
-        std::cerr << "      理论最大频率约 " << std::fixed << std::setprecision(1) 
-                  << max_theoretical_rate << " Hz" << std::endl;
-        std::cerr << "      建议:" << std::endl;
-        std::cerr << "        1. 降低 report_rate 到 " << (int)(max_theoretical_rate * 0.8) << " Hz 以下" << std::endl;
-        std::cerr << "        2. 减少订阅标签以减少数据包大小（当前: 0x" << std::hex << subscribe_tag_ << std::dec << "）" << std::endl;
-        std::cerr << "        3. 提高波特率（当前: " << baudrate_ << " bps）" << std::endl;
-        std::cerr << "      参考: Python示例使用 subscribe_tag=0x02 可达到250Hz" << std::endl;
+    params[9] = device_tag & 0xFF;
+    params[10] = (device_tag >> 8) & 0xFF;
+
+    // 根据订阅标签计算数据包大小与当前波特率下的理论最大频率（保留10%余量）
+    ThroughputPlan current = evaluateThroughput(device_tag, report_rate, baudrate_, 0.1);
+    int full_packet_size = current.frame_bytes;
+    double max_theoretical_rate = current.max_rate_hz;
+
+    LOG_DEBUG("  数据包大小分析:");
+    LOG_DEBUG("    数据体大小: {} 字节", sensorPayloadBytes(device_tag));
+    LOG_DEBUG("    完整包大小: {} 字节", full_packet_size);
+    LOG_DEBUG("    理论最大频率: {:.1f} Hz (余量 {:.0f}%)", max_theoretical_rate, current.headroom * 100);
+
+    if (!current.feasible) {
+        ThroughputPlan suggested = planBaudrate(device_tag, report_rate, 0.1);
+        LOG_WARN("警告: 配置的 report_rate={} Hz 可能超过当前波特率 {} bps 的传输能力", report_rate, baudrate_);
+        LOG_WARN("      当前订阅标签 0x{:x} 导致数据包大小为 {} 字节", device_tag, full_packet_size);
+        LOG_WARN("      理论最大频率约 {:.1f} Hz", max_theoretical_rate);
+        LOG_WARN("      建议:");
+        LOG_WARN("        1. 降低 report_rate 到 {} Hz 以下", (int)(max_theoretical_rate * 0.8));
+        LOG_WARN("        2. 减少订阅标签以减少数据包大小（当前: 0x{:x}）", device_tag);
+        LOG_WARN("        3. 提高波特率（当前: {} bps，建议: {} bps，余量 {:.0f}%）", baudrate_,
+                 suggested.baudrate, suggested.headroom * 100);
+        LOG_WARN("      参考: Python示例使用 subscribe_tag=0x02 可达到250Hz");
     }
     
-    if (debug_enabled_) {
-        std::cout << "发送IMU配置命令..." << std::endl;
-        std::cout << "  配置参数详情:" << std::endl;
-        std::cout << "    report_rate_ (int) = " << report_rate_ << std::endl;
-        std::cout << "    params[5] (U8) = " << (int)params[5] << " (0x" << std::hex << std::setw(2) << std::setfill('0') << (int)params[5] << std::dec << ")" << std::endl;
-        std::cout << "  完整命令包 (十六进制):" << std::endl;
-        std::cout << "    ";
-        for (int i = 0; i < 11; i++) {
-            std::cout << "0x" << std::hex << std::setw(2) << std::setfill('0') << (int)params[i] << std::dec << " ";
-            if ((i + 1) % 8 == 0) std::cout << std::endl << "    ";  // 每8个换行
-        }
-        std::cout << std::endl;
-        std::cout << "  其他参数: device_address=" << (int)device_address_ 
-                  << ", subscribe_tag=0x" << std::hex << subscribe_tag_ << std::dec << std::endl;
-    }
+    LOG_DEBUG("发送IMU配置命令...");
+    LOG_DEBUG("  配置参数详情:");
+    LOG_DEBUG("    report_rate (int) = {}", report_rate);
+    LOG_DEBUG("    params[5] (U8) = {} (0x{:02x})", params[5], params[5]);
+    LOG_DEBUG("  完整命令包 (十六进制):");
+    LOG_DEBUG("    0x{:02x} 0x{:02x} 0x{:02x} 0x{:02x} 0x{:02x} 0x{:02x} 0x{:02x} 0x{:02x}",
+              params[0], params[1], params[2], params[3], params[4], params[5], params[6], params[7]);
+    LOG_DEBUG("    0x{:02x} 0x{:02x} 0x{:02x}", params[8], params[9], params[10]);
+    LOG_DEBUG("  其他参数: device_address={}, subscribe_tag=0x{:x}", device_address_.load(), device_tag);
     if (!sendCommand(params, 11)) {
-        std::cerr << "发送配置命令失败" << std::endl;
+        LOG_ERROR("发送配置命令失败");
         return false;
     }
-
-    usleep(200000);  // 等待200ms
-    if (debug_enabled_) {
-        std::cout << "IMU配置命令已发送 (report_rate=" << report_rate_ << " Hz)" << std::endl;
-    }
     return true;
 }
 
 bool IMUReader::wakeupSensor() {
     U8 cmd[1] = {0x03};
-    if (debug_enabled_) {
-        std::cout << "唤醒传感器..." << std::endl;
-    }
+    LOG_DEBUG("唤醒传感器...");
     if (!sendCommand(cmd, 1)) {
-        std::cerr << "唤醒传感器命令发送失败" << std::endl;
+        LOG_ERROR("唤醒传感器命令发送失败");
         return false;
     }
     usleep(200000);  // 等待200ms
-    if (debug_enabled_) {
-        std::cout << "传感器已唤醒" << std::endl;
-    }
+    LOG_DEBUG("传感器已唤醒");
     return true;
 }
 
 bool IMUReader::enableAutoReport() {
     U8 cmd[1] = {0x19};
-    if (debug_enabled_) {
-        std::cout << "启用主动上报..." << std::endl;
-    }
+    LOG_DEBUG("启用主动上报...");
     if (!sendCommand(cmd, 1)) {
-        std::cerr << "启用主动上报命令发送失败" << std::endl;
+        LOG_ERROR("启用主动上报命令发送失败");
+        return false;
+    }
+    LOG_DEBUG("主动上报已启用");
+    return true;
+}
+
+bool IMUReader::reconfigure(const IMUReconfigureParams& params) {
+    std::lock_guard<std::mutex> lock(reconfigure_mutex_);
+    if (!running_ || !connected_) {
+        LOG_ERROR("重配置失败: 读取器未运行或串口未连接");
         return false;
     }
-    if (debug_enabled_) {
-        std::cout << "主动上报已启用" << std::endl;
+
+    const int old_rate = report_rate_;
+    const uint16_t old_tag = subscribe_tag_;
+    const uint16_t old_device_tag = derivation_.device_tag;
+    int report_rate = params.report_rate >= 0 ? params.report_rate : old_rate;
+    uint16_t subscribe_tag = params.subscribe_tag >= 0 ? static_cast<uint16_t>(params.subscribe_tag) : old_tag;
+    if (report_rate > 255) {
+        LOG_ERROR("错误: report_rate 超出范围 (0-255), 当前值: {}", report_rate);
+        return false;
     }
+    DerivationPlan derivation = planSubscription(subscribe_tag);
+
+    // 滤波参数随 0x12 命令一并下发，失败时恢复
+    const bool old_compass_on = compass_on_;
+    const int old_filters[4] = {barometer_filter_, gyro_filter_, acc_filter_, compass_filter_};
+    bool compass_on = params.compass_on >= 0 ? params.compass_on != 0 : old_compass_on;
+    int filters[4] = {
+        params.barometer_filter >= 0 ? params.barometer_filter : old_filters[0],
+        params.gyro_filter >= 0 ? params.gyro_filter : old_filters[1],
+        params.acc_filter >= 0 ? params.acc_filter : old_filters[2],
+        params.compass_filter >= 0 ? params.compass_filter : old_filters[3],
+    };
+    bool filters_changed = compass_on != old_compass_on || filters[0] != old_filters[0] ||
+                           filters[1] != old_filters[1] || filters[2] != old_filters[2] ||
+                           filters[3] != old_filters[3];
+    if (report_rate == old_rate && subscribe_tag == old_tag && !filters_changed) {
+        return true;
+    }
+    auto setFilters = [this](bool on, const int* values) {
+        compass_on_ = on;
+        barometer_filter_ = values[0];
+        gyro_filter_ = values[1];
+        acc_filter_ = values[2];
+        compass_filter_ = values[3];
+    };
+    setFilters(compass_on, filters);
+
+    // 数据格式不变，无需等待读取线程切换
+    if (report_rate == old_rate && subscribe_tag == old_tag) {
+        if (!sendParameters(report_rate, old_device_tag)) {
+            setFilters(old_compass_on, old_filters);
+            return false;
+        }
+        LOG_INFO("已更新滤波参数: compass_on={} barometer_filter={} gyro_filter={} acc_filter={} compass_filter={}",
+                 compass_on, filters[0], filters[1], filters[2], filters[3]);
+        return true;
+    }
+
+    // 与上报频率相关的缓冲在本线程按新频率分配，读取线程切换时只交换
+    std::unique_ptr<Resampler> resampler;
+    std::unique_ptr<FieldStatistics> field_stats;
+    if (report_rate != old_rate) {
+        resampler = makeResampler(streamInputRate(report_rate));
+        if (stats_config_.enabled) {
+            field_stats = std::make_unique<FieldStatistics>();
+            field_stats->configure(stats_config_, streamInputRate(report_rate));
+        }
+    }
+
+    // 先登记新格式再发命令，避免漏掉命令生效后的第一帧
+    {
+        std::lock_guard<std::mutex> format_lock(format_mutex_);
+        pending_format_ = PendingFormat();
+        pending_format_.report_rate = report_rate;
+        pending_format_.subscribe_tag = subscribe_tag;
+        pending_format_.derivation = derivation;
+        pending_format_.match_tag = derivation.device_tag != old_device_tag;
+        pending_format_.match_period = !pending_format_.match_tag && report_rate != old_rate;
+        pending_format_.resampler = std::move(resampler);
+        pending_format_.field_stats = std::move(field_stats);
+        format_switched_ = false;
+        format_pending_.store(true, std::memory_order_release);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    bool sent = sendParameters(report_rate, derivation.device_tag);
+
+    std::unique_lock<std::mutex> format_lock(format_mutex_);
+    bool switched = sent && format_cv_.wait_for(format_lock, std::chrono::milliseconds(params.timeout_ms),
+                                                [this] { return format_switched_; });
+    // 取回换下的旧对象（超时则是未使用的新对象），在本线程释放
+    resampler = std::move(pending_format_.resampler);
+    field_stats = std::move(pending_format_.field_stats);
+    if (!switched) {
+        format_pending_.store(false, std::memory_order_release);
+        format_lock.unlock();
+        setFilters(old_compass_on, old_filters);
+        if (sent) {
+            LOG_ERROR("重配置超时: {} ms 内未收到新格式数据，恢复原参数", params.timeout_ms);
+            sendParameters(old_rate, old_device_tag);
+        }
+        return false;
+    }
+    format_lock.unlock();
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    LOG_INFO("已重配置: report_rate {} -> {} Hz，订阅标签 0x{:x} -> 0x{:x}（设备订阅 0x{:x}），{} ms 后收到新格式数据",
+             old_rate, report_rate, old_tag, subscribe_tag, derivation.device_tag, elapsed_ms);
     return true;
 }
 
+bool IMUReader::reloadConfig() {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    if (!running_) {
+        LOG_ERROR("配置重载失败: 读取器未运行");
+        return false;
+    }
+
+    ConfigParser fresh;
+    if (!fresh.load(config_file_)) {
+        LOG_WARN("警告: 重新加载配置文件失败: {}，保持当前配置", config_file_);
+        return false;
+    }
+    std::vector<ConfigChange> changes = config_.diff(fresh);
+    if (changes.empty()) {
+        return true;
+    }
+
+    // 设备参数按解析后的取值比较（多设备时已含继承），在线下发或重开串口；其余节按键比较
+    IMUDeviceConfig device;
+    std::vector<std::string> errors;
+    bool parsed;
+    if (device_.name.empty()) {
+        parsed = parseDeviceConfig(fresh, device, errors);
+    } else {
+        std::vector<IMUDeviceConfig> devices;
+        parsed = parseDeviceConfigs(fresh, devices, errors);
+        auto it = std::find_if(devices.begin(), devices.end(),
+                               [this](const IMUDeviceConfig& d) { return d.name == device_.name; });
+        if (it == devices.end()) {
+            errors.push_back("[" + std::string(IMU_DEVICE_SECTION_PREFIX) + device_.name + "] 设备节已删除，需重启生效");
+            parsed = false;
+        } else {
+            device = *it;
+        }
+    }
+    if (!parsed) {
+        for (const std::string& error : errors) {
+            LOG_WARN("配置错误: {}", error);
+        }
+        LOG_WARN("警告: 配置无效，保持当前配置");
+        return false;
+    }
+
+    IMUReconfigureParams params;
+    bool device_changed = false;
+    auto setChanged = [&device_changed](int value, int current, int& target) {
+        if (value != current) {
+            target = value;
+            device_changed = true;
+        }
+    };
+    setChanged(device.report_rate, device_.report_rate, params.report_rate);
+    setChanged(device.subscribe_tag, device_.subscribe_tag, params.subscribe_tag);
+    setChanged(device.compass_on ? 1 : 0, device_.compass_on ? 1 : 0, params.compass_on);
+    setChanged(device.barometer_filter, device_.barometer_filter, params.barometer_filter);
+    setChanged(device.gyro_filter, device_.gyro_filter, params.gyro_filter);
+    setChanged(device.acc_filter, device_.acc_filter, params.acc_filter);
+    setChanged(device.compass_filter, device_.compass_filter, params.compass_filter);
+    bool serial_changed = device.port != device_.port || device.baudrate != device_.baudrate ||
+                          device.timeout != device_.timeout || device.device_address != device_.device_address;
+    SerialSettings serial;
+    serial.port = device.port;
+    // 配置文件未修改 baudrate 时沿用 switchBaudrate() 切换后的波特率，避免重开串口时退回旧值
+    serial.baudrate = device.baudrate != device_.baudrate ? device.baudrate : baudrate_.load();
+    serial.timeout = device.timeout;
+    serial.device_address = static_cast<U8>(device.device_address);
+
+    std::string restart_keys = device.host_derive != device_.host_derive ? "IMU.host_derive" : "";
+    bool log_level_changed = false;
+    const std::string prefix = IMU_DEVICE_SECTION_PREFIX;
+    for (const ConfigChange& change : changes) {
+        // 多设备时由 IMUReaderSet 统一输出，避免每个读取器重复
+        if (!managed_) {
+            LOG_INFO("配置变化: [{}] {} = {} -> {}", change.section, change.key, change.old_value, change.new_value);
+        }
+        if (change.section == "Serial" || change.section == "IMU" || change.section.compare(0, prefix.length(), prefix) == 0) {
+            continue;
+        }
+        if (change.section == "Debug" && (change.key == "log_level" || change.key == "debug_enabled")) {
+            log_level_changed = true;
+        } else if (!managed_) {
+            restart_keys += (restart_keys.empty() ? "" : ", ") + change.section + "." + change.key;
+        }
+    }
+
+    if (log_level_changed) {
+        bool debug_enabled = fresh.getBool("Debug", "debug_enabled", false);
+        AsyncLogger::setLevel(AsyncLogger::parseLevel(fresh.getString("Debug", "log_level"),
+                                                      debug_enabled ? LogLevel::DEBUG : LogLevel::INFO));
+    }
+
+    // 串口参数交给热拔插线程重开，避免与其重连流程并发；先于设备参数，使后者下发到新串口
+    bool ok = true;
+    if (serial_changed) {
+        std::unique_lock<std::mutex> hotplug_lock(hotplug_mutex_);
+        pending_serial_ = serial;
+        reopen_requested_ = true;
+        hotplug_cv_.notify_all();
+        // 重连最多等待设备文件 5 s，另留出稳定与配置下发的时间
+        hotplug_cv_.wait_for(hotplug_lock, std::chrono::seconds(10),
+                             [this] { return !reopen_requested_ || !running_; });
+        if (reopen_requested_ || !connected_) {
+            LOG_ERROR("按新串口参数重连失败: {} @ {} baud，热拔插线程将继续重试", serial.port, serial.baudrate);
+            ok = false;
+        }
+    }
+    if (ok && device_changed && !reconfigure(params)) {
+        ok = false;
+    }
+
+    if (!restart_keys.empty()) {
+        LOG_WARN("警告: 以下配置需重启生效: {}", restart_keys);
+    }
+
+    // 应用失败时保留旧配置，下次文件变化时重新比较并重试
+    if (ok) {
+        config_ = fresh;
+        device_ = device;
+        if (!managed_) {
+            LOG_INFO("配置已重新加载: {} 项变化", changes.size());
+        }
+    }
+    return ok;
+}
+
+void IMUReader::applyPendingFormat(const IMUData& data) {
+    std::unique_lock<std::mutex> lock(format_mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !format_pending_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    PendingFormat& pending = pending_format_;
+    if (pending.match_tag) {
+        if (data.subscribe_tag != pending.derivation.device_tag) {
+            return;
+        }
+    } else if (pending.match_period) {
+        // 帧间隔更接近新周期即认为已生效（设备时间戳精度 1ms）
+        double old_period = loss_detector_.expectedPeriodMs();
+        double new_period = pending.report_rate > 0 ? 1000.0 / pending.report_rate : 2000.0;
+        bool has_last = pending.has_last;
+        int32_t delta = static_cast<int32_t>(data.timestamp - pending.last_timestamp);
+        pending.has_last = true;
+        pending.last_timestamp = data.timestamp;
+        if (!has_last || std::fabs(delta - new_period) >= std::fabs(delta - old_period)) {
+            return;
+        }
+    }
+
+    report_rate_ = pending.report_rate;
+    subscribe_tag_ = pending.subscribe_tag;
+    derivation_ = pending.derivation;
+    applyStreamFormat();
+
+    // 频率变化时新的重采样器与统计窗口已由 reconfigure() 线程分配，这里只交换；否则仅清空历史
+    if (pending.resampler) {
+        resampler_.swap(pending.resampler);
+    } else {
+        resampler_->reset();
+    }
+    if (pending.field_stats) {
+        field_stats_.adopt(*pending.field_stats);
+    } else if (stats_config_.enabled) {
+        field_stats_.reset();
+    }
+    if (vibration_config_.enabled) {
+        vibration_monitor_.restart();
+        vibration_monitor_.setSampleRate(streamInputRate(pending.report_rate));
+    }
+    format_pending_.store(false, std::memory_order_relaxed);
+    format_switched_ = true;
+    lock.unlock();
+    format_cv_.notify_all();
+}
+
+bool IMUReader::switchBaudrate(int baudrate, const U8* device_cmd, size_t cmd_len, int verify_timeout_ms) {
+    std::shared_ptr<serial::Serial> port = acquirePort();
+    if (!connected_ || !port) {
+        return false;
+    }
+    int old_baudrate = baudrate_;
+    if (baudrate == old_baudrate) {
+        return true;
+    }
+
+    // 1. 以当前波特率通知设备切换
+    if (device_cmd != nullptr && cmd_len > 0) {
+        if (!sendCommand(device_cmd, cmd_len)) {
+            LOG_ERROR("发送设备波特率切换命令失败");
+            return false;
+        }
+        // 等待命令发送完毕（前导码 + 包头 + 数据 + 校验 + 包尾，每字节 10 bit）
+        int tx_ms = static_cast<int>((55 + cmd_len) * 10 * 1000 / old_baudrate) + 20;
+        std::this_thread::sleep_for(std::chrono::milliseconds(tx_ms));
+    }
+
+    // 2. 切换主机端波特率，读取线程在下一个字节前丢弃解析器中的半帧
+    try {
+        port->setBaudrate(static_cast<uint32_t>(baudrate));
+    } catch (const std::exception& e) {
+        LOG_ERROR("设置主机波特率 {} 失败: {}", baudrate, e.what());
+        return false;
+    }
+    baudrate_ = baudrate;
+    stream_reset_.fetch_or(STREAM_RESET_PARSER, std::memory_order_release);
+
+    // 3. 确认新波特率下能收到有效帧，否则回退
+    uint64_t frames_before = parser_->getStats().frames;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(verify_timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (parser_->getStats().frames > frames_before) {
+            LOG_INFO("波特率已切换: {} -> {} bps", old_baudrate, baudrate);
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    LOG_ERROR("切换到 {} bps 后未收到有效数据，恢复 {} bps", baudrate, old_baudrate);
+    try {
+        port->setBaudrate(static_cast<uint32_t>(old_baudrate));
+    } catch (...) {
+        // 忽略恢复时的异常，热拔插线程会处理后续异常
+    }
+    baudrate_ = old_baudrate;
+    stream_reset_.fetch_or(STREAM_RESET_PARSER, std::memory_order_release);
+    return false;
+}
+
 bool IMUReader::openSerial() {
-    std::lock_guard<std::mutex> lock(serial_mutex_);
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
 
     // 先检查设备文件是否存在
     struct stat file_stat;
     if (stat(port_.c_str(), &file_stat) != 0) {
         // 设备文件不存在
-        std::cerr << "设备文件不存在: " << port_ << std::endl;
+        LOG_ERROR("设备文件不存在: {}", port_);
         connected_ = false;
         return false;
     }
 
     try {
-        // 如果串口已经打开，先关闭并释放
-        if (serial_) {
-            try {
-                if (serial_->isOpen()) {
-                    serial_->close();
-                }
-            } catch (...) {
-                // 忽略关闭时的异常
-            }
-            serial_.reset();
-        }
+        // 如果串口已经打开，先摘除旧句柄
+        detachPort(acquirePort());
 
         // 等待一小段时间，确保设备完全就绪
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-        serial_ = std::make_unique<serial::Serial>(
-            port_,
-            baudrate_,
-            serial::Timeout::simpleTimeout(timeout_)
-        );
+        // 最后一个持有者释放时关闭串口，避免在其他线程读写过程中关闭文件描述符
+        std::shared_ptr<serial::Serial> port(
+            new serial::Serial(port_, baudrate_, serial::Timeout::simpleTimeout(timeout_)),
+            [](serial::Serial* s) {
+                try {
+                    if (s->isOpen()) {
+                        s->close();
+                    }
+                } catch (...) {
+                    // 忽略关闭时的异常
+                }
+                delete s;
+            });
 
-        if (serial_->isOpen()) {
+        if (port->isOpen()) {
+            std::atomic_store(&serial_, port);
+            port_generation_.fetch_add(1, std::memory_order_release);
             connected_ = true;
-            std::cout << "串口打开成功: " << port_ << std::endl;
+            LOG_INFO("串口打开成功: {}", port_);
             return true;
         } else {
-            std::cerr << "串口打开失败: " << port_ << " (isOpen()返回false)" << std::endl;
+            LOG_ERROR("串口打开失败: {} (isOpen()返回false)", port_);
         }
     } catch (const std::exception& e) {
-        std::cerr << "打开串口异常: " << e.what() << std::endl;
+        LOG_ERROR("打开串口异常: {}", e.what());
     }
 
     connected_ = false;
-    if (serial_) {
-        serial_.reset();
-    }
     return false;
 }
 
 void IMUReader::closeSerial() {
-    std::lock_guard<std::mutex> lock(serial_mutex_);
-    
-    if (serial_ && serial_->isOpen()) {
-        serial_->close();
-    }
-    serial_.reset();
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    detachPort(acquirePort());
     connected_ = false;
 }
 
+void IMUReader::detachPort(const std::shared_ptr<serial::Serial>& port) {
+    if (!port) {
+        return;
+    }
+    std::shared_ptr<serial::Serial> expected = port;
+    if (std::atomic_compare_exchange_strong(&serial_, &expected, std::shared_ptr<serial::Serial>())) {
+        port_generation_.fetch_add(1, std::memory_order_release);
+        connected_ = false;
+    }
+}
+
 bool IMUReader::reconnect() {
     if (max_reconnect_ > 0 && reconnect_count_ >= max_reconnect_) {
-        std::cerr << "达到最大重连次数" << std::endl;
+        LOG_ERROR("达到最大重连次数");
         return false;
     }
 
     closeSerial();
     reconnect_count_++;
 
-    std::cout << "尝试重连 (" << reconnect_count_ << ")..." << std::endl;
+    LOG_INFO("尝试重连 ({})...", reconnect_count_.load());
 
     // 等待设备就绪（检查设备文件是否存在）
     int wait_count = 0;
@@ -400,20 +1195,24 @@ bool IMUReader::reconnect() {
         return false;
     }
 
+    // 解析器与时间戳状态只由读取线程访问：在新句柄发布前置位，读取线程取得新句柄后、
+    // 处理第一个字节前执行重置
+    stream_reset_.fetch_or(STREAM_RESET_PARSER | STREAM_RESET_TIMING, std::memory_order_release);
     if (openSerial()) {
         reconnect_count_ = 0;
-        parser_->reset();  // 重置解析器状态
+        reconnects_.fetch_add(1, std::memory_order_relaxed);
 
         // 等待串口稳定
         std::this_thread::sleep_for(std::chrono::milliseconds(300));
 
-        // 重新配置
+        // 重新配置（与 reconfigure() 互斥，避免下发切换中的参数）
+        std::unique_lock<std::mutex> config_lock(reconfigure_mutex_);
         if (configureIMU() && wakeupSensor() && enableAutoReport()) {
-            std::cout << "重连成功并重新配置" << std::endl;
+            LOG_INFO("重连成功并重新配置");
             return true;
         } else {
             // 配置失败，关闭串口
-            std::cerr << "重连后配置失败" << std::endl;
+            LOG_ERROR("重连后配置失败");
             closeSerial();
         }
     }
@@ -421,15 +1220,44 @@ bool IMUReader::reconnect() {
     return false;
 }
 
+void IMUReader::reopenSerial() {
+    SerialSettings settings;
+    {
+        std::lock_guard<std::mutex> lock(hotplug_mutex_);
+        settings = pending_serial_;
+    }
+    LOG_INFO("串口参数变化，重新打开串口: {} @ {} baud (设备地址 {})", settings.port, settings.baudrate,
+             settings.device_address);
+
+    // 先关闭旧串口再替换参数，读取线程在句柄摘除后不再访问旧端口
+    closeSerial();
+    {
+        std::lock_guard<std::mutex> lock(port_mutex_);
+        port_ = settings.port;
+    }
+    baudrate_ = settings.baudrate;
+    timeout_ = settings.timeout;
+    device_address_ = settings.device_address;
+
+    // 快速重连：设备文件仍在时只等待串口稳定，随后按当前参数重新配置设备
+    reconnect_count_ = 0;
+    reconnect();
+
+    {
+        std::lock_guard<std::mutex> lock(hotplug_mutex_);
+        reopen_requested_ = false;
+    }
+    hotplug_cv_.notify_all();
+}
+
 int IMUReader::sendPacket(const U8* data, size_t len) {
-    std::lock_guard<std::mutex> lock(serial_mutex_);
-    
-    if (!connected_ || !serial_) {
+    std::shared_ptr<serial::Serial> port = acquirePort();
+    if (!connected_ || !port) {
         return -1;
     }
 
     try {
-        size_t written = serial_->write(data, len);
+        size_t written = port->write(data, len);
         return (written == len) ? 0 : -1;
     } catch (...) {
         return -1;
@@ -437,54 +1265,84 @@ int IMUReader::sendPacket(const U8* data, size_t len) {
 }
 
 void IMUReader::readThread() {
+    applyThreadRealTime(realtime_.read_thread, realtime_.prefault_stack_kb, "读取线程");
+
     U8 byte;
     size_t bytes_read = 0;
-    size_t total_bytes = 0;
-    std::chrono::steady_clock::time_point last_print_time;
-    if (debug_enabled_) {
-        last_print_time = std::chrono::steady_clock::now();
-    }
+    // 缓存的串口句柄，仅在句柄代数变化时重新获取，避免每字节的原子 shared_ptr 读取
+    std::shared_ptr<serial::Serial> port;
+    uint32_t port_generation = port_generation_.load(std::memory_order_acquire) - 1;
+    uint64_t last_print_bytes = 0;
+    std::chrono::steady_clock::time_point last_print_time = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_jitter_time = last_print_time;
 
     while (running_) {
-        {
-            std::lock_guard<std::mutex> lock(serial_mutex_);
-            
-            if (!connected_ || !serial_ || !serial_->isOpen()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
-            }
+        uint32_t generation = port_generation_.load(std::memory_order_acquire);
+        if (generation != port_generation) {
+            port = acquirePort();
+            port_generation = generation;
+        }
 
-            try {
-                bytes_read = serial_->read(&byte, 1);
-            } catch (const std::exception& e) {
-                // 读取异常，关闭串口并标记为断开，让热插拔线程处理重连
-                std::cerr << "读取串口异常: " << e.what() << std::endl;
-                try {
-                    if (serial_ && serial_->isOpen()) {
-                        serial_->close();
-                    }
-                } catch (...) {
-                    // 忽略关闭时的异常
+        if (!connected_ || !port || !port->isOpen()) {
+            port.reset();  // 释放旧句柄，使其尽快关闭
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        if (stream_reset_.load(std::memory_order_relaxed) != 0) {
+            uint32_t reset = stream_reset_.exchange(0, std::memory_order_acquire);
+            if (reset & STREAM_RESET_PARSER) {
+                parser_->reset();
+            }
+            if (reset & STREAM_RESET_TIMING) {
+                loss_detector_.resync();
+                jitter_monitor_.resync();
+                // 重连期间的样本已丢失，设备也可能已重启，振动帧与统计窗口都不能跨越断开
+                if (vibration_config_.enabled) {
+                    vibration_monitor_.restart();
+                }
+                if (stats_config_.enabled) {
+                    field_stats_.reset();
                 }
-                connected_ = false;
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
             }
         }
 
+        try {
+            IMU_TRACE_SCOPE("serial_read");
+            bytes_read = port->read(&byte, 1);
+        } catch (const std::exception& e) {
+            // 读取异常，摘除句柄并标记为断开，让热插拔线程处理重连
+            LOG_ERROR("读取串口异常: {}", e.what());
+            detachPort(port);
+            port.reset();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
         if (bytes_read > 0) {
-            total_bytes += bytes_read;
+            rx_bytes_.fetch_add(bytes_read, std::memory_order_relaxed);
             parser_->processByte(byte);
             
-            // 每5秒打印一次接收统计（仅用于调试）
-            if (debug_enabled_) {
+            // 每5秒打印一次接收统计（仅用于调试，可在运行时通过日志等级开启）
+            if (AsyncLogger::enabled(LogLevel::DEBUG)) {
                 auto now = std::chrono::steady_clock::now();
                 if (std::chrono::duration_cast<std::chrono::seconds>(now - last_print_time).count() >= 5) {
-                    std::cout << "\n[调试] 已接收 " << total_bytes << " 字节 (速率: " 
-                              << (total_bytes * 8 / 5) << " 字节/秒)" << std::endl;
+                    uint64_t total_bytes = rx_bytes_.load(std::memory_order_relaxed);
+                    LOG_DEBUG("\n[调试] 已接收 {} 字节 (速率: {} 字节/秒)", total_bytes,
+                              (total_bytes - last_print_bytes) / 5);
+                    last_print_bytes = total_bytes;
                     last_print_time = now;
                 }
             }
+
+            // 每10秒输出一次调度抖动报告
+            if (realtime_.jitter_report) {
+                auto now = std::chrono::steady_clock::now();
+                if (now - last_jitter_time >= std::chrono::seconds(10)) {
+                    logJitterReport();
+                    last_jitter_time = now;
+                }
+            }
         } else {
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
@@ -492,10 +1350,27 @@ void IMUReader::readThread() {
 }
 
 void IMUReader::hotplugThread() {
+    applyThreadRealTime(realtime_.hotplug_thread, realtime_.prefault_stack_kb, "热拔插线程");
+
     bool last_device_state = false;
     
     while (running_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(check_interval_));
+        // 可被配置热重载的重开请求或 stop() 提前唤醒
+        bool reopen = false;
+        {
+            std::unique_lock<std::mutex> lock(hotplug_mutex_);
+            hotplug_cv_.wait_for(lock, std::chrono::milliseconds(check_interval_),
+                                 [this] { return reopen_requested_ || !running_; });
+            reopen = reopen_requested_;
+        }
+        if (!running_) {
+            break;
+        }
+        if (reopen) {
+            reopenSerial();
+            last_device_state = connected_;
+            continue;
+        }
 
         bool need_reconnect = false;
         bool device_exists = false;
@@ -507,10 +1382,11 @@ void IMUReader::hotplugThread() {
         }
 
         {
-            std::lock_guard<std::mutex> lock(serial_mutex_);
-            
+            // 不加锁：只持有句柄副本，available() 只是一次 ioctl，不占用读锁
+            std::shared_ptr<serial::Serial> port = acquirePort();
+
             // 检查连接状态
-            bool is_connected = connected_ && serial_ && serial_->isOpen();
+            bool is_connected = connected_ && port && port->isOpen();
             
             if (!is_connected) {
                 // 未连接状态
@@ -524,34 +1400,21 @@ void IMUReader::hotplugThread() {
                     // 设备文件不存在，说明设备已拔出
                     connected_ = false;
                     if (last_device_state) {
-                        std::cout << "检测到设备拔出: " << port_ << std::endl;
-                    }
-                    // 关闭串口
-                    try {
-                        if (serial_ && serial_->isOpen()) {
-                            serial_->close();
-                        }
-                    } catch (...) {
-                        // 忽略关闭时的异常
+                        LOG_INFO("检测到设备拔出: {}", port_);
                     }
+                    // 摘除句柄，读取线程释放副本后串口关闭
+                    detachPort(port);
                 } else {
                     // 设备存在，检查串口是否仍然可用
                     try {
                         // 尝试读取可用字节数来检测连接
-                        size_t available = serial_->available();
+                        port->available();
                         // 如果读取失败，说明连接断开
                     } catch (...) {
                         need_reconnect = true;
                         connected_ = false;
-                        std::cout << "检测到串口异常，尝试重连..." << std::endl;
-                        // 关闭串口
-                        try {
-                            if (serial_ && serial_->isOpen()) {
-                                serial_->close();
-                            }
-                        } catch (...) {
-                            // 忽略关闭时的异常
-                        }
+                        LOG_WARN("检测到串口异常，尝试重连...");
+                        detachPort(port);
                     }
                 }
             }
@@ -559,7 +1422,7 @@ void IMUReader::hotplugThread() {
 
         // 检测设备重新插入（从不存在变为存在）
         if (!last_device_state && device_exists && !connected_) {
-            std::cout << "检测到设备重新插入: " << port_ << std::endl;
+            LOG_INFO("检测到设备重新插入: {}", port_);
             need_reconnect = true;
         }
 
@@ -571,7 +1434,7 @@ void IMUReader::hotplugThread() {
                 continue;
             }
             
-            std::cout << "尝试重连..." << std::endl;
+            LOG_INFO("尝试重连...");
             
             int retry_count = 0;
             while (running_ && !reconnect()) {
@@ -580,13 +1443,13 @@ void IMUReader::hotplugThread() {
                 struct stat file_stat;
                 if (stat(port_.c_str(), &file_stat) != 0) {
                     // 设备又拔出了，停止重连尝试
-                    std::cout << "重连过程中设备拔出，停止重连" << std::endl;
+                    LOG_INFO("重连过程中设备拔出，停止重连");
                     break;
                 }
                 
                 // 每5次重连尝试输出一次提示
                 if (retry_count % 5 == 0) {
-                    std::cout << "重连中... (已尝试 " << retry_count << " 次)" << std::endl;
+                    LOG_INFO("重连中... (已尝试 {} 次)", retry_count);
                 }
                 
                 std::this_thread::sleep_for(std::chrono::milliseconds(reconnect_interval_));
@@ -0,0 +1,155 @@
+/**
+ * @file imu_reader_set.cpp
+ * @brief 多设备读取器集合实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   读取器以 unique_ptr 保存，地址在集合生命周期内不变，可直接交给 VirtualIMU::attach()
+ *   与 MetricsServer::addReader()。停止时先停配置监视与指标服务，再逐个停止读取器。
+ */
+#include "imu_reader_set.h"
+#include "async_logger.h"
+#include "metrics_server.h"
+
+IMUReaderSet::IMUReaderSet() {
+}
+
+IMUReaderSet::~IMUReaderSet() {
+    stop();
+}
+
+bool IMUReaderSet::initialize(const std::string& config_file) {
+    stop();
+    readers_.clear();
+    devices_.clear();
+    errors_.clear();
+    config_ = ConfigParser();
+
+    if (!config_.load(config_file)) {
+        LOG_ERROR("加载配置文件失败: {}", config_file);
+        return false;
+    }
+    config_file_ = config_file;
+
+    if (!parseDeviceConfigs(config_, devices_, errors_)) {
+        for (const std::string& error : errors_) {
+            LOG_ERROR("配置错误: {}", error);
+        }
+        LOG_ERROR("配置校验失败: {} 处错误", errors_.size());
+        devices_.clear();
+        return false;
+    }
+
+    readers_.reserve(devices_.size());
+    for (const IMUDeviceConfig& device : devices_) {
+        auto reader = std::make_unique<IMUReader>();
+        if (!reader->initialize(config_file_, config_, device)) {
+            LOG_ERROR("初始化设备失败: {}", device.name.empty() ? device.port : device.name);
+            readers_.clear();
+            return false;
+        }
+        readers_.push_back(std::move(reader));
+    }
+    LOG_INFO("已加载 {} 个设备配置: {}", devices_.size(), config_file_);
+    return true;
+}
+
+IMUReader* IMUReaderSet::find(const std::string& name) {
+    for (size_t i = 0; i < devices_.size(); i++) {
+        if (devices_[i].name == name) {
+            return readers_[i].get();
+        }
+    }
+    return nullptr;
+}
+
+bool IMUReaderSet::start() {
+    bool ok = true;
+    for (size_t i = 0; i < readers_.size(); i++) {
+        if (!readers_[i]->start()) {
+            LOG_ERROR("设备启动失败: {} ({})", devices_[i].name, devices_[i].port);
+            ok = false;
+        }
+    }
+
+    // 启动统一的指标服务（失败不影响数据读取）
+    if (config_.getBool("Metrics", "enabled", false) && !metrics_server_) {
+        std::string bind_address = config_.getString("Metrics", "bind_address", "127.0.0.1");
+        int port = config_.getInt("Metrics", "port", 9464);
+        metrics_server_ = std::make_unique<MetricsServer>();
+        for (size_t i = 0; i < readers_.size(); i++) {
+            metrics_server_->addReader(devices_[i].name.empty() ? devices_[i].port : devices_[i].name,
+                                       readers_[i].get());
+        }
+        if (metrics_server_->start(bind_address, port)) {
+            LOG_INFO("指标服务已启动: http://{}:{}/metrics ({} 个设备)", bind_address, port, readers_.size());
+        } else {
+            metrics_server_.reset();
+        }
+    }
+
+    // 监视配置文件（失败不影响数据读取）
+    if (config_.getBool("HotReload", "enabled", false) && !config_watcher_.running()) {
+        config_watcher_.start(config_file_, config_.getInt("HotReload", "debounce_ms", 200),
+                              [this] { reloadConfig(); });
+    }
+    return ok;
+}
+
+void IMUReaderSet::stop() {
+    config_watcher_.stop();
+    if (metrics_server_) {
+        metrics_server_->stop();
+        metrics_server_.reset();
+    }
+    for (auto& reader : readers_) {
+        reader->stop();
+    }
+}
+
+void IMUReaderSet::reloadConfig() {
+    ConfigParser fresh;
+    if (!fresh.load(config_file_)) {
+        LOG_WARN("警告: 重新加载配置文件失败: {}，保持当前配置", config_file_);
+        return;
+    }
+    std::vector<ConfigChange> changes = config_.diff(fresh);
+    if (changes.empty()) {
+        return;
+    }
+
+    // 设备节与日志等级由各读取器应用；新增或删除设备、其他节的变化需重启
+    const std::string prefix = IMU_DEVICE_SECTION_PREFIX;
+    std::string restart_keys;
+    for (const ConfigChange& change : changes) {
+        LOG_INFO("配置变化: [{}] {} = {} -> {}", change.section, change.key, change.old_value, change.new_value);
+        bool device_key = change.section == "Serial" || change.section == "IMU" ||
+                          change.section.compare(0, prefix.length(), prefix) == 0;
+        bool log_key = change.section == "Debug" && (change.key == "log_level" || change.key == "debug_enabled");
+        if (!device_key && !log_key) {
+            restart_keys += (restart_keys.empty() ? "" : ", ") + change.section + "." + change.key;
+        }
+    }
+    for (const std::string& section : fresh.sections()) {
+        if (section.compare(0, prefix.length(), prefix) == 0 && !config_.section(section)) {
+            restart_keys += (restart_keys.empty() ? "" : ", ") + section;
+        }
+    }
+    if (!restart_keys.empty()) {
+        LOG_WARN("警告: 以下配置需重启生效: {}", restart_keys);
+    }
+
+    int failed = 0;
+    for (auto& reader : readers_) {
+        if (reader->isRunning() && !reader->reloadConfig()) {
+            failed++;
+        }
+    }
+    if (failed == 0) {
+        config_ = fresh;
+        LOG_INFO("配置已重新加载: {} 项变化", changes.size());
+    } else {
+        LOG_WARN("警告: {} 个设备应用新配置失败，下次保存时重试", failed);
+    }
+}
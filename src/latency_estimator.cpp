@@ -0,0 +1,326 @@
+/**
+ * @file latency_estimator.cpp
+ * @brief 多 IMU 间相对延迟的互相关估计实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   互相关在 2·window 点上做（补零避免循环卷绕），RealFFT 的逆变换已除以 n，
+ *   结果即线性相关 Σ x[n]·y[n+τ]；归一化相关峰为 r(τ) / sqrt(Σx²·Σy²)，
+ *   Σy² 取与参考序列对齐的那一段。
+ *   峰值落在搜索边界上说明真实延迟超出 max_lag，该次测量放弃。
+ *   延迟修正 offset = -delay（参考设备为 0），变化超过 100us 才通过回调更新，
+ *   避免频繁的微小修正；修正变小会让虚拟 IMU 丢弃一两个时间回退的样本。
+ */
+#include "latency_estimator.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// 后台线程取出队列的周期（1 kHz 时约 50 个样本，远小于队列长度）
+constexpr int LATENCY_DRAIN_MS = 50;
+
+// 修正量变化超过该值才更新
+constexpr int64_t LATENCY_APPLY_STEP_US = 100;
+
+LatencyEstimator::LatencyEstimator()
+    : device_count_(0)
+    , period_us_(5000.0)
+    , max_lag_(0)
+    , max_gap_us_(0)
+    , applied_offset_us_{}
+    , running_(false) {
+}
+
+LatencyEstimator::~LatencyEstimator() {
+    stop();
+}
+
+bool LatencyEstimator::start(const LatencyEstimatorConfig& config, int device_count) {
+    stop();
+    if (config.window < 64 || !RealFFT::isPowerOfTwo(config.window)) {
+        LOG_ERROR("延迟估计 window 必须为不小于 64 的 2 的幂: {}", config.window);
+        return false;
+    }
+    if (config.sample_rate <= 0.0) {
+        LOG_ERROR("延迟估计采样率无效");
+        return false;
+    }
+    if (device_count < 2 || device_count > LATENCY_MAX_DEVICES) {
+        LOG_ERROR("延迟估计需要 2 到 {} 个设备: {}", LATENCY_MAX_DEVICES, device_count);
+        return false;
+    }
+    if (config.reference < 0 || config.reference >= device_count) {
+        LOG_ERROR("延迟估计参考设备无效: {}", config.reference);
+        return false;
+    }
+
+    config_ = config;
+    config_.smoothing = std::min(std::max(config.smoothing, 0.01f), 1.0f);
+    device_count_ = device_count;
+    period_us_ = 1e6 / config.sample_rate;
+    // 峰值两侧各需一点做插值，搜索范围不超过窗口的 1/4（参考序列至少保留半个窗口）
+    max_lag_ = std::min(static_cast<int>(config.max_lag_ms * 1000.0 / period_us_), config.window / 4);
+    max_lag_ = std::max(max_lag_, 2);
+    max_gap_us_ = std::max<int64_t>(100000, static_cast<int64_t>(4 * period_us_));
+
+    // 所有缓冲在读取线程运行前一次分配
+    const int n = 2 * config.window;
+    for (int d = 0; d < LATENCY_MAX_DEVICES; d++) {
+        queues_[d].head = 0;
+        queues_[d].tail = 0;
+        queues_[d].dropped = 0;
+        series_[d] = Series();
+        if (d < device_count_) {
+            series_[d].grid.assign(n, 0.0f);
+        }
+        state_[d] = LatencyEstimate();
+        applied_offset_us_[d] = 0;
+        estimates_[d].store(state_[d]);
+    }
+    state_[config_.reference].valid = true;
+    estimates_[config_.reference].store(state_[config_.reference]);
+
+    fft_.reset(new RealFFT(n));
+    x_.assign(n, 0.0f);
+    y_.assign(n, 0.0f);
+    r_.assign(n, 0.0f);
+    spectrum_x_.resize(n / 2 + 1);
+    spectrum_y_.resize(n / 2 + 1);
+    prefix_x_.assign(config.window + 1, Prefix());
+    prefix_y_.assign(config.window + 1, Prefix());
+    rho_.assign(2 * max_lag_ + 1, 0.0);
+
+    LOG_INFO("相对延迟估计: {} 个设备 网格={:.1f} Hz 窗口={:.2f} s 搜索范围=±{:.1f} ms", device_count_,
+             config_.sample_rate, config_.window * period_us_ / 1e6, max_lag_ * period_us_ / 1000.0);
+
+    running_ = true;
+    worker_thread_ = std::thread(&LatencyEstimator::workerThread, this);
+    return true;
+}
+
+void LatencyEstimator::stop() {
+    if (!running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        running_ = false;
+    }
+    stop_cv_.notify_one();
+    if (worker_thread_.joinable()) {
+        worker_thread_.join();
+    }
+}
+
+void LatencyEstimator::push(int device, const IMUData& data, uint64_t host_time_us) {
+    if (!running_.load(std::memory_order_relaxed) || device < 0 || device >= device_count_ ||
+        !(data.subscribe_tag & 0x0004)) {
+        return;
+    }
+    Queue& queue = queues_[device];
+    uint64_t head = queue.head.load(std::memory_order_relaxed);
+    if (head - queue.tail.load(std::memory_order_acquire) >= LATENCY_RING) {
+        queue.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Sample& sample = queue.ring[head & (LATENCY_RING - 1)];
+    sample.time_us = static_cast<int64_t>(host_time_us);
+    sample.value = std::sqrt(data.gyro_x * data.gyro_x + data.gyro_y * data.gyro_y + data.gyro_z * data.gyro_z);
+    queue.head.store(head + 1, std::memory_order_release);
+}
+
+LatencyEstimate LatencyEstimator::estimate(int device) const {
+    if (device < 0 || device >= LATENCY_MAX_DEVICES) {
+        return LatencyEstimate();
+    }
+    LatencyEstimate result = estimates_[device].load();
+    result.dropped = queues_[device].dropped.load(std::memory_order_relaxed);
+    return result;
+}
+
+void LatencyEstimator::workerThread() {
+    auto last_estimate = std::chrono::steady_clock::now();
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stop_mutex_);
+            stop_cv_.wait_for(lock, std::chrono::milliseconds(LATENCY_DRAIN_MS), [this] { return !running_; });
+            if (!running_) {
+                return;
+            }
+        }
+
+        for (int d = 0; d < device_count_; d++) {
+            drain(d);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_estimate < std::chrono::milliseconds(config_.interval_ms)) {
+            continue;
+        }
+        last_estimate = now;
+
+        for (int d = 0; d < device_count_; d++) {
+            if (d == config_.reference) {
+                continue;
+            }
+            LatencyEstimate& state = state_[d];
+            double delay_us;
+            float correlation;
+            if (!measure(d, delay_us, correlation)) {
+                state.rejected++;
+                estimates_[d].store(state);
+                continue;
+            }
+
+            bool first = !state.valid;
+            state.delay_us = first ? delay_us : state.delay_us + config_.smoothing * (delay_us - state.delay_us);
+            state.last_delay_us = delay_us;
+            state.correlation = correlation;
+            state.valid = true;
+            state.estimates++;
+            estimates_[d].store(state);
+
+            int64_t offset_us = -static_cast<int64_t>(std::llround(state.delay_us));
+            if (first) {
+                LOG_INFO("设备 {} 相对设备 {} 的延迟: {:.2f} ms (相关峰 {:.3f})", d, config_.reference,
+                         delay_us / 1000.0, correlation);
+            }
+            if (offset_callback_ && (first || std::llabs(offset_us - applied_offset_us_[d]) >= LATENCY_APPLY_STEP_US)) {
+                applied_offset_us_[d] = offset_us;
+                offset_callback_(d, offset_us);
+            }
+        }
+    }
+}
+
+void LatencyEstimator::drain(int device) {
+    Queue& queue = queues_[device];
+    Series& series = series_[device];
+    const int64_t capacity = static_cast<int64_t>(series.grid.size());
+
+    uint64_t tail = queue.tail.load(std::memory_order_relaxed);
+    uint64_t head = queue.head.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        const Sample& sample = queue.ring[tail & (LATENCY_RING - 1)];
+        if (series.has_last && sample.time_us <= series.last_time_us) {
+            continue;
+        }
+        if (series.has_last && sample.time_us - series.last_time_us > max_gap_us_) {
+            // 中断过久（断开重连等），重新积累
+            series.count = 0;
+        } else if (series.has_last) {
+            // 落在 (last_time, time] 内的网格点线性插值
+            int64_t k = static_cast<int64_t>(std::floor(series.last_time_us / period_us_)) + 1;
+            int64_t last_k = static_cast<int64_t>(std::floor(sample.time_us / period_us_));
+            double span = static_cast<double>(sample.time_us - series.last_time_us);
+            for (; k <= last_k; k++) {
+                double frac = (k * period_us_ - series.last_time_us) / span;
+                float value = series.last_value + static_cast<float>(frac) * (sample.value - series.last_value);
+                if (series.count > 0 && k != series.newest + 1) {
+                    series.count = 0;
+                }
+                series.grid[k % capacity] = value;
+                series.newest = k;
+                series.count = std::min(series.count + 1, capacity);
+            }
+        }
+        series.has_last = true;
+        series.last_time_us = sample.time_us;
+        series.last_value = sample.value;
+    }
+    queue.tail.store(tail, std::memory_order_release);
+}
+
+bool LatencyEstimator::measure(int device, double& delay_us, float& correlation) {
+    const Series& a = series_[config_.reference];
+    const Series& b = series_[device];
+    const int window = config_.window;
+    const int n = 2 * window;
+    if (a.count < window || b.count < window) {
+        return false;
+    }
+
+    // 最近的公共窗口 [start, end]，两条序列都须完整覆盖
+    int64_t end = std::min(a.newest, b.newest);
+    int64_t start = end - window + 1;
+    if (start < a.newest - a.count + 1 || start < b.newest - b.count + 1) {
+        return false;
+    }
+
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    for (int i = 0; i < window; i++) {
+        x_[i] = a.grid[(start + i) % n];
+        y_[i] = b.grid[(start + i) % n];
+        mean_x += x_[i];
+        mean_y += y_[i];
+    }
+    mean_x /= window;
+    mean_y /= window;
+
+    // 去均值并建立前缀和，用于求任意重叠段的均值与方差
+    for (int i = 0; i < window; i++) {
+        x_[i] = static_cast<float>(x_[i] - mean_x);
+        y_[i] = static_cast<float>(y_[i] - mean_y);
+        prefix_x_[i + 1].sum = prefix_x_[i].sum + x_[i];
+        prefix_x_[i + 1].square = prefix_x_[i].square + static_cast<double>(x_[i]) * x_[i];
+        prefix_y_[i + 1].sum = prefix_y_[i].sum + y_[i];
+        prefix_y_[i + 1].square = prefix_y_[i].square + static_cast<double>(y_[i]) * y_[i];
+    }
+    std::fill(x_.begin() + window, x_.end(), 0.0f);
+    std::fill(y_.begin() + window, y_.end(), 0.0f);
+
+    const double min_energy = static_cast<double>(config_.min_motion_dps) * config_.min_motion_dps * window;
+    if (prefix_x_[window].square < min_energy || prefix_y_[window].square < min_energy) {
+        return false;
+    }
+
+    // r = IFFT(conj(X)·Y)，负延迟位于末尾
+    fft_->forward(x_.data(), spectrum_x_.data());
+    fft_->forward(y_.data(), spectrum_y_.data());
+    for (size_t k = 0; k < spectrum_x_.size(); k++) {
+        spectrum_x_[k] = std::conj(spectrum_x_[k]) * spectrum_y_[k];
+    }
+    fft_->inverse(spectrum_x_.data(), r_.data());
+
+    // 每个延迟在实际重叠段上求相关系数：x[i] 与 y[i + τ]，重叠长度 window - |τ|
+    const int lag = max_lag_;
+    for (int tau = -lag; tau <= lag; tau++) {
+        int x_begin = std::max(0, -tau);
+        int y_begin = std::max(0, tau);
+        int m = window - std::abs(tau);
+        double sx = prefix_x_[x_begin + m].sum - prefix_x_[x_begin].sum;
+        double sxx = prefix_x_[x_begin + m].square - prefix_x_[x_begin].square - sx * sx / m;
+        double sy = prefix_y_[y_begin + m].sum - prefix_y_[y_begin].sum;
+        double syy = prefix_y_[y_begin + m].square - prefix_y_[y_begin].square - sy * sy / m;
+        double sxy = r_[(tau + n) % n] - sx * sy / m;
+        rho_[tau + lag] = sxx > 0.0 && syy > 0.0 ? sxy / std::sqrt(sxx * syy) : 0.0;
+    }
+
+    int best = 0;
+    for (int tau = -lag; tau <= lag; tau++) {
+        if (rho_[tau + lag] > rho_[best + lag]) {
+            best = tau;
+        }
+    }
+    if (best == -lag || best == lag) {
+        return false;
+    }
+
+    correlation = static_cast<float>(rho_[best + lag]);
+    if (correlation < config_.min_correlation) {
+        return false;
+    }
+
+    // 三点抛物线插值峰值位置
+    double left = rho_[best + lag - 1];
+    double center = rho_[best + lag];
+    double right = rho_[best + lag + 1];
+    double denominator = left - 2.0 * center + right;
+    double shift = denominator < 0.0 ? 0.5 * (left - right) / denominator : 0.0;
+    delay_us = (best + shift) * period_us_;
+    return true;
+}
@@ -0,0 +1,322 @@
+/**
+ * @file mag_calibrator.cpp
+ * @brief 磁力计在线标定实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   样本先乘以 MAG_FIT_SCALE 再累加，使正规方程各项量级接近；
+ *   偏移与模长在求解后换算回 uT，软铁矩阵为无量纲量不受缩放影响。
+ *   软铁矩阵取 R * sqrt(A')，R 为椭球三轴半径的几何平均，校正后磁场模长约为 R。
+ */
+#include "mag_calibrator.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+// 累加前的缩放系数（uT -> 100uT）
+constexpr double MAG_FIT_SCALE = 0.01;
+
+namespace {
+
+// 3x3 对称矩阵 Jacobi 特征分解：A = V diag(eig) V^T
+void symmetricEigen3(const double A[3][3], double eig[3], double V[3][3]) {
+    double a[3][3];
+    memcpy(a, A, sizeof(a));
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            V[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        if (off < 1e-24) {
+            break;
+        }
+        for (int p = 0; p < 2; p++) {
+            for (int q = p + 1; q < 3; q++) {
+                if (std::fabs(a[p][q]) < 1e-300) {
+                    continue;
+                }
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+                for (int k = 0; k < 3; k++) {
+                    double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double vkp = V[k][p], vkq = V[k][q];
+                    V[k][p] = c * vkp - s * vkq;
+                    V[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        eig[i] = a[i][i];
+    }
+}
+
+} // namespace
+
+MagCalibrator::MagCalibrator()
+    : handoff_ready_(false)
+    , running_(false) {
+    reset();
+}
+
+MagCalibrator::~MagCalibrator() {
+    stop();
+}
+
+void MagCalibrator::reset() {
+    memset(&sums_, 0, sizeof(sums_));
+    has_last_sample_ = false;
+    has_last_publish_ = false;
+    last_publish_ms_ = 0;
+    std::atomic_store(&correction_, std::shared_ptr<const MagCorrection>());
+}
+
+void MagCalibrator::start(const MagCalibrationConfig& config) {
+    stop();
+    config_ = config;
+    running_ = true;
+    solve_thread_ = std::thread(&MagCalibrator::solveThread, this);
+}
+
+void MagCalibrator::stop() {
+    if (!running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(handoff_mutex_);
+        running_ = false;
+    }
+    handoff_cv_.notify_one();
+    if (solve_thread_.joinable()) {
+        solve_thread_.join();
+    }
+}
+
+void MagCalibrator::addSample(const IMUData& data) {
+    if ((data.subscribe_tag & 0x0008) == 0) {
+        return;
+    }
+
+    // 与上一个入选样本过近时跳过，避免长时间静止使拟合偏向单一方向
+    float m[3] = {data.mag_x, data.mag_y, data.mag_z};
+    if (has_last_sample_) {
+        float dx = m[0] - last_sample_[0], dy = m[1] - last_sample_[1], dz = m[2] - last_sample_[2];
+        if (dx * dx + dy * dy + dz * dz < config_.min_spacing * config_.min_spacing) {
+            return;
+        }
+    }
+    memcpy(last_sample_, m, sizeof(last_sample_));
+    has_last_sample_ = true;
+
+    double x = m[0] * MAG_FIT_SCALE, y = m[1] * MAG_FIT_SCALE, z = m[2] * MAG_FIT_SCALE;
+    double d[MAG_FIT_PARAMS] = {x * x, y * y, z * z, 2 * y * z, 2 * x * z, 2 * x * y, 2 * x, 2 * y, 2 * z};
+    for (int i = 0; i < MAG_FIT_PARAMS; i++) {
+        for (int j = i; j < MAG_FIT_PARAMS; j++) {
+            sums_.normal[i][j] += d[i] * d[j];
+        }
+        sums_.rhs[i] += d[i];
+    }
+    sums_.count += 1.0;
+
+    // 到达求解间隔后尝试交给后台线程；设备时间戳回退（重启）时立即交出并以新时间重新计时
+    if (!has_last_publish_) {
+        has_last_publish_ = true;
+        last_publish_ms_ = data.timestamp;
+    }
+    int32_t delta = static_cast<int32_t>(data.timestamp - last_publish_ms_);
+    if (sums_.count < config_.min_samples || (delta >= 0 && delta < config_.solve_interval_ms)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(handoff_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    handoff_ = sums_;
+    handoff_ready_ = true;
+    last_publish_ms_ = data.timestamp;
+    lock.unlock();
+    handoff_cv_.notify_one();
+}
+
+void MagCalibrator::apply(IMUData& data) const {
+    if ((data.subscribe_tag & 0x0008) == 0) {
+        return;
+    }
+    std::shared_ptr<const MagCorrection> c = correction();
+    if (!c) {
+        return;
+    }
+    float v[3] = {data.mag_x - c->offset[0], data.mag_y - c->offset[1], data.mag_z - c->offset[2]};
+    data.mag_x = c->soft_iron[0][0] * v[0] + c->soft_iron[0][1] * v[1] + c->soft_iron[0][2] * v[2];
+    data.mag_y = c->soft_iron[1][0] * v[0] + c->soft_iron[1][1] * v[1] + c->soft_iron[1][2] * v[2];
+    data.mag_z = c->soft_iron[2][0] * v[0] + c->soft_iron[2][1] * v[1] + c->soft_iron[2][2] * v[2];
+}
+
+void MagCalibrator::solveThread() {
+    NormalEquations local;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(handoff_mutex_);
+            handoff_cv_.wait(lock, [this] { return handoff_ready_ || !running_; });
+            if (!running_) {
+                return;
+            }
+            local = handoff_;
+            handoff_ready_ = false;
+        }
+
+        // 补全对称部分
+        for (int i = 0; i < MAG_FIT_PARAMS; i++) {
+            for (int j = 0; j < i; j++) {
+                local.normal[i][j] = local.normal[j][i];
+            }
+        }
+
+        auto result = std::make_shared<MagCorrection>();
+        if (solve(local.normal, local.rhs, local.count, config_.max_axis_ratio, *result)) {
+            std::atomic_store(&correction_, std::shared_ptr<const MagCorrection>(result));
+            LOG_DEBUG("[磁力计标定] 样本={} 偏移=({:.2f}, {:.2f}, {:.2f}) uT 模长={:.2f} uT 残差={:.4f}",
+                      result->samples, result->offset[0], result->offset[1], result->offset[2],
+                      result->field_strength, result->rms_residual);
+        }
+    }
+}
+
+bool MagCalibrator::solve(const double normal[MAG_FIT_PARAMS][MAG_FIT_PARAMS], const double rhs[MAG_FIT_PARAMS],
+                          double count, float max_axis_ratio, MagCorrection& out) {
+    constexpr int N = MAG_FIT_PARAMS;
+
+    // 高斯消元（列主元）求解 normal * v = rhs
+    double m[N][N + 1];
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            m[i][j] = normal[i][j];
+        }
+        m[i][N] = rhs[i];
+    }
+    for (int col = 0; col < N; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < N; row++) {
+            if (std::fabs(m[row][col]) > std::fabs(m[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::fabs(m[pivot][col]) < 1e-12) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int k = 0; k <= N; k++) {
+                std::swap(m[pivot][k], m[col][k]);
+            }
+        }
+        for (int row = col + 1; row < N; row++) {
+            double f = m[row][col] / m[col][col];
+            for (int k = col; k <= N; k++) {
+                m[row][k] -= f * m[col][k];
+            }
+        }
+    }
+    double v[N];
+    for (int i = N - 1; i >= 0; i--) {
+        double sum = m[i][N];
+        for (int k = i + 1; k < N; k++) {
+            sum -= m[i][k] * v[k];
+        }
+        v[i] = sum / m[i][i];
+    }
+
+    // 拟合残差 sum((d·v - 1)^2) = v^T N v - 2 v^T rhs + count
+    double rss = count;
+    for (int i = 0; i < N; i++) {
+        double nv = 0.0;
+        for (int j = 0; j < N; j++) {
+            nv += normal[i][j] * v[j];
+        }
+        rss += v[i] * nv - 2.0 * v[i] * rhs[i];
+    }
+
+    // 二次型矩阵与中心
+    double A[3][3] = {{v[0], v[5], v[4]}, {v[5], v[1], v[3]}, {v[4], v[3], v[2]}};
+    double u[3] = {v[6], v[7], v[8]};
+    double det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
+               - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
+               + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+    if (std::fabs(det) < 1e-18) {
+        return false;
+    }
+    double inv[3][3];
+    inv[0][0] = (A[1][1] * A[2][2] - A[1][2] * A[2][1]) / det;
+    inv[0][1] = (A[0][2] * A[2][1] - A[0][1] * A[2][2]) / det;
+    inv[0][2] = (A[0][1] * A[1][2] - A[0][2] * A[1][1]) / det;
+    inv[1][0] = inv[0][1];
+    inv[1][1] = (A[0][0] * A[2][2] - A[0][2] * A[2][0]) / det;
+    inv[1][2] = (A[0][2] * A[1][0] - A[0][0] * A[1][2]) / det;
+    inv[2][0] = inv[0][2];
+    inv[2][1] = inv[1][2];
+    inv[2][2] = (A[0][0] * A[1][1] - A[0][1] * A[1][0]) / det;
+
+    double center[3];
+    for (int i = 0; i < 3; i++) {
+        center[i] = -(inv[i][0] * u[0] + inv[i][1] * u[1] + inv[i][2] * u[2]);
+    }
+    double k = 1.0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            k += center[i] * A[i][j] * center[j];
+        }
+    }
+    if (k <= 0.0) {
+        return false;
+    }
+    for (auto& row : A) {
+        for (double& a : row) {
+            a /= k;
+        }
+    }
+
+    // 特征值即 1/半径²，必须全部为正
+    double eig[3], V[3][3];
+    symmetricEigen3(A, eig, V);
+    if (eig[0] <= 0.0 || eig[1] <= 0.0 || eig[2] <= 0.0) {
+        return false;
+    }
+    double radii[3] = {1.0 / std::sqrt(eig[0]), 1.0 / std::sqrt(eig[1]), 1.0 / std::sqrt(eig[2])};
+    double r_max = std::max({radii[0], radii[1], radii[2]});
+    double r_min = std::min({radii[0], radii[1], radii[2]});
+    if (r_max / r_min > max_axis_ratio) {
+        return false;
+    }
+    double R = std::cbrt(radii[0] * radii[1] * radii[2]);
+
+    // W = R * V diag(sqrt(eig)) V^T
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            double w = 0.0;
+            for (int e = 0; e < 3; e++) {
+                w += V[i][e] * std::sqrt(eig[e]) * V[j][e];
+            }
+            out.soft_iron[i][j] = static_cast<float>(R * w);
+        }
+        out.offset[i] = static_cast<float>(center[i] / MAG_FIT_SCALE);
+    }
+    out.field_strength = static_cast<float>(R / MAG_FIT_SCALE);
+    out.rms_residual = static_cast<float>(std::sqrt(std::max(0.0, rss) / count));
+    out.samples = static_cast<uint64_t>(count);
+    return true;
+}
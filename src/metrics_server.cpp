@@ -0,0 +1,283 @@
+/**
+ * @file metrics_server.cpp
+ * @brief Prometheus 文本格式指标服务实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   在本地端口上提供 GET /metrics，输出 Prometheus text format 0.0.4。
+ *   频率与字节速率以计数器形式导出，由 Prometheus 端通过 rate() 计算；
+ *   回调耗时以直方图导出，可通过 histogram_quantile() 得到分位数。
+ */
+#include "metrics_server.h"
+#include "async_logger.h"
+#include <sstream>
+#include <cstring>
+#include <functional>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace {
+
+// 转义标签值中的反斜杠、双引号与换行
+std::string escapeLabel(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+using MetricsList = std::vector<std::pair<std::string, IMUReaderMetrics>>;
+
+// 输出一个指标族：HELP/TYPE 各一次，每个读取器一行
+void writeFamily(std::ostringstream& out, const MetricsList& list,
+                 const char* name, const char* type, const char* help,
+                 const std::function<double(const IMUReaderMetrics&)>& value) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+    for (const auto& item : list) {
+        out << name << "{imu=\"" << item.first << "\"} " << value(item.second) << "\n";
+    }
+}
+
+} // namespace
+
+MetricsServer::MetricsServer()
+    : running_(false)
+    , listen_fd_(-1) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::addReader(const std::string& name, const IMUReader* reader) {
+    readers_.emplace_back(escapeLabel(name), reader);
+}
+
+bool MetricsServer::start(const std::string& bind_address, int port) {
+    if (running_) {
+        return true;
+    }
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        LOG_ERROR("指标服务创建套接字失败: {}", strerror(errno));
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+        LOG_ERROR("指标服务地址无效: {}", bind_address);
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 4) != 0) {
+        LOG_ERROR("指标服务监听失败 {}:{}: {}", bind_address, port, strerror(errno));
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    serve_thread_ = std::thread(&MetricsServer::serveThread, this);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    if (serve_thread_.joinable()) {
+        serve_thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void MetricsServer::serveThread() {
+    while (running_) {
+        // 轮询超时以便及时响应 stop()
+        pollfd pfd;
+        pfd.fd = listen_fd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 200) <= 0 || !(pfd.revents & POLLIN)) {
+            continue;
+        }
+
+        int client_fd = accept(listen_fd_, nullptr, nullptr);
+        if (client_fd < 0) {
+            continue;
+        }
+        handleClient(client_fd);
+        close(client_fd);
+    }
+}
+
+void MetricsServer::handleClient(int client_fd) {
+    // 限制请求读取时间，避免慢客户端占住服务线程
+    timeval tv;
+    tv.tv_sec = 1;
+    tv.tv_usec = 0;
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    char request[1024];
+    ssize_t n = recv(client_fd, request, sizeof(request) - 1, 0);
+    if (n <= 0) {
+        return;
+    }
+    request[n] = '\0';
+
+    std::string status;
+    std::string body;
+    if (strncmp(request, "GET /metrics", 12) == 0 || strncmp(request, "GET / ", 6) == 0) {
+        status = "200 OK";
+        body = render();
+    } else {
+        status = "404 Not Found";
+        body = "not found\n";
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+
+    std::string data = response.str();
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t w = send(client_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (w <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(w);
+    }
+}
+
+std::string MetricsServer::render() const {
+    MetricsList list;
+    list.reserve(readers_.size());
+    for (const auto& reader : readers_) {
+        list.emplace_back(reader.first, reader.second->getMetrics());
+    }
+
+    std::ostringstream out;
+    out.precision(15);
+
+    writeFamily(out, list, "imu_up", "gauge", "Serial port connected (1) or not (0).",
+                [](const IMUReaderMetrics& m) { return m.connected ? 1.0 : 0.0; });
+    writeFamily(out, list, "imu_running", "gauge", "Reader threads running.",
+                [](const IMUReaderMetrics& m) { return m.running ? 1.0 : 0.0; });
+    writeFamily(out, list, "imu_report_rate_hz", "gauge", "Configured device report rate.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.report_rate); });
+    writeFamily(out, list, "imu_baudrate", "gauge", "Configured serial baud rate.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.baudrate); });
+    writeFamily(out, list, "imu_reconnect_attempts", "gauge", "Consecutive reconnect attempts in progress.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.reconnect_attempts); });
+    writeFamily(out, list, "imu_reconnects_total", "counter", "Successful reconnects.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.reconnects); });
+    writeFamily(out, list, "imu_rx_bytes_total", "counter", "Bytes received from the serial port.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.rx_bytes); });
+    writeFamily(out, list, "imu_frames_total", "counter", "Valid frames accepted by the parser.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.parser.frames); });
+    writeFamily(out, list, "imu_sensor_frames_total", "counter", "Sensor data frames (0x11).",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.parser.sensor_frames); });
+    writeFamily(out, list, "imu_samples_lost_total", "counter", "Samples estimated lost from device timestamps.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.loss.lost_samples); });
+    writeFamily(out, list, "imu_duplicates_total", "counter", "Duplicate device timestamps.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.loss.duplicates); });
+    writeFamily(out, list, "imu_reorders_total", "counter", "Out-of-order device timestamps.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.loss.reorders); });
+    writeFamily(out, list, "imu_timestamp_resets_total", "counter", "Device timestamp resets.",
+                [](const IMUReaderMetrics& m) { return static_cast<double>(m.loss.resets); });
+
+    // 解析错误按类型分标签
+    out << "# HELP imu_parser_errors_total Frames rejected by the parser.\n";
+    out << "# TYPE imu_parser_errors_total counter\n";
+    for (const auto& item : list) {
+        const IMUParserStats& p = item.second.parser;
+        const std::pair<const char*, uint64_t> errors[] = {
+            {"checksum", p.checksum_errors},
+            {"end_byte", p.end_errors},
+            {"address", p.addr_mismatches},
+            {"short", p.short_frames},
+            {"unknown_command", p.unknown_commands},
+        };
+        for (const auto& e : errors) {
+            out << "imu_parser_errors_total{imu=\"" << item.first << "\",type=\""
+                << e.first << "\"} " << e.second << "\n";
+        }
+    }
+
+    // 丢帧大小直方图（桶上界 1, 2, 4, ... 帧）
+    out << "# HELP imu_gap_size_samples Samples lost per detected gap.\n";
+    out << "# TYPE imu_gap_size_samples histogram\n";
+    for (const auto& item : list) {
+        const SampleLossStats& loss = item.second.loss;
+        uint64_t cumulative = 0;
+        for (int i = 0; i < GAP_HISTOGRAM_BUCKETS; i++) {
+            cumulative += loss.gap_histogram[i];
+            out << "imu_gap_size_samples_bucket{imu=\"" << item.first << "\",le=\"";
+            if (i == GAP_HISTOGRAM_BUCKETS - 1) {
+                out << "+Inf";
+            } else {
+                out << (1u << i);
+            }
+            out << "\"} " << cumulative << "\n";
+        }
+        out << "imu_gap_size_samples_sum{imu=\"" << item.first << "\"} " << loss.lost_samples << "\n";
+        out << "imu_gap_size_samples_count{imu=\"" << item.first << "\"} " << loss.gaps << "\n";
+    }
+
+    // 回调耗时直方图
+    out << "# HELP imu_callback_duration_seconds Time spent in the user data callback.\n";
+    out << "# TYPE imu_callback_duration_seconds histogram\n";
+    for (const auto& item : list) {
+        const IMUReaderMetrics& m = item.second;
+        uint64_t cumulative = 0;
+        for (int i = 0; i < CALLBACK_LATENCY_BUCKETS; i++) {
+            cumulative += m.callback_latency[i];
+            out << "imu_callback_duration_seconds_bucket{imu=\"" << item.first << "\",le=\"";
+            if (i == CALLBACK_LATENCY_BUCKETS - 1) {
+                out << "+Inf";
+            } else {
+                out << CALLBACK_LATENCY_BOUNDS_US[i] * 1e-6;
+            }
+            out << "\"} " << cumulative << "\n";
+        }
+        out << "imu_callback_duration_seconds_sum{imu=\"" << item.first << "\"} "
+            << m.callback_latency_sum_ns * 1e-9 << "\n";
+        out << "imu_callback_duration_seconds_count{imu=\"" << item.first << "\"} " << cumulative << "\n";
+    }
+
+    return out.str();
+}
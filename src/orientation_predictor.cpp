@@ -0,0 +1,82 @@
+/**
+ * @file orientation_predictor.cpp
+ * @brief 基于陀螺外推的姿态延迟补偿实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   角速度 ω(τ) = ω0 + α·τ 时，Bortz 方程的一阶近似 θ̇ = ω + θ × ω / 2 积分得
+ *   θ(t) = ω0·t + α·t²/2 + (ω0 × α)·t³/12。
+ *   角加速度由相邻两帧角速度差分后低通得到，对陀螺噪声敏感，
+ *   外推时长较长或陀螺噪声较大时宜使用恒定角速度。
+ */
+#include "orientation_predictor.h"
+#include <algorithm>
+#include <cctype>
+
+PredictionMode parsePredictionMode(const std::string& name, PredictionMode fallback) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "constant") return PredictionMode::CONSTANT_RATE;
+    if (lower == "second_order") return PredictionMode::SECOND_ORDER;
+    return fallback;
+}
+
+OrientationPredictor::OrientationPredictor()
+    : has_last_(false)
+    , last_host_us_(0) {
+}
+
+void OrientationPredictor::configure(const PredictionConfig& config) {
+    config_ = config;
+    reset();
+}
+
+void OrientationPredictor::reset() {
+    has_last_ = false;
+    angular_accel_ = Vec3f{};
+    latest_.store(OrientationSample());
+}
+
+void OrientationPredictor::update(const IMUData& data, int64_t host_time_us) {
+    if ((data.subscribe_tag & 0x0024) != 0x0024) {
+        return;
+    }
+
+    Vec3f gyro{data.gyro_x * DEG_TO_RAD, data.gyro_y * DEG_TO_RAD, data.gyro_z * DEG_TO_RAD};
+    if (has_last_ && host_time_us > last_host_us_) {
+        float dt = static_cast<float>(host_time_us - last_host_us_) * 1e-6f;
+        Vec3f alpha = (gyro - last_gyro_) * (1.0f / dt);
+        angular_accel_ = angular_accel_ + (alpha - angular_accel_) * config_.alpha_smoothing;
+    }
+    has_last_ = true;
+    last_gyro_ = gyro;
+    last_host_us_ = host_time_us;
+
+    OrientationSample sample;
+    sample.orientation = Quatf{data.quat_w, data.quat_x, data.quat_y, data.quat_z};
+    sample.gyro = gyro;
+    sample.angular_accel = angular_accel_;
+    sample.host_time_us = host_time_us;
+    sample.valid = true;
+    latest_.store(sample);
+}
+
+Quatf OrientationPredictor::predict(int64_t host_time_us) const {
+    OrientationSample sample = latest_.load();
+    if (!sample.valid) {
+        return Quatf{};
+    }
+    int64_t limit_us = static_cast<int64_t>(config_.max_horizon_ms) * 1000;
+    int64_t horizon_us = std::max(-limit_us, std::min(host_time_us - sample.host_time_us, limit_us));
+    return extrapolate(sample, static_cast<float>(horizon_us) * 1e-6f, config_.mode);
+}
+
+Quatf OrientationPredictor::extrapolate(const OrientationSample& sample, float dt, PredictionMode mode) {
+    Vec3f theta = sample.gyro * dt;
+    if (mode == PredictionMode::SECOND_ORDER) {
+        theta = theta + sample.angular_accel * (0.5f * dt * dt) +
+                cross(sample.gyro, sample.angular_accel) * (dt * dt * dt / 12.0f);
+    }
+    return normalized(sample.orientation * quatFromRotationVector(theta));
+}
@@ -0,0 +1,144 @@
+/**
+ * @file realtime.cpp
+ * @brief 读取线程实时调度与调度抖动统计实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   CPU 绑定使用 pthread_setaffinity_np，实时优先级使用 SCHED_FIFO；
+ *   两者都需要相应权限（root 或 CAP_SYS_NICE），失败时只输出警告，读取照常进行。
+ *   调度抖动的分辨率受设备时间戳 1ms 精度限制，直方图按毫秒分桶，适合观察负载下的毫秒级抢占。
+ */
+#include "realtime.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+// 抖动基线窗口长度
+constexpr uint64_t JITTER_WINDOW_US = 10ull * 1000 * 1000;
+
+void applyThreadRealTime(const RealTimeThreadConfig& config, int prefault_stack_kb, const char* thread_name) {
+    if (config.cpu >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(config.cpu, &cpuset);
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+        if (ret != 0) {
+            LOG_WARN("警告: {} 绑定 CPU {} 失败: {}", thread_name, config.cpu, strerror(ret));
+        } else {
+            LOG_INFO("{} 已绑定到 CPU {}", thread_name, config.cpu);
+        }
+    }
+
+    if (config.priority > 0) {
+        sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = std::min(config.priority, sched_get_priority_max(SCHED_FIFO));
+        int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (ret != 0) {
+            LOG_WARN("警告: {} 设置 SCHED_FIFO 优先级 {} 失败: {} (需要 root 或 CAP_SYS_NICE)",
+                     thread_name, param.sched_priority, strerror(ret));
+        } else {
+            LOG_INFO("{} 已设置 SCHED_FIFO 优先级 {}", thread_name, param.sched_priority);
+        }
+    }
+
+    if (prefault_stack_kb > 0) {
+        // 预先触碰栈页，避免运行中首次使用时缺页
+        size_t bytes = static_cast<size_t>(prefault_stack_kb) * 1024;
+        volatile unsigned char* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+        for (size_t i = 0; i < bytes; i += 4096) {
+            stack[i] = 0;
+        }
+    }
+}
+
+bool lockProcessMemory() {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        LOG_WARN("警告: mlockall 失败: {} (需要 root 或 CAP_IPC_LOCK，或提高 ulimit -l)", strerror(errno));
+        return false;
+    }
+    LOG_INFO("进程内存已锁定 (mlockall)");
+    return true;
+}
+
+JitterMonitor::JitterMonitor()
+    : has_baseline_(false)
+    , window_start_us_(0)
+    , baseline_us_(0)
+    , prev_window_min_us_(0)
+    , window_min_us_(0)
+    , device_base_us_(0)
+    , last_device_ms_(0) {
+    clearStats();
+}
+
+void JitterMonitor::update(uint64_t host_us, uint32_t device_ms) {
+    if (!has_baseline_) {
+        has_baseline_ = true;
+        last_device_ms_ = device_ms;
+        device_base_us_ = 0;
+        window_start_us_ = host_us;
+        window_min_us_ = std::numeric_limits<int64_t>::max();
+        prev_window_min_us_ = std::numeric_limits<int64_t>::max();
+    }
+
+    // 展开设备时间戳（兼容 32 位回绕）
+    int32_t delta_ms = static_cast<int32_t>(device_ms - last_device_ms_);
+    last_device_ms_ = device_ms;
+    device_base_us_ += static_cast<int64_t>(delta_ms) * 1000;
+
+    int64_t offset_us = static_cast<int64_t>(host_us) - device_base_us_;
+
+    // 滑动窗口最小值作为基线
+    if (host_us - window_start_us_ >= JITTER_WINDOW_US) {
+        prev_window_min_us_ = window_min_us_;
+        window_min_us_ = offset_us;
+        window_start_us_ = host_us;
+    } else {
+        window_min_us_ = std::min(window_min_us_, offset_us);
+    }
+    baseline_us_ = std::min(prev_window_min_us_, window_min_us_);
+
+    uint64_t jitter_us = static_cast<uint64_t>(offset_us - baseline_us_);
+    uint32_t jitter = static_cast<uint32_t>(std::min<uint64_t>(jitter_us, UINT32_MAX));
+
+    int bucket = 0;
+    while (bucket < JITTER_BUCKETS - 1 && jitter > JITTER_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+
+    samples_.fetch_add(1, std::memory_order_relaxed);
+    sum_us_.fetch_add(jitter, std::memory_order_relaxed);
+    histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (jitter > max_us_.load(std::memory_order_relaxed)) {
+        max_us_.store(jitter, std::memory_order_relaxed);
+    }
+}
+
+void JitterMonitor::clearStats() {
+    samples_ = 0;
+    sum_us_ = 0;
+    max_us_ = 0;
+    for (auto& bucket : histogram_) {
+        bucket = 0;
+    }
+}
+
+JitterStats JitterMonitor::getStats() const {
+    JitterStats stats;
+    stats.samples = samples_.load(std::memory_order_relaxed);
+    stats.max_us = max_us_.load(std::memory_order_relaxed);
+    if (stats.samples > 0) {
+        stats.mean_us = static_cast<double>(sum_us_.load(std::memory_order_relaxed)) / stats.samples;
+    }
+    for (int i = 0; i < JITTER_BUCKETS; i++) {
+        stats.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
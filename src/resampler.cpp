@@ -0,0 +1,233 @@
+/**
+ * @file resampler.cpp
+ * @brief 多相 FIR 重采样实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   原型滤波器为 Blackman 窗 sinc，截止频率取输入/输出 Nyquist 中较小者的 90%：
+ *   降采样时抗混叠，上采样时即为带限插值。输出网格对齐到主机时钟的整数倍周期，
+ *   多个读取器以相同 output_rate 重采样时输出时刻一致。
+ *   输入时间基准为 alpha-beta 跟踪：每个样本以舍入后的周期数预测时刻，观测误差按 alpha 修正时刻、
+ *   按 beta 修正周期，1ms 量化噪声与基线跳变在时间常数内被平均掉。
+ */
+#include "resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// 四元数与欧拉角在通道中的位置（通道顺序同 IMU_FIELD_MEMBERS）
+constexpr int QUAT_CHANNEL = 15;
+constexpr int EULER_CHANNEL = 19;
+
+} // namespace
+
+Resampler::Resampler()
+    : input_period_us_(4000.0)
+    , output_period_us_(5000.0)
+    , taps_(16)
+    , phases_(64)
+    , clock_gain_(1.0)
+    , clock_rate_gain_(0.25) {
+    reset();
+}
+
+void Resampler::configure(const ResamplerConfig& config, double input_rate) {
+    config_ = config;
+    input_rate = input_rate > 0 ? input_rate : 0.5;
+    double output_rate = config.output_rate > 0 ? config.output_rate : input_rate;
+    input_period_us_ = 1e6 / input_rate;
+    output_period_us_ = 1e6 / output_rate;
+    phases_ = std::max(1, config.phases);
+
+    // 时间基准：时间常数折算为输入样本数 N，alpha = 2/N，beta = alpha²/4（临界阻尼）
+    double clock_samples = std::max(2.0, config.clock_time_constant_ms * 1000.0 / input_period_us_);
+    clock_gain_ = 2.0 / clock_samples;
+    clock_rate_gain_ = clock_gain_ * clock_gain_ / 4.0;
+
+    // 降采样时截止频率降低，抽头数按比例增加以保持过渡带宽度
+    double ratio = output_rate / input_rate;
+    double fc = 0.45 * std::min(1.0, ratio);  // 周期/输入样本
+    int taps = static_cast<int>(std::ceil(config.taps * std::max(1.0, 1.0 / ratio)));
+    taps_ = std::max(4, std::min(RESAMPLE_MAX_TAPS, (taps + 1) & ~1));
+
+    // h[p][k] = g(p/P + T/2 - 1 - k)，g 为以 0 为中心的窗函数 sinc
+    coeffs_.assign(static_cast<size_t>(phases_ + 1) * taps_, 0.0f);
+    double half = taps_ / 2.0;
+    for (int p = 0; p <= phases_; p++) {
+        double sum = 0.0;
+        float* row = &coeffs_[static_cast<size_t>(p) * taps_];
+        for (int k = 0; k < taps_; k++) {
+            double t = static_cast<double>(p) / phases_ + half - 1 - k;
+            double x = 2.0 * fc * t;
+            double sinc = std::fabs(x) < 1e-12 ? 1.0 : std::sin(PI * x) / (PI * x);
+            double w = std::fabs(t) >= half ? 0.0
+                     : 0.42 + 0.5 * std::cos(PI * t / half) + 0.08 * std::cos(2.0 * PI * t / half);
+            row[k] = static_cast<float>(2.0 * fc * sinc * w);
+            sum += row[k];
+        }
+        // 每相直流增益归一化为 1
+        for (int k = 0; k < taps_; k++) {
+            row[k] = static_cast<float>(row[k] / sum);
+        }
+    }
+    reset();
+}
+
+void Resampler::reset() {
+    memset(history_, 0, sizeof(history_));
+    memset(last_sample_, 0, sizeof(last_sample_));
+    count_ = 0;
+    clock_us_ = 0.0;
+    clock_period_us_ = input_period_us_;
+    next_output_index_ = 0;
+    has_output_grid_ = false;
+}
+
+void Resampler::append(const float* sample) {
+    size_t index = count_ % RESAMPLE_RING;
+    for (int c = 0; c < RESAMPLE_CHANNELS; c++) {
+        history_[c][index] = sample[c];
+        history_[c][index + RESAMPLE_RING] = sample[c];
+    }
+    memcpy(last_sample_, sample, sizeof(last_sample_));
+    count_++;
+}
+
+void Resampler::push(const IMUData& data, int64_t host_time_us) {
+    float sample[RESAMPLE_CHANNELS];
+    for (int c = 0; c < RESAMPLE_CHANNELS; c++) {
+        sample[c] = data.*IMU_FIELD_MEMBERS[c];
+    }
+
+    long steps = 0;
+    if (count_ > 0) {
+        // 丢帧：少量时按前后两帧线性插值补齐，过多或时间回退时重新开始
+        steps = std::lround((host_time_us - clock_us_) / clock_period_us_);
+        if (steps < 1 || steps - 1 > config_.max_fill) {
+            reset();
+            steps = 0;
+        }
+        if (count_ > 0) {
+            // 四元数与上一帧同号，欧拉角展开，避免跨越 ±180° 时滤波出错
+            const float* q = &last_sample_[QUAT_CHANNEL];
+            float* nq = &sample[QUAT_CHANNEL];
+            if (q[0] * nq[0] + q[1] * nq[1] + q[2] * nq[2] + q[3] * nq[3] < 0.0f) {
+                for (int i = 0; i < 4; i++) {
+                    nq[i] = -nq[i];
+                }
+            }
+            for (int i = 0; i < 3; i++) {
+                float prev = last_sample_[EULER_CHANNEL + i];
+                float& e = sample[EULER_CHANNEL + i];
+                e += 360.0f * std::round((prev - e) / 360.0f);
+            }
+
+            float prev[RESAMPLE_CHANNELS];
+            memcpy(prev, last_sample_, sizeof(prev));
+            for (long i = 1; i < steps; i++) {
+                float fill[RESAMPLE_CHANNELS];
+                float w = static_cast<float>(i) / steps;
+                for (int c = 0; c < RESAMPLE_CHANNELS; c++) {
+                    fill[c] = prev[c] + w * (sample[c] - prev[c]);
+                }
+                append(fill);
+            }
+        }
+    }
+
+    append(sample);
+    last_data_ = data;
+    updateClock(host_time_us, steps);
+
+    if (!has_output_grid_) {
+        next_output_index_ = static_cast<int64_t>(std::ceil(clock_us_ / output_period_us_));
+        has_output_grid_ = true;
+    }
+
+    // 输出时刻对应的输入分数位置需满足两侧各有 taps/2 个样本
+    double newest = static_cast<double>(count_ - 1);
+    double latest_position = newest - taps_ / 2;
+    double earliest_position = taps_ / 2 - 1;
+    while (true) {
+        double t = next_output_index_ * output_period_us_;
+        double position = newest - (clock_us_ - t) / clock_period_us_;
+        if (position > latest_position) {
+            break;
+        }
+        if (position >= earliest_position) {
+            emit(position, static_cast<int64_t>(std::llround(t)));
+        }
+        next_output_index_++;
+    }
+}
+
+void Resampler::updateClock(int64_t raw_us, long steps) {
+    if (steps == 0) {
+        clock_us_ = static_cast<double>(raw_us);
+        clock_period_us_ = input_period_us_;
+        return;
+    }
+    double predicted = clock_us_ + steps * clock_period_us_;
+    double error = raw_us - predicted;
+    clock_us_ = predicted + clock_gain_ * error;
+    clock_period_us_ += clock_rate_gain_ * error / steps;
+    // 设备与主机时钟偏差远小于 1%，限制周期估计，避免被基线跳变拉偏
+    clock_period_us_ = std::min(std::max(clock_period_us_, 0.99 * input_period_us_), 1.01 * input_period_us_);
+}
+
+void Resampler::emit(double position, int64_t host_time_us) {
+    uint64_t n = static_cast<uint64_t>(position);
+    double phase = (position - n) * phases_;
+    int p0 = std::min(static_cast<int>(phase), phases_ - 1);
+    float frac = static_cast<float>(phase - p0);
+
+    // 相邻两相系数线性插值
+    const float* row0 = &coeffs_[static_cast<size_t>(p0) * taps_];
+    const float* row1 = row0 + taps_;
+    float h[RESAMPLE_MAX_TAPS];
+    for (int k = 0; k < taps_; k++) {
+        h[k] = row0[k] + frac * (row1[k] - row0[k]);
+    }
+
+    size_t start = (n + 1 - taps_ / 2) % RESAMPLE_RING;
+    float out[RESAMPLE_CHANNELS];
+    for (int c = 0; c < RESAMPLE_CHANNELS; c++) {
+        const float* x = &history_[c][start];
+        float acc = 0.0f;
+        for (int k = 0; k < taps_; k++) {
+            acc += h[k] * x[k];
+        }
+        out[c] = acc;
+    }
+
+    IMUData data = last_data_;
+    for (int c = 0; c < RESAMPLE_CHANNELS; c++) {
+        data.*IMU_FIELD_MEMBERS[c] = out[c];
+    }
+    float qn = std::sqrt(data.quat_w * data.quat_w + data.quat_x * data.quat_x +
+                         data.quat_y * data.quat_y + data.quat_z * data.quat_z);
+    if (qn > 0.0f) {
+        data.quat_w /= qn;
+        data.quat_x /= qn;
+        data.quat_y /= qn;
+        data.quat_z /= qn;
+    }
+    for (float IMUData::* field : {&IMUData::euler_x, &IMUData::euler_y, &IMUData::euler_z}) {
+        float& e = data.*field;
+        e -= 360.0f * std::floor((e + 180.0f) / 360.0f);
+        if (e == -180.0f) {
+            e = 180.0f;
+        }
+    }
+    // 设备时间戳按输出时刻相对最新输入的偏移回推
+    data.timestamp = last_data_.timestamp - static_cast<uint32_t>(std::llround((clock_us_ - host_time_us) / 1000.0));
+
+    if (callback_) {
+        callback_(data, static_cast<uint64_t>(host_time_us));
+    }
+}
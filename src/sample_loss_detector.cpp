@@ -0,0 +1,121 @@
+/**
+ * @file sample_loss_detector.cpp
+ * @brief 基于设备时间戳的丢帧检测器实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   根据 report_rate 推算期望帧间隔，检查设备时间戳序列中的丢帧、重复与乱序。
+ *   设备时间戳单位为 ms（32位，允许回绕），因此高帧率下单帧间隔会有 ±1ms 抖动，
+ *   只有超过 1.5 倍期望间隔的跳变才计为丢帧。
+ */
+#include "sample_loss_detector.h"
+#include <algorithm>
+#include <cmath>
+
+// 时间戳回退超过该帧数视为设备重置而非乱序
+constexpr double RESET_BACKWARD_PERIODS = 16.0;
+// 时间戳回退判定为重置的最小毫秒数
+constexpr double RESET_BACKWARD_MIN_MS = 100.0;
+
+SampleLossDetector::SampleLossDetector()
+    : period_ms_(1000.0 / 60)
+    , has_last_(false)
+    , last_timestamp_(0) {
+    clearStats();
+}
+
+void SampleLossDetector::setReportRate(int report_rate) {
+    // 0 = 0.5Hz
+    period_ms_ = (report_rate <= 0) ? 2000.0 : 1000.0 / report_rate;
+    has_last_ = false;
+}
+
+bool SampleLossDetector::update(uint32_t timestamp, IMUGapEvent& event) {
+    samples_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!has_last_) {
+        last_timestamp_ = timestamp;
+        has_last_ = true;
+        return false;
+    }
+
+    // 有符号差值，兼容 32 位回绕
+    int32_t delta = static_cast<int32_t>(timestamp - last_timestamp_);
+    event.prev_timestamp = last_timestamp_;
+    event.timestamp = timestamp;
+    event.lost_samples = 0;
+
+    if (delta == 0) {
+        event.type = IMUGapType::DUPLICATE;
+        duplicates_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (delta < 0) {
+        double back_ms = -static_cast<double>(delta);
+        if (back_ms > std::max(RESET_BACKWARD_MIN_MS, RESET_BACKWARD_PERIODS * period_ms_)) {
+            event.type = IMUGapType::RESET;
+            resets_.fetch_add(1, std::memory_order_relaxed);
+            last_timestamp_ = timestamp;
+        } else {
+            // 乱序帧不推进 last_timestamp_，避免下一帧被误判为丢帧
+            event.type = IMUGapType::REORDER;
+            reorders_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    last_timestamp_ = timestamp;
+
+    if (delta <= period_ms_ * 1.5) {
+        return false;
+    }
+
+    long periods = std::lround(delta / period_ms_);
+    uint32_t lost = periods > 1 ? static_cast<uint32_t>(periods - 1) : 1;
+
+    event.type = IMUGapType::GAP;
+    event.lost_samples = lost;
+    gaps_.fetch_add(1, std::memory_order_relaxed);
+    lost_samples_.fetch_add(lost, std::memory_order_relaxed);
+    gap_histogram_[histogramBucket(lost)].fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void SampleLossDetector::clearStats() {
+    samples_ = 0;
+    lost_samples_ = 0;
+    gaps_ = 0;
+    duplicates_ = 0;
+    reorders_ = 0;
+    resets_ = 0;
+    for (auto& bucket : gap_histogram_) {
+        bucket = 0;
+    }
+}
+
+SampleLossStats SampleLossDetector::getStats() const {
+    SampleLossStats stats;
+    stats.samples = samples_.load(std::memory_order_relaxed);
+    stats.lost_samples = lost_samples_.load(std::memory_order_relaxed);
+    stats.gaps = gaps_.load(std::memory_order_relaxed);
+    stats.duplicates = duplicates_.load(std::memory_order_relaxed);
+    stats.reorders = reorders_.load(std::memory_order_relaxed);
+    stats.resets = resets_.load(std::memory_order_relaxed);
+    for (int i = 0; i < GAP_HISTOGRAM_BUCKETS; i++) {
+        stats.gap_histogram[i] = gap_histogram_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+int SampleLossDetector::histogramBucket(uint32_t lost_samples) {
+    // 按 2 的幂分桶: 1 -> 0, 2 -> 1, 3-4 -> 2, 5-8 -> 3 ...
+    int bucket = 0;
+    uint32_t upper = 1;
+    while (lost_samples > upper && bucket < GAP_HISTOGRAM_BUCKETS - 1) {
+        upper <<= 1;
+        bucket++;
+    }
+    return bucket;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file strapdown.cpp
+ * @brief 捷联惯导积分实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   设区间两端采样为 (ω_a, f_a)、(ω_b, f_b)，区间内线性变化，对 Bortz 方程与速度增量方程
+ *   逐项积分得：圆锥项 T²/12 · ω_a × ω_b，划桨项 T²/12 · (ω_a × f_b + f_a × ω_b)，
+ *   与二子样算法同形但只依赖当前区间，丢帧后无需重建历史。
+ *   速度与位置以 double 累加，避免长时间积分时
+ *   小增量被 float 舍入吞掉；姿态每步归一化。
+ *   首个样本只建立区间起点，不产生增量。
+ */
+#include "strapdown.h"
+
+StrapdownSample strapdownSampleFromIMU(const IMUData& data, float dt) {
+    StrapdownSample sample;
+    sample.gyro = Vec3f{data.gyro_x * DEG_TO_RAD, data.gyro_y * DEG_TO_RAD, data.gyro_z * DEG_TO_RAD};
+    sample.accel = Vec3f{data.accel_with_gravity_x, data.accel_with_gravity_y, data.accel_with_gravity_z};
+    sample.dt = dt;
+    return sample;
+}
+
+StrapdownIntegrator::StrapdownIntegrator()
+    : initialized_(false)
+    , has_previous_(false)
+    , still_count_(0) {
+}
+
+void StrapdownIntegrator::configure(const StrapdownConfig& config) {
+    config_ = config;
+    still_count_ = 0;
+}
+
+void StrapdownIntegrator::reset(const Quatf& attitude) {
+    const double zero[3] = {0.0, 0.0, 0.0};
+    reset(attitude, zero, zero);
+}
+
+void StrapdownIntegrator::reset(const Quatf& attitude, const double velocity[3], const double position[3]) {
+    state_ = StrapdownState();
+    state_.attitude = normalized(attitude);
+    for (int i = 0; i < 3; i++) {
+        state_.velocity[i] = velocity[i];
+        state_.position[i] = position[i];
+    }
+    initialized_ = true;
+    has_previous_ = false;
+    still_count_ = 0;
+}
+
+void StrapdownIntegrator::applyZeroVelocity() {
+    state_.velocity[0] = state_.velocity[1] = state_.velocity[2] = 0.0;
+    state_.zupts++;
+}
+
+bool StrapdownIntegrator::detectStationary(const StrapdownSample& sample) {
+    float gyro_tol = config_.zupt_gyro_tol * DEG_TO_RAD;
+    bool still = std::fabs(norm(sample.accel) - config_.gravity) < config_.zupt_accel_tol &&
+                 norm(sample.gyro) < gyro_tol;
+    still_count_ = still ? still_count_ + 1 : 0;
+    return still_count_ >= config_.zupt_samples;
+}
+
+void StrapdownIntegrator::update(const StrapdownSample& sample) {
+    if (!initialized_) {
+        return;
+    }
+
+    // 区间起点：只记录采样，不积分
+    if (!has_previous_) {
+        has_previous_ = true;
+        last_gyro_ = sample.gyro;
+        last_accel_ = sample.accel;
+        state_.samples++;
+        return;
+    }
+
+    float dt = sample.dt;
+    Vec3f dtheta = (last_gyro_ + sample.gyro) * (0.5f * dt);
+    Vec3f dv = (last_accel_ + sample.accel) * (0.5f * dt);
+
+    // 区间内角速度与比力线性变化时的圆锥、划桨补偿
+    float k = dt * dt / 12.0f;
+    Vec3f phi = dtheta + cross(last_gyro_, sample.gyro) * k;
+    Vec3f dv_body = dv + cross(dtheta, dv) * 0.5f +
+                    (cross(last_gyro_, sample.accel) + cross(last_accel_, sample.gyro)) * k;
+    last_gyro_ = sample.gyro;
+    last_accel_ = sample.accel;
+
+    // 在区间起点姿态下转到世界系，加上重力
+    Vec3f dv_world = rotate(state_.attitude, dv_body);
+    double v_old[3] = {state_.velocity[0], state_.velocity[1], state_.velocity[2]};
+    state_.velocity[0] += dv_world.x;
+    state_.velocity[1] += dv_world.y;
+    state_.velocity[2] += dv_world.z - static_cast<double>(config_.gravity) * dt;
+    for (int i = 0; i < 3; i++) {
+        state_.position[i] += 0.5 * (v_old[i] + state_.velocity[i]) * dt;
+    }
+
+    state_.attitude = normalized(state_.attitude * quatFromRotationVector(phi));
+    state_.time += dt;
+    state_.samples++;
+
+    // 零速修正
+    state_.stationary = false;
+    if (config_.zupt) {
+        state_.stationary = detector_ ? detector_(sample, state_) : detectStationary(sample);
+        if (state_.stationary) {
+            applyZeroVelocity();
+        }
+    }
+}
+
+void StrapdownIntegrator::updateBatch(const StrapdownSample* samples, size_t count, StrapdownState* trajectory) {
+    for (size_t i = 0; i < count; i++) {
+        update(samples[i]);
+        if (trajectory != nullptr) {
+            trajectory[i] = state_;
+        }
+    }
+}
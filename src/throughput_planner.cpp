@@ -0,0 +1,64 @@
+/**
+ * @file throughput_planner.cpp
+ * @brief 串口吞吐量规划实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   帧大小按 parseSensorData 实际消费的字节计算；温度/气压/高度为 2+3+3=8 字节。
+ */
+#include "throughput_planner.h"
+#include <algorithm>
+
+int sensorPayloadBytes(uint16_t subscribe_tag) {
+    int size = 7;
+    if (subscribe_tag & 0x0001) size += 6;  // 加速度不含重力
+    if (subscribe_tag & 0x0002) size += 6;  // 加速度含重力
+    if (subscribe_tag & 0x0004) size += 6;  // 角速度
+    if (subscribe_tag & 0x0008) size += 6;  // 磁力计
+    if (subscribe_tag & 0x0010) size += 8;  // 温度气压高度
+    if (subscribe_tag & 0x0020) size += 8;  // 四元数
+    if (subscribe_tag & 0x0040) size += 6;  // 欧拉角
+    return size;
+}
+
+int sensorFrameBytes(uint16_t subscribe_tag) {
+    return 50 + 3 + sensorPayloadBytes(subscribe_tag) + 1 + 1;
+}
+
+const std::vector<int>& standardBaudrates() {
+    static const std::vector<int> rates = {
+        9600, 19200, 38400, 57600, 115200, 230400, 460800, 500000,
+        921600, 1000000, 1500000, 2000000, 3000000
+    };
+    return rates;
+}
+
+ThroughputPlan evaluateThroughput(uint16_t subscribe_tag, int report_rate, int baudrate,
+                                  double min_headroom) {
+    ThroughputPlan plan;
+    plan.baudrate = baudrate;
+    plan.frame_bytes = sensorFrameBytes(subscribe_tag);
+    plan.max_rate_hz = (baudrate / 10.0) / plan.frame_bytes;
+    // report_rate=0 表示 0.5Hz
+    double rate = report_rate > 0 ? report_rate : 0.5;
+    plan.load = plan.max_rate_hz > 0 ? rate / plan.max_rate_hz : 1.0;
+    plan.headroom = 1.0 - plan.load;
+    plan.feasible = plan.headroom >= min_headroom;
+    return plan;
+}
+
+ThroughputPlan planBaudrate(uint16_t subscribe_tag, int report_rate, double min_headroom,
+                            const std::vector<int>& candidates) {
+    std::vector<int> sorted = candidates;
+    std::sort(sorted.begin(), sorted.end());
+
+    ThroughputPlan plan;
+    for (int baudrate : sorted) {
+        plan = evaluateThroughput(subscribe_tag, report_rate, baudrate, min_headroom);
+        if (plan.feasible) {
+            return plan;
+        }
+    }
+    return plan;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file trace.cpp
+ * @brief Chrome trace 格式的流水线耗时跟踪实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   每个线程首次记录事件时分配环形缓冲并注册到全局列表，记录过程无锁。
+ *   dump() 读取各缓冲的写入计数后输出最近的事件；若写出期间某线程恰好绕回覆盖，
+ *   个别事件可能不完整，这对耗时分析可以接受。
+ */
+#include "trace.h"
+#include "async_logger.h"
+#include <chrono>
+
+#ifdef IMU_ENABLE_TRACE
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// 单线程事件缓冲
+struct TraceBuffer {
+    uint32_t tid = 0;
+    std::atomic<uint64_t> count{0};
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+};
+
+std::mutex& buffersMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<std::shared_ptr<TraceBuffer>>& buffers() {
+    static std::vector<std::shared_ptr<TraceBuffer>> list;
+    return list;
+}
+
+TraceBuffer* threadBuffer() {
+    thread_local std::shared_ptr<TraceBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<TraceBuffer>();
+        std::lock_guard<std::mutex> lock(buffersMutex());
+        buffer->tid = static_cast<uint32_t>(buffers().size() + 1);
+        buffers().push_back(buffer);
+    }
+    return buffer.get();
+}
+
+// 转义 JSON 字符串
+std::string escapeJson(const char* s) {
+    std::string out;
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            out += '\\';
+        }
+        out += *s;
+    }
+    return out;
+}
+
+} // namespace
+
+bool Tracer::compiledIn() {
+    return true;
+}
+
+void Tracer::record(const char* name, uint64_t begin_ns, uint64_t duration_ns) {
+    TraceBuffer* buffer = threadBuffer();
+    uint64_t index = buffer->count.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[index & (TRACE_BUFFER_EVENTS - 1)];
+    event.name = name;
+    event.begin_ns = begin_ns;
+    event.duration_ns = duration_ns;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::dump(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR("无法写入跟踪文件: {}", filename);
+        return false;
+    }
+
+    std::vector<std::shared_ptr<TraceBuffer>> list;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex());
+        list = buffers();
+    }
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t written = 0;
+    for (const auto& buffer : list) {
+        uint64_t end = buffer->count.load(std::memory_order_acquire);
+        uint64_t begin = end > TRACE_BUFFER_EVENTS ? end - TRACE_BUFFER_EVENTS : 0;
+        for (uint64_t i = begin; i < end; i++) {
+            const TraceEvent& event = buffer->events[i & (TRACE_BUFFER_EVENTS - 1)];
+            if (!first) {
+                file << ",\n";
+            }
+            first = false;
+            // Chrome trace 时间单位为微秒
+            file << "{\"name\":\"" << escapeJson(event.name) << "\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"ts\":" << event.begin_ns / 1000 << "." << (event.begin_ns % 1000) / 100;
+            if (event.duration_ns > 0) {
+                file << ",\"ph\":\"X\",\"dur\":" << event.duration_ns / 1000 << "."
+                     << (event.duration_ns % 1000) / 100;
+            } else {
+                file << ",\"ph\":\"i\",\"s\":\"t\"";
+            }
+            file << "}";
+            written++;
+        }
+    }
+    file << "\n]}\n";
+
+    LOG_INFO("跟踪数据已写出: {} ({} 个事件)", filename, written);
+    return true;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(buffersMutex());
+    for (const auto& buffer : buffers()) {
+        buffer->count.store(0, std::memory_order_release);
+    }
+}
+
+#else
+
+bool Tracer::compiledIn() {
+    return false;
+}
+
+void Tracer::record(const char*, uint64_t, uint64_t) {
+}
+
+bool Tracer::dump(const std::string& filename) {
+    LOG_WARN("未启用跟踪支持 (IMU_ENABLE_TRACE)，忽略跟踪输出: {}", filename);
+    return false;
+}
+
+void Tracer::clear() {
+}
+
+#endif // IMU_ENABLE_TRACE
+
+uint64_t Tracer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
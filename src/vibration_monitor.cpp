@@ -0,0 +1,369 @@
+/**
+ * @file vibration_monitor.cpp
+ * @brief 加速度振动频谱监测实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   单边均方谱 ms[k] = c·|X[k]|² / (N·Σw²)，c 在 0 与 Nyquist 处为 1、其余为 2，
+ *   频带能量为中心频率落在 [low, high) 内各频点之和，输出其平方根（RMS）。
+ *   峰值取平均幅度谱的局部极大，在对数幅度上做三点抛物线插值，
+ *   正弦幅值 A = 2|X| / Σw（Hann 窗频点间的扇贝损失约由插值补偿）。
+ */
+#include "vibration_monitor.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+}
+
+std::vector<VibrationBandRange> parseVibrationBands(const std::string& text) {
+    std::vector<VibrationBandRange> bands;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(0, item.find_first_not_of(" \t"));
+        item.erase(item.find_last_not_of(" \t") + 1);
+        if (item.empty()) {
+            continue;
+        }
+        size_t dash = item.find('-', 1);
+        try {
+            if (dash == std::string::npos) {
+                throw std::invalid_argument(item);
+            }
+            VibrationBandRange band;
+            band.low_hz = std::stof(item.substr(0, dash));
+            band.high_hz = std::stof(item.substr(dash + 1));
+            if (band.low_hz < 0.0f || band.high_hz <= band.low_hz) {
+                throw std::invalid_argument(item);
+            }
+            bands.push_back(band);
+        } catch (const std::exception&) {
+            LOG_WARN("警告: 忽略无效的振动频带: {}", item);
+        }
+    }
+    return bands;
+}
+
+VibrationMonitor::VibrationMonitor()
+    : sample_rate_(0.0)
+    , fft_size_(0)
+    , hop_(1)
+    , count_(0)
+    , since_frame_(0)
+    , generation_(0)
+    , handoff_timestamp_(0)
+    , handoff_sample_rate_(0.0)
+    , handoff_generation_(0)
+    , handoff_ready_(false)
+    , dropped_frames_(0)
+    , window_power_(0.0)
+    , window_sum_(0.0)
+    , mean_square_{}
+    , running_(false) {
+}
+
+VibrationMonitor::~VibrationMonitor() {
+    stop();
+}
+
+bool VibrationMonitor::start(const VibrationConfig& config, double sample_rate) {
+    stop();
+    if (!RealFFT::isPowerOfTwo(config.fft_size) || config.fft_size > VIBRATION_MAX_FFT) {
+        LOG_ERROR("振动监测 fft_size 必须为 4 到 {} 之间的 2 的幂: {}", VIBRATION_MAX_FFT, config.fft_size);
+        return false;
+    }
+    if (sample_rate <= 0.0) {
+        LOG_ERROR("振动监测采样率无效");
+        return false;
+    }
+
+    config_ = config;
+    sample_rate_ = sample_rate;
+    fft_size_ = config.fft_size;
+    float overlap = std::min(std::max(config.overlap, 0.0f), 0.9f);
+    hop_ = std::max(1, static_cast<int>(std::lround(fft_size_ * (1.0f - overlap))));
+
+    // 所有缓冲在读取线程运行前一次分配
+    for (int axis = 0; axis < VIBRATION_AXES; axis++) {
+        ring_[axis].assign(2 * fft_size_, 0.0f);
+        handoff_[axis].assign(fft_size_, 0.0f);
+        power_[axis].assign(fft_size_ / 2 + 1, 0.0);
+        mean_square_[axis] = 0.0;
+    }
+    count_ = 0;
+    since_frame_ = 0;
+    generation_ = 0;
+    handoff_ready_ = false;
+    dropped_frames_ = 0;
+
+    fft_.reset(new RealFFT(fft_size_));
+    window_.resize(fft_size_);
+    window_power_ = 0.0;
+    window_sum_ = 0.0;
+    for (int i = 0; i < fft_size_; i++) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * i / fft_size_));
+        window_power_ += static_cast<double>(window_[i]) * window_[i];
+        window_sum_ += window_[i];
+    }
+    frame_.resize(fft_size_);
+    bins_.resize(fft_size_ / 2 + 1);
+    std::atomic_store(&spectrum_, std::shared_ptr<const VibrationSpectrum>());
+
+    LOG_INFO("振动监测: fft_size={} hop={} 分辨率={:.3f} Hz 发布间隔={} ms", fft_size_, hop_,
+             sample_rate_ / fft_size_, config_.publish_interval_ms);
+
+    running_ = true;
+    worker_thread_ = std::thread(&VibrationMonitor::workerThread, this);
+    return true;
+}
+
+void VibrationMonitor::stop() {
+    if (!running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(handoff_mutex_);
+        running_ = false;
+    }
+    handoff_cv_.notify_one();
+    if (worker_thread_.joinable()) {
+        worker_thread_.join();
+    }
+}
+
+void VibrationMonitor::restart() {
+    count_ = 0;
+    since_frame_ = 0;
+    generation_++;
+}
+
+void VibrationMonitor::setSampleRate(double sample_rate) {
+    if (sample_rate <= 0.0 || sample_rate == sample_rate_) {
+        return;
+    }
+    sample_rate_ = sample_rate;
+    restart();
+}
+
+void VibrationMonitor::addSample(const IMUData& data) {
+    if (!running_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    float a[VIBRATION_AXES];
+    if (data.subscribe_tag & 0x0002) {
+        a[0] = data.accel_with_gravity_x;
+        a[1] = data.accel_with_gravity_y;
+        a[2] = data.accel_with_gravity_z;
+    } else if (data.subscribe_tag & 0x0001) {
+        a[0] = data.accel_x;
+        a[1] = data.accel_y;
+        a[2] = data.accel_z;
+    } else {
+        return;
+    }
+
+    size_t pos = static_cast<size_t>(count_ % fft_size_);
+    for (int axis = 0; axis < VIBRATION_AXES; axis++) {
+        ring_[axis][pos] = a[axis];
+        ring_[axis][pos + fft_size_] = a[axis];
+    }
+    count_++;
+    since_frame_++;
+
+    if (count_ < static_cast<uint64_t>(fft_size_) || since_frame_ < hop_) {
+        return;
+    }
+    since_frame_ = 0;
+
+    // 最新一帧为 ring_[pos + 1, pos + fft_size_]
+    std::unique_lock<std::mutex> lock(handoff_mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || handoff_ready_) {
+        dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    for (int axis = 0; axis < VIBRATION_AXES; axis++) {
+        std::copy_n(ring_[axis].data() + pos + 1, fft_size_, handoff_[axis].data());
+    }
+    handoff_timestamp_ = data.timestamp;
+    handoff_sample_rate_ = sample_rate_;
+    handoff_generation_ = generation_;
+    handoff_ready_ = true;
+    lock.unlock();
+    handoff_cv_.notify_one();
+}
+
+void VibrationMonitor::workerThread() {
+    std::vector<float> local[VIBRATION_AXES];
+    for (auto& axis : local) {
+        axis.resize(fft_size_);
+    }
+    const int half = fft_size_ / 2;
+    double sample_rate = 0.0;       // 随每帧交接，sample_rate_ 只属于读取线程
+    bool has_period = false;
+    uint32_t period_start = 0;
+    uint32_t generation = 0;
+    uint32_t frames = 0;
+    uint64_t elapsed_ns = 0;
+
+    while (true) {
+        uint32_t timestamp;
+        double frame_rate;
+        uint32_t frame_generation;
+        {
+            std::unique_lock<std::mutex> lock(handoff_mutex_);
+            handoff_cv_.wait(lock, [this] { return handoff_ready_ || !running_; });
+            if (!running_) {
+                return;
+            }
+            for (int axis = 0; axis < VIBRATION_AXES; axis++) {
+                local[axis].swap(handoff_[axis]);
+            }
+            timestamp = handoff_timestamp_;
+            frame_rate = handoff_sample_rate_;
+            frame_generation = handoff_generation_;
+            handoff_ready_ = false;
+        }
+
+        // 采样率变化：旧频率下累加的功率谱不能与新帧平均，从新帧开始新的发布周期
+        if (frame_rate != sample_rate) {
+            sample_rate = frame_rate;
+            for (int axis = 0; axis < VIBRATION_AXES; axis++) {
+                std::fill(power_[axis].begin(), power_[axis].end(), 0.0);
+                mean_square_[axis] = 0.0;
+            }
+            has_period = false;
+            frames = 0;
+            elapsed_ns = 0;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int axis = 0; axis < VIBRATION_AXES; axis++) {
+            const float* x = local[axis].data();
+            double mean = 0.0;
+            for (int i = 0; i < fft_size_; i++) {
+                mean += x[i];
+            }
+            mean /= fft_size_;
+            double ms = 0.0;
+            for (int i = 0; i < fft_size_; i++) {
+                float v = static_cast<float>(x[i] - mean);
+                ms += static_cast<double>(v) * v;
+                frame_[i] = v * window_[i];
+            }
+            mean_square_[axis] += ms / fft_size_;
+
+            fft_->forward(frame_.data(), bins_.data());
+            double* power = power_[axis].data();
+            for (int k = 0; k <= half; k++) {
+                power[k] += std::norm(bins_[k]);
+            }
+        }
+        elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        frames++;
+
+        // 读取线程重新积累过（时间戳可能已重新计数）或时间戳回退时，从本帧重新计时，已累加的帧保留
+        int32_t delta = static_cast<int32_t>(timestamp - period_start);
+        if (!has_period || frame_generation != generation || delta < 0) {
+            has_period = true;
+            generation = frame_generation;
+            period_start = timestamp;
+            delta = 0;
+        }
+        if (delta >= config_.publish_interval_ms) {
+            publish(timestamp, frames, elapsed_ns, sample_rate);
+            period_start = timestamp;
+            frames = 0;
+            elapsed_ns = 0;
+        }
+    }
+}
+
+void VibrationMonitor::publish(uint32_t timestamp, uint32_t frames, uint64_t elapsed_ns, double sample_rate) {
+    const int half = fft_size_ / 2;
+    const double resolution = sample_rate / fft_size_;
+
+    auto result = std::make_shared<VibrationSpectrum>();
+    result->timestamp = timestamp;
+    result->sample_rate = static_cast<float>(sample_rate);
+    result->fft_size = fft_size_;
+    result->resolution_hz = static_cast<float>(resolution);
+    result->frames = frames;
+    result->dropped_frames = dropped_frames_.load(std::memory_order_relaxed);
+    result->fft_us = frames > 0 ? static_cast<float>(elapsed_ns / 1000.0 / frames) : 0.0f;
+    result->bands = config_.bands;
+
+    for (int axis = 0; axis < VIBRATION_AXES; axis++) {
+        std::vector<double>& power = power_[axis];
+        for (int k = 0; k <= half; k++) {
+            power[k] /= frames;
+        }
+        result->rms[axis] = static_cast<float>(std::sqrt(mean_square_[axis] / frames));
+
+        // 频带能量
+        double scale = 1.0 / (fft_size_ * window_power_);
+        result->band_rms[axis].assign(config_.bands.size(), 0.0f);
+        for (size_t b = 0; b < config_.bands.size(); b++) {
+            int first = static_cast<int>(std::ceil(config_.bands[b].low_hz / resolution));
+            int last = static_cast<int>(std::ceil(config_.bands[b].high_hz / resolution)) - 1;
+            double energy = 0.0;
+            for (int k = std::max(first, 0); k <= std::min(last, half); k++) {
+                energy += ((k == 0 || k == half) ? 1.0 : 2.0) * power[k] * scale;
+            }
+            result->band_rms[axis][b] = static_cast<float>(std::sqrt(energy));
+        }
+
+        // 峰值：局部极大中幅度最大的若干个
+        std::vector<VibrationPeak>& peaks = result->peaks[axis];
+        std::vector<float> peak_power;
+        for (int k = 1; k < half && config_.peaks > 0; k++) {
+            if (power[k] <= power[k - 1] || power[k] < power[k + 1] || power[k] <= 0.0) {
+                continue;
+            }
+            if (static_cast<int>(peaks.size()) == config_.peaks && power[k] <= peak_power.back()) {
+                continue;
+            }
+            double alpha = 0.5 * std::log(std::max(power[k - 1], 1e-30));
+            double beta = 0.5 * std::log(power[k]);
+            double gamma = 0.5 * std::log(std::max(power[k + 1], 1e-30));
+            double denom = alpha - 2.0 * beta + gamma;
+            double delta = denom < 0.0 ? 0.5 * (alpha - gamma) / denom : 0.0;
+            delta = std::min(std::max(delta, -0.5), 0.5);
+            double magnitude = std::exp(beta - 0.25 * (alpha - gamma) * delta);
+
+            VibrationPeak peak;
+            peak.frequency_hz = static_cast<float>((k + delta) * resolution);
+            peak.amplitude = static_cast<float>(2.0 * magnitude / window_sum_);
+
+            // 按功率降序插入
+            size_t index = 0;
+            while (index < peak_power.size() && peak_power[index] >= power[k]) {
+                index++;
+            }
+            peaks.insert(peaks.begin() + index, peak);
+            peak_power.insert(peak_power.begin() + index, static_cast<float>(power[k]));
+            if (static_cast<int>(peaks.size()) > config_.peaks) {
+                peaks.pop_back();
+                peak_power.pop_back();
+            }
+        }
+
+        std::fill(power.begin(), power.end(), 0.0);
+        mean_square_[axis] = 0.0;
+    }
+
+    std::atomic_store(&spectrum_, std::shared_ptr<const VibrationSpectrum>(result));
+    LOG_DEBUG("[振动] 帧数={} 耗时={:.1f} us/帧 RMS=({:.3f}, {:.3f}, {:.3f}) 主峰 Z={:.2f} Hz",
+              frames, result->fft_us, result->rms[0], result->rms[1], result->rms[2],
+              result->peaks[2].empty() ? 0.0f : result->peaks[2][0].frequency_hz);
+    if (callback_) {
+        callback_(*result);
+    }
+}
@@ -0,0 +1,480 @@
+/**
+ * @file virtual_imu.cpp
+ * @brief 多 IMU 阵列融合为单个虚拟 IMU 实现
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   设备外参只含旋转，不补偿安装位置偏移（杠杆臂）带来的向心/切向加速度，
+ *   板上各 IMU 间距较小且角速度不大时可以忽略。
+ *   外参非单位旋转时，欧拉角只有在订阅四元数时才正确（由合成四元数推导）。
+ *   网格落后最新样本超过 1 秒（如全部设备断开后恢复）时直接跳到最新时刻附近。
+ */
+#include "virtual_imu.h"
+#include "field_derivation.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 字段组：起始字段、字段数、离群检测下限（0 = 不做离群检测）
+struct FieldGroup {
+    int first;
+    int count;
+    float VirtualIMUConfig::* floor;
+};
+
+constexpr int GROUP_COUNT = 7;
+constexpr int QUAT_FIELD = 15;
+constexpr int EULER_FIELD = 19;
+
+const FieldGroup GROUPS[GROUP_COUNT] = {
+    {0, 3, &VirtualIMUConfig::accel_floor},
+    {3, 3, &VirtualIMUConfig::accel_floor},
+    {6, 3, &VirtualIMUConfig::gyro_floor},
+    {9, 3, &VirtualIMUConfig::mag_floor},
+    {12, 3, nullptr},
+    {QUAT_FIELD, 4, &VirtualIMUConfig::quat_floor},
+    {EULER_FIELD, 3, nullptr},
+};
+
+// 角度差折回 [-180, 180)
+inline float wrapDegrees(float a) {
+    return a - 360.0f * std::floor((a + 180.0f) / 360.0f);
+}
+
+// n 个值的中位数（n ≤ VIRTUAL_IMU_MAX_DEVICES，会重排 v）
+inline float median(float* v, int n) {
+    std::sort(v, v + n);
+    return (n & 1) ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+}
+
+inline void rotateField(const Quatf& q, float* values, int first) {
+    Vec3f v = rotate(q, Vec3f{values[first], values[first + 1], values[first + 2]});
+    values[first] = v.x;
+    values[first + 1] = v.y;
+    values[first + 2] = v.z;
+}
+
+} // namespace
+
+VirtualIMU::VirtualIMU(const VirtualIMUConfig& config)
+    : config_(config)
+    , period_us_(static_cast<int64_t>(std::llround(1e6 / (config.output_rate > 0 ? config.output_rate : 200.0))))
+    , device_count_(0)
+    , pending_(0)
+    , has_tick_(false)
+    , next_tick_us_(0)
+    , outputs_(0)
+    , ahrs_(config.ahrs) {
+}
+
+int VirtualIMU::addDevice(const Quatf& extrinsic, float weight) {
+    if (device_count_ >= VIRTUAL_IMU_MAX_DEVICES) {
+        return -1;
+    }
+    Device& device = devices_[device_count_];
+    device.extrinsic = normalized(extrinsic);
+    device.weight = std::max(weight, 0.0f);
+    return device_count_++;
+}
+
+void VirtualIMU::attach(IMUReader& reader, int device) {
+    reader.setTimedDataCallback([this, device](const IMUData& data, uint64_t host_time_us) {
+        push(device, data, host_time_us);
+    });
+}
+
+void VirtualIMU::setTimeOffset(int device, int64_t offset_us) {
+    if (device >= 0 && device < device_count_) {
+        devices_[device].offset_us.store(offset_us, std::memory_order_relaxed);
+    }
+}
+
+int64_t VirtualIMU::timeOffset(int device) const {
+    if (device < 0 || device >= device_count_) {
+        return 0;
+    }
+    return devices_[device].offset_us.load(std::memory_order_relaxed);
+}
+
+bool VirtualIMU::startLatencyEstimation(const LatencyEstimatorConfig& config) {
+    latency_estimator_.setOffsetCallback([this](int device, int64_t offset_us) {
+        setTimeOffset(device, offset_us);
+    });
+    return latency_estimator_.start(config, device_count_);
+}
+
+VirtualIMUDeviceStats VirtualIMU::deviceStats(int device) const {
+    VirtualIMUDeviceStats stats;
+    if (device < 0 || device >= device_count_) {
+        return stats;
+    }
+    const Device& d = devices_[device];
+    stats.samples = d.samples.load(std::memory_order_relaxed);
+    stats.overflows = d.overflows.load(std::memory_order_relaxed);
+    stats.contributions = d.contributions.load(std::memory_order_relaxed);
+    stats.rejections = d.rejections.load(std::memory_order_relaxed);
+    stats.stale = d.stale.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void VirtualIMU::push(int index, const IMUData& data, uint64_t host_time_us) {
+    if (index < 0 || index >= device_count_) {
+        return;
+    }
+    Device& device = devices_[index];
+    device.samples.fetch_add(1, std::memory_order_relaxed);
+    // 延迟估计使用未修正的主机时间
+    latency_estimator_.push(index, data, host_time_us);
+
+    // 时间修正后须严格递增，修正量变化造成的回退样本直接丢弃
+    int64_t time_us = static_cast<int64_t>(host_time_us) + device.offset_us.load(std::memory_order_relaxed);
+    uint64_t head = device.head.load(std::memory_order_relaxed);
+    uint64_t tail = device.tail.load(std::memory_order_acquire);
+    if (head != tail && time_us <= device.newest_us.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (head - tail >= VIRTUAL_IMU_RING) {
+        device.overflows.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        Slot& slot = device.ring[head & (VIRTUAL_IMU_RING - 1)];
+        slot.data = data;
+        slot.time_us = time_us;
+        device.newest_us.store(time_us, std::memory_order_relaxed);
+        device.head.store(head + 1, std::memory_order_release);
+    }
+
+    // 合成由拿到锁的线程完成；持有者释放后会重新检查 pending_，不会遗漏
+    pending_.fetch_add(1, std::memory_order_release);
+    while (pending_.load(std::memory_order_acquire) != 0) {
+        std::unique_lock<std::mutex> lock(combine_mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;
+        }
+        pending_.store(0, std::memory_order_relaxed);
+        combineReady();
+    }
+}
+
+void VirtualIMU::combineReady() {
+    const int64_t max_wait_us = static_cast<int64_t>(config_.max_wait_ms) * 1000;
+
+    while (true) {
+        // 各设备最新样本时刻
+        int64_t newest[VIRTUAL_IMU_MAX_DEVICES];
+        bool has_data[VIRTUAL_IMU_MAX_DEVICES];
+        int64_t now = std::numeric_limits<int64_t>::min();
+        for (int d = 0; d < device_count_; d++) {
+            Device& device = devices_[d];
+            uint64_t head = device.head.load(std::memory_order_acquire);
+            has_data[d] = head != device.tail.load(std::memory_order_relaxed);
+            newest[d] = has_data[d] ? device.ring[(head - 1) & (VIRTUAL_IMU_RING - 1)].time_us : 0;
+            if (has_data[d]) {
+                now = std::max(now, newest[d]);
+            }
+        }
+        if (now == std::numeric_limits<int64_t>::min()) {
+            return;
+        }
+
+        // 网格起点：等所有设备都有样本（或超时）后，从最晚开始的设备的首个样本之后开始
+        if (!has_tick_) {
+            int64_t start = std::numeric_limits<int64_t>::min();
+            int64_t earliest = std::numeric_limits<int64_t>::max();
+            bool all = true;
+            for (int d = 0; d < device_count_; d++) {
+                if (!has_data[d]) {
+                    all = false;
+                    continue;
+                }
+                int64_t first = devices_[d].ring[devices_[d].tail.load(std::memory_order_relaxed) &
+                                                 (VIRTUAL_IMU_RING - 1)].time_us;
+                start = std::max(start, first);
+                earliest = std::min(earliest, first);
+            }
+            if (!all && now - earliest < max_wait_us) {
+                return;
+            }
+            next_tick_us_ = (start / period_us_ + 1) * period_us_;
+            has_tick_ = true;
+        }
+
+        // 落后过多时跳到最新时刻附近
+        if (now - next_tick_us_ > 1000000) {
+            next_tick_us_ = ((now - max_wait_us) / period_us_) * period_us_;
+        }
+
+        int64_t tick = next_tick_us_;
+        bool usable[VIRTUAL_IMU_MAX_DEVICES];
+        bool any = false;
+        for (int d = 0; d < device_count_; d++) {
+            if (has_data[d] && newest[d] >= tick) {
+                usable[d] = true;
+                any = true;
+            } else if (now - tick >= max_wait_us) {
+                usable[d] = false;
+            } else {
+                return;  // 等待该设备
+            }
+        }
+        if (!any) {
+            return;
+        }
+        for (int d = 0; d < device_count_; d++) {
+            if (!usable[d]) {
+                // 超时的设备同样释放旧样本，恢复后可立即重新参与
+                release(devices_[d], tick);
+                devices_[d].stale.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        emit(tick, usable);
+        next_tick_us_ += period_us_;
+    }
+}
+
+void VirtualIMU::release(Device& device, int64_t tick_us) {
+    uint64_t head = device.head.load(std::memory_order_acquire);
+    uint64_t tail = device.tail.load(std::memory_order_relaxed);
+    while (tail + 1 < head && device.ring[(tail + 1) & (VIRTUAL_IMU_RING - 1)].time_us <= tick_us) {
+        tail++;
+    }
+    device.tail.store(tail, std::memory_order_release);
+}
+
+bool VirtualIMU::sampleAt(Device& device, int64_t tick_us, float* values, uint16_t& tag) {
+    release(device, tick_us);
+    uint64_t head = device.head.load(std::memory_order_acquire);
+    uint64_t tail = device.tail.load(std::memory_order_relaxed);
+
+    const Slot& a = device.ring[tail & (VIRTUAL_IMU_RING - 1)];
+    if (a.time_us > tick_us) {
+        return false;
+    }
+    for (int c = 0; c < IMU_FLOAT_FIELDS; c++) {
+        values[c] = a.data.*IMU_FIELD_MEMBERS[c];
+    }
+    tag = a.data.subscribe_tag;
+
+    if (a.time_us < tick_us && tail + 1 < head) {
+        const Slot& b = device.ring[(tail + 1) & (VIRTUAL_IMU_RING - 1)];
+        float f = static_cast<float>(tick_us - a.time_us) / static_cast<float>(b.time_us - a.time_us);
+        float next[IMU_FLOAT_FIELDS];
+        for (int c = 0; c < IMU_FLOAT_FIELDS; c++) {
+            next[c] = b.data.*IMU_FIELD_MEMBERS[c];
+        }
+        // 四元数同号、欧拉角展开后再插值
+        float sign = (values[15] * next[15] + values[16] * next[16] + values[17] * next[17] +
+                      values[18] * next[18]) < 0.0f ? -1.0f : 1.0f;
+        for (int c = QUAT_FIELD; c < QUAT_FIELD + 4; c++) {
+            next[c] *= sign;
+        }
+        for (int c = EULER_FIELD; c < EULER_FIELD + 3; c++) {
+            next[c] = values[c] + wrapDegrees(next[c] - values[c]);
+        }
+        for (int c = 0; c < IMU_FLOAT_FIELDS; c++) {
+            values[c] += (next[c] - values[c]) * f;
+        }
+        for (int c = EULER_FIELD; c < EULER_FIELD + 3; c++) {
+            values[c] = wrapDegrees(values[c]);
+        }
+        tag &= b.data.subscribe_tag;
+    }
+
+    // 旋转到虚拟机体系；姿态为 虚拟机体 -> 世界 = q_device ⊗ extrinsic⁻¹
+    const Quatf& e = device.extrinsic;
+    if (e.w < 1.0f) {
+        rotateField(e, values, 0);
+        rotateField(e, values, 3);
+        rotateField(e, values, 6);
+        rotateField(e, values, 9);
+        Quatf q = Quatf{values[15], values[16], values[17], values[18]} * conjugate(e);
+        values[15] = q.w;
+        values[16] = q.x;
+        values[17] = q.y;
+        values[18] = q.z;
+    }
+    return true;
+}
+
+void VirtualIMU::fuseOrientation(float (*x)[VIRTUAL_IMU_MAX_DEVICES], const int* members, int n, uint16_t* tags) {
+    static_assert(VIRTUAL_IMU_MAX_DEVICES == AHRS_BATCH_LANES, "每个设备对应一个姿态融合通道");
+
+    // 未参与或缺少含重力加速度 / 角速度的设备步长为 0，保持原姿态
+    alignas(32) float dt[AHRS_BATCH_LANES] = {};
+    const float step = static_cast<float>(period_us_) * 1e-6f;
+    for (int i = 0; i < n; i++) {
+        int d = members[i];
+        if ((tags[d] & 0x0006) == 0x0006) {
+            dt[d] = step;
+            tags[d] |= 0x0060;
+        }
+    }
+
+    alignas(32) float gx[AHRS_BATCH_LANES];
+    alignas(32) float gy[AHRS_BATCH_LANES];
+    alignas(32) float gz[AHRS_BATCH_LANES];
+    for (int d = 0; d < AHRS_BATCH_LANES; d++) {
+        gx[d] = x[6][d] * DEG_TO_RAD;
+        gy[d] = x[7][d] * DEG_TO_RAD;
+        gz[d] = x[8][d] * DEG_TO_RAD;
+    }
+    // 未订阅磁场的设备磁场分量为 0，该通道按六轴更新
+    const bool use_mag = config_.ahrs.use_mag;
+    ahrs_.update(gx, gy, gz, x[3], x[4], x[5],
+                 use_mag ? x[9] : nullptr, use_mag ? x[10] : nullptr, use_mag ? x[11] : nullptr, dt);
+
+    for (int i = 0; i < n; i++) {
+        int d = members[i];
+        if (dt[d] > 0.0f) {
+            Quatf q = ahrs_.orientation(d);
+            x[QUAT_FIELD][d] = q.w;
+            x[QUAT_FIELD + 1][d] = q.x;
+            x[QUAT_FIELD + 2][d] = q.y;
+            x[QUAT_FIELD + 3][d] = q.z;
+        }
+    }
+}
+
+bool VirtualIMU::emit(int64_t tick_us, const bool* usable) {
+    // [字段][设备] 结构数组，未参与的设备权重为 0
+    float x[IMU_FLOAT_FIELDS][VIRTUAL_IMU_MAX_DEVICES] = {};
+    float w[GROUP_COUNT][VIRTUAL_IMU_MAX_DEVICES] = {};
+    bool rejected[VIRTUAL_IMU_MAX_DEVICES] = {};
+    uint16_t tags[VIRTUAL_IMU_MAX_DEVICES] = {};
+    int members[VIRTUAL_IMU_MAX_DEVICES];
+    int n = 0;
+
+    for (int d = 0; d < device_count_; d++) {
+        float values[IMU_FLOAT_FIELDS];
+        if (!usable[d] || !sampleAt(devices_[d], tick_us, values, tags[d])) {
+            continue;
+        }
+        for (int c = 0; c < IMU_FLOAT_FIELDS; c++) {
+            x[c][d] = values[c];
+        }
+        for (int g = 0; g < GROUP_COUNT; g++) {
+            w[g][d] = devices_[d].weight;
+        }
+        members[n++] = d;
+    }
+    if (n == 0) {
+        return false;
+    }
+
+    if (ahrs_.enabled()) {
+        fuseOrientation(x, members, n, tags);
+    }
+    uint16_t tag = 0xFFFF;
+    for (int i = 0; i < n; i++) {
+        tag &= tags[members[i]];
+    }
+
+    // 四元数与第一个设备同号，欧拉角相对第一个设备展开
+    int ref = members[0];
+    for (int i = 1; i < n; i++) {
+        int d = members[i];
+        float dot = 0.0f;
+        for (int c = QUAT_FIELD; c < QUAT_FIELD + 4; c++) {
+            dot += x[c][d] * x[c][ref];
+        }
+        if (dot < 0.0f) {
+            for (int c = QUAT_FIELD; c < QUAT_FIELD + 4; c++) {
+                x[c][d] = -x[c][d];
+            }
+        }
+        for (int c = EULER_FIELD; c < EULER_FIELD + 3; c++) {
+            x[c][d] = x[c][ref] + wrapDegrees(x[c][d] - x[c][ref]);
+        }
+    }
+
+    // 离群剔除：至少 3 个设备时，以分量中位数为参考、偏离距离的中位数 (MAD) 为尺度
+    if (n >= 3) {
+        for (int g = 0; g < GROUP_COUNT; g++) {
+            const FieldGroup& group = GROUPS[g];
+            if (group.floor == nullptr) {
+                continue;
+            }
+            float med[4];
+            for (int k = 0; k < group.count; k++) {
+                float column[VIRTUAL_IMU_MAX_DEVICES];
+                for (int i = 0; i < n; i++) {
+                    column[i] = x[group.first + k][members[i]];
+                }
+                med[k] = median(column, n);
+            }
+            float dist[VIRTUAL_IMU_MAX_DEVICES];
+            float sorted[VIRTUAL_IMU_MAX_DEVICES];
+            for (int i = 0; i < n; i++) {
+                float sum = 0.0f;
+                for (int k = 0; k < group.count; k++) {
+                    float diff = x[group.first + k][members[i]] - med[k];
+                    sum += diff * diff;
+                }
+                dist[i] = sorted[i] = std::sqrt(sum);
+            }
+            float threshold = std::max(config_.outlier_mad * 1.4826f * median(sorted, n), config_.*group.floor);
+            for (int i = 0; i < n; i++) {
+                if (dist[i] > threshold) {
+                    w[g][members[i]] = 0.0f;
+                    rejected[members[i]] = true;
+                }
+            }
+        }
+    }
+
+    // 加权平均
+    float out[IMU_FLOAT_FIELDS];
+    for (int g = 0; g < GROUP_COUNT; g++) {
+        const FieldGroup& group = GROUPS[g];
+        float den = 0.0f;
+        for (int d = 0; d < VIRTUAL_IMU_MAX_DEVICES; d++) {
+            den += w[g][d];
+        }
+        float inv = den > 0.0f ? 1.0f / den : 0.0f;
+        for (int c = group.first; c < group.first + group.count; c++) {
+            float num = 0.0f;
+            for (int d = 0; d < VIRTUAL_IMU_MAX_DEVICES; d++) {
+                num += w[g][d] * x[c][d];
+            }
+            out[c] = num * inv;
+        }
+    }
+
+    IMUData data;
+    for (int c = 0; c < IMU_FLOAT_FIELDS; c++) {
+        data.*IMU_FIELD_MEMBERS[c] = out[c];
+    }
+    Quatf q = normalized(Quatf{data.quat_w, data.quat_x, data.quat_y, data.quat_z});
+    data.quat_w = q.w;
+    data.quat_x = q.x;
+    data.quat_y = q.y;
+    data.quat_z = q.z;
+    data.euler_x = wrapDegrees(data.euler_x);
+    data.euler_y = wrapDegrees(data.euler_y);
+    data.euler_z = wrapDegrees(data.euler_z);
+    data.timestamp = static_cast<uint32_t>(tick_us / 1000);
+    data.subscribe_tag = tag;
+    if ((tag & 0x0060) == 0x0060) {
+        deriveFields(data, 0x0040);
+    }
+
+    for (int i = 0; i < n; i++) {
+        Device& device = devices_[members[i]];
+        device.contributions.fetch_add(1, std::memory_order_relaxed);
+        if (rejected[members[i]]) {
+            device.rejections.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    outputs_.fetch_add(1, std::memory_order_relaxed);
+
+    if (data_callback_) {
+        data_callback_(data);
+    }
+    if (timed_data_callback_) {
+        timed_data_callback_(data, static_cast<uint64_t>(tick_us));
+    }
+    return true;
+}
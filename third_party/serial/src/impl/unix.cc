@@ -21,6 +21,7 @@
 
 #if defined(__linux__)
 # include <linux/serial.h>
+# include <asm/ioctls.h>
 #endif
 
 #include <sys/select.h>
@@ -46,6 +47,40 @@
 #include <IOKit/serial/ioss.h>
 #endif
 
+#if defined(__linux__) && defined(TCGETS2) && defined(TCSETS2)
+// struct termios2 lives in <asm/termbits.h>, which clashes with <termios.h>,
+// so the kernel layout is declared here. BOTHER lets the driver program an
+// arbitrary rate (e.g. 250000 or 1.5M on USB adapters without a custom divisor).
+# define SERIAL_HAVE_TERMIOS2
+# ifndef BOTHER
+#  define BOTHER 0010000
+# endif
+struct termios2 {
+  tcflag_t c_iflag;
+  tcflag_t c_oflag;
+  tcflag_t c_cflag;
+  tcflag_t c_lflag;
+  cc_t c_line;
+  cc_t c_cc[19];
+  speed_t c_ispeed;
+  speed_t c_ospeed;
+};
+
+static bool
+set_termios2_baudrate (int fd, unsigned long baudrate)
+{
+  struct termios2 tio2;
+  if (-1 == ioctl (fd, TCGETS2, &tio2)) {
+    return false;
+  }
+  tio2.c_cflag &= (tcflag_t) ~CBAUD;
+  tio2.c_cflag |= BOTHER;
+  tio2.c_ispeed = static_cast<speed_t> (baudrate);
+  tio2.c_ospeed = static_cast<speed_t> (baudrate);
+  return -1 != ioctl (fd, TCSETS2, &tio2);
+}
+#endif
+
 using std::string;
 using std::stringstream;
 using std::invalid_argument;
@@ -314,8 +349,11 @@ Serial::SerialImpl::reconfigurePort ()
     if (-1 == ioctl (fd_, IOSSIOSPEED, &new_baud, 1)) {
       THROW (IOException, errno);
     }
-    // Linux Support
+#elif defined(SERIAL_HAVE_TERMIOS2)
+    // Linux Support: termios2/BOTHER is applied after tcsetattr below,
+    // with the serial_struct custom divisor as the fallback for old kernels
 #elif defined(__linux__) && defined (TIOCSSERIAL)
+    // Linux Support without termios2: serial_struct custom divisor
     struct serial_struct ser;
 
     if (-1 == ioctl (fd_, TIOCGSERIAL, &ser)) {
@@ -443,6 +481,28 @@ Serial::SerialImpl::reconfigurePort ()
   // activate settings
   ::tcsetattr (fd_, TCSANOW, &options);
 
+#if defined(SERIAL_HAVE_TERMIOS2)
+  if (custom_baud) {
+    // must come after tcsetattr, which would otherwise reset the speed bits
+    if (!set_termios2_baudrate (fd_, baudrate_)) {
+#if defined (TIOCSSERIAL)
+      struct serial_struct ser;
+      if (-1 == ioctl (fd_, TIOCGSERIAL, &ser)) {
+        THROW (IOException, errno);
+      }
+      ser.custom_divisor = ser.baud_base / static_cast<int> (baudrate_);
+      ser.flags &= ~ASYNC_SPD_MASK;
+      ser.flags |= ASYNC_SPD_CUST;
+      if (-1 == ioctl (fd_, TIOCSSERIAL, &ser)) {
+        THROW (IOException, errno);
+      }
+#else
+      THROW (IOException, errno);
+#endif
+    }
+  }
+#endif
+
   // Update byte_time_ based on the new settings.
   uint32_t bit_time_ns = 1e9 / baudrate_;
   byte_time_ns_ = bit_time_ns * (1 + bytesize_ + parity_ + stopbits_);
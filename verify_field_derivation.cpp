@@ -0,0 +1,273 @@
+/**
+ * @file verify_field_derivation.cpp
+ * @brief 主机端推导字段与设备输出字段的一致性验证
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   输入为串口原始字节记录（设备同时订阅四元数、含重力加速度与待比较字段，如 0x7F），
+ *   可用 stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > capture.bin 录制。
+ *   逐帧用 deriveFields() 由四元数 / 含重力加速度重新推导欧拉角与线加速度，
+ *   与同一帧中设备输出的字段比较，输出各轴 RMS / 最大误差，超出容差时返回 1。
+ *   俯仰角接近 ±90° 时横滚与航向不可观、俯仰角对四元数量化误差敏感，超过 --pitch-limit 的帧不比较欧拉角。
+ *   --synthetic 按设备定点格式生成随机姿态帧（无设备时检查推导公式与量化误差）：四元数由半角公式构造，
+ *   含重力加速度中的重力由欧拉角的旋转矩阵乘积求得，两条路径互相独立。
+ *   用法: verify_field_derivation <capture.bin> | --synthetic [--frames 100000]
+ *         [--euler-tol 0.1] [--accel-tol 0.05] [--pitch-limit 85]
+ */
+#include "field_derivation.h"
+#include "imu_frame_view.h"
+#include "imu_math.h"
+#include "imu_parser.h"
+#include "imu_raw_sample.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr U8 kAddress = 0x50;
+
+// 传感器数据帧：起始码 + 地址 + 长度 + 数据体 + 校验和 + 结束码
+void appendFrame(std::vector<U8>& stream, const U8* body, int len) {
+    U8 checksum = kAddress + static_cast<U8>(len);
+    stream.push_back(CMD_PACKET_BEGIN);
+    stream.push_back(kAddress);
+    stream.push_back(static_cast<U8>(len));
+    for (int i = 0; i < len; i++) {
+        stream.push_back(body[i]);
+        checksum += body[i];
+    }
+    stream.push_back(checksum);
+    stream.push_back(CMD_PACKET_END);
+}
+
+// 3x3 矩阵乘积 c = a * b
+void matMul(const double a[3][3], const double b[3][3], double c[3][3]) {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            c[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+        }
+    }
+}
+
+// 机体系中的重力：由欧拉角构造 R = Rz(航向) * Ry(俯仰) * Rx(横滚)（机体系到世界系），
+// 把世界系 (0, 0, g) 乘以 R 的转置得到，不经过四元数，与 deriveOne() 的推导路径独立
+void gravityInBody(double roll, double pitch, double yaw, double out[3]) {
+    const double rx[3][3] = {{1, 0, 0}, {0, std::cos(roll), -std::sin(roll)}, {0, std::sin(roll), std::cos(roll)}};
+    const double ry[3][3] = {{std::cos(pitch), 0, std::sin(pitch)}, {0, 1, 0}, {-std::sin(pitch), 0, std::cos(pitch)}};
+    const double rz[3][3] = {{std::cos(yaw), -std::sin(yaw), 0}, {std::sin(yaw), std::cos(yaw), 0}, {0, 0, 1}};
+    double ryx[3][3];
+    double r[3][3];
+    matMul(ry, rx, ryx);
+    matMul(rz, ryx, r);
+    for (int i = 0; i < 3; i++) {
+        out[i] = r[2][i] * DEVICE_GRAVITY;
+    }
+}
+
+void writeS16(U8* p, double value, float scale) {
+    long raw = std::lround(value / scale);
+    S16 v = static_cast<S16>(std::min(32767L, std::max(-32768L, raw)));
+    p[0] = static_cast<U8>(v & 0xFF);
+    p[1] = static_cast<U8>((static_cast<U16>(v) >> 8) & 0xFF);
+}
+
+// 随机姿态与线加速度，按设备定点格式生成 0x63（线加速度、含重力加速度、四元数、欧拉角）帧
+std::vector<U8> makeSyntheticCapture(size_t frames) {
+    constexpr uint16_t tag = 0x0063;
+    const int body_len = 7 + IMU_FRAME_OFFSETS.offset[tag][7];
+    std::mt19937 rng(20261017);
+    std::uniform_real_distribution<double> angle(-180.0, 180.0);
+    std::uniform_real_distribution<double> pitch(-89.0, 89.0);
+    std::uniform_real_distribution<double> linear(-3.0, 3.0);
+
+    std::vector<U8> stream;
+    stream.reserve(frames * (body_len + 5));
+    for (size_t f = 0; f < frames; f++) {
+        double roll = angle(rng) * DEG_TO_RAD, pit = pitch(rng) * DEG_TO_RAD, yaw = angle(rng) * DEG_TO_RAD;
+        // Z-Y-X：q = qz(航向) * qy(俯仰) * qx(横滚)
+        double cr = std::cos(roll / 2), sr = std::sin(roll / 2);
+        double cp = std::cos(pit / 2), sp = std::sin(pit / 2);
+        double cy = std::cos(yaw / 2), sy = std::sin(yaw / 2);
+        double w = cy * cp * cr + sy * sp * sr;
+        double x = cy * cp * sr - sy * sp * cr;
+        double y = cy * sp * cr + sy * cp * sr;
+        double z = sy * cp * cr - cy * sp * sr;
+        double lin[3] = {linear(rng), linear(rng), linear(rng)};
+        double gravity[3];
+        gravityInBody(roll, pit, yaw, gravity);
+
+        U8 body[7 + IMU_RAW_MAX_PAYLOAD] = {};
+        body[0] = 0x11;
+        body[1] = static_cast<U8>(tag);
+        body[2] = 0;
+        U32 timestamp = static_cast<U32>(f * 4);
+        memcpy(body + 3, &timestamp, 4);
+        U8* payload = body + 7;
+        for (int i = 0; i < 3; i++) {
+            writeS16(payload + IMU_FRAME_OFFSETS.offset[tag][0] + i * 2, lin[i], SCALE_ACCEL);
+            writeS16(payload + IMU_FRAME_OFFSETS.offset[tag][1] + i * 2, lin[i] + gravity[i], SCALE_ACCEL);
+        }
+        const double quat[4] = {w, x, y, z};
+        for (int i = 0; i < 4; i++) {
+            writeS16(payload + IMU_FRAME_OFFSETS.offset[tag][5] + i * 2, quat[i], SCALE_QUAT);
+        }
+        const double euler[3] = {roll * RAD_TO_DEG, pit * RAD_TO_DEG, yaw * RAD_TO_DEG};
+        for (int i = 0; i < 3; i++) {
+            writeS16(payload + IMU_FRAME_OFFSETS.offset[tag][6] + i * 2, euler[i], SCALE_ANGLE);
+        }
+        appendFrame(stream, body, body_len);
+    }
+    return stream;
+}
+
+// 单个字段的误差统计
+struct FieldError {
+    const char* name;
+    uint64_t samples = 0;
+    double sum_sq = 0.0;
+    double max_abs = 0.0;
+
+    void add(double error) {
+        samples++;
+        sum_sq += error * error;
+        max_abs = std::max(max_abs, std::fabs(error));
+    }
+    double rms() const { return samples > 0 ? std::sqrt(sum_sq / samples) : 0.0; }
+};
+
+// 角度差折算到 [-180, 180)
+double angleDiff(double a, double b) {
+    return std::fmod(a - b + 540.0, 360.0) - 180.0;
+}
+
+// 逐帧重新推导并与设备输出比较
+struct FieldComparison {
+    FieldError euler[3] = {{"euler_x"}, {"euler_y"}, {"euler_z"}};
+    FieldError accel[3] = {{"accel_x"}, {"accel_y"}, {"accel_z"}};
+    uint64_t frames = 0;
+    uint64_t skipped_gimbal = 0;
+    double pitch_limit;
+
+    explicit FieldComparison(double limit) : pitch_limit(limit) {}
+
+    void add(const IMUData& data) {
+        frames++;
+        const uint16_t tag = data.subscribe_tag;
+        if ((tag & 0x0060) == 0x0060) {
+            IMUData derived = data;
+            deriveFields(derived, 0x0040);
+            if (std::fabs(data.euler_y) <= pitch_limit) {
+                euler[0].add(angleDiff(derived.euler_x, data.euler_x));
+                euler[1].add(derived.euler_y - data.euler_y);
+                euler[2].add(angleDiff(derived.euler_z, data.euler_z));
+            } else {
+                skipped_gimbal++;
+            }
+        }
+        if ((tag & 0x0023) == 0x0023) {
+            IMUData derived = data;
+            deriveFields(derived, 0x0001);
+            accel[0].add(derived.accel_x - data.accel_x);
+            accel[1].add(derived.accel_y - data.accel_y);
+            accel[2].add(derived.accel_z - data.accel_z);
+        }
+    }
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string capture_file;
+    bool synthetic = false;
+    size_t synthetic_frames = 100000;
+    double euler_tol = 0.1;
+    double accel_tol = 0.05;
+    double pitch_limit = 85.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--synthetic") {
+            synthetic = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            synthetic_frames = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--euler-tol" && i + 1 < argc) {
+            euler_tol = std::atof(argv[++i]);
+        } else if (arg == "--accel-tol" && i + 1 < argc) {
+            accel_tol = std::atof(argv[++i]);
+        } else if (arg == "--pitch-limit" && i + 1 < argc) {
+            pitch_limit = std::atof(argv[++i]);
+        } else if (arg[0] != '-' && capture_file.empty()) {
+            capture_file = arg;
+        } else {
+            capture_file.clear();
+            synthetic = false;
+            break;
+        }
+    }
+    if (capture_file.empty() == !synthetic) {
+        std::cerr << "用法: " << argv[0] << " <capture.bin> | --synthetic [--frames 100000]"
+                  << " [--euler-tol 0.1] [--accel-tol 0.05] [--pitch-limit 85]" << std::endl;
+        return 1;
+    }
+
+    std::vector<U8> stream;
+    if (synthetic) {
+        stream = makeSyntheticCapture(synthetic_frames);
+    } else {
+        std::ifstream file(capture_file, std::ios::binary);
+        if (!file) {
+            std::cerr << "错误: 无法打开记录文件 " << capture_file << std::endl;
+            return 1;
+        }
+        stream.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::cout << "=== 推导字段一致性验证 ===" << std::endl;
+    std::cout << "输入: " << (synthetic ? "合成帧" : capture_file) << "  " << stream.size() << " 字节" << std::endl;
+
+    FieldComparison comparison(pitch_limit);
+    IMUParser parser;
+    parser.setDataCallback([&comparison](const IMUData& data) { comparison.add(data); });
+    for (U8 byte : stream) {
+        parser.processByte(byte);
+    }
+
+    std::cout << "传感器帧: " << comparison.frames << "  校验错误: " << parser.getStats().checksum_errors
+              << "  俯仰超限未比较欧拉角: " << comparison.skipped_gimbal << std::endl;
+    if (comparison.euler[1].samples == 0 && comparison.accel[0].samples == 0) {
+        std::cerr << "错误: 没有同时包含推导来源与设备输出字段的帧（需订阅 0x60 或 0x23）" << std::endl;
+        return 1;
+    }
+
+    bool ok = true;
+    std::cout << std::endl << "字段        样本      RMS        最大     容差" << std::endl;
+    auto report = [&](const FieldError& e, double tol, const char* unit) {
+        if (e.samples == 0) {
+            return;
+        }
+        bool pass = e.max_abs <= tol;
+        ok = ok && pass;
+        std::cout << "  " << std::left << std::setw(8) << e.name << std::right << std::setw(9) << e.samples
+                  << std::fixed << std::setprecision(4) << std::setw(10) << e.rms() << std::setw(10) << e.max_abs
+                  << std::setw(8) << std::setprecision(3) << tol << " " << unit << (pass ? "  通过" : "  超出容差")
+                  << std::endl;
+    };
+    for (const FieldError& e : comparison.euler) {
+        report(e, euler_tol, "°");
+    }
+    for (const FieldError& e : comparison.accel) {
+        report(e, accel_tol, "m/s²");
+    }
+
+    std::cout << std::endl << (ok ? "验证通过" : "验证失败：推导字段与设备输出不一致") << std::endl;
+    return ok ? 0 : 1;
+}
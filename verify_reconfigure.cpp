@@ -0,0 +1,347 @@
+/**
+ * @file verify_reconfigure.cpp
+ * @brief 运行中重配置的数据中断验证
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   用伪终端对模拟设备：按当前上报频率与订阅标签发出传感器帧，收到 0x12 参数命令后立即按新参数上报。
+ *   IMUReader 打开伪终端从端，启用字段统计与振动监测，依次调用 reconfigure()
+ *   切换上报频率与订阅标签，记录数据回调的主机到达时刻，统计每次切换前后相邻回调的最大间隔，
+ *   以及回调相对设备发帧时刻的最大延迟（读取线程在切换时的停顿直接体现在延迟上）。
+ *   最大间隔超过 --max-periods 个（新旧频率中较长的）帧周期，或结束时最后一帧订阅标签、振动频谱采样率、
+ *   统计窗口容量未随最终配置切换时返回 1。
+ *   不启用重采样：频率变化后重采样器从空历史开始，输出需先积累约 taps 个输入样本，不属于读取线程的停顿。
+ *   用法: verify_reconfigure [--seconds 1] [--max-periods 3]
+ */
+#include "imu_frame_view.h"
+#include "imu_raw_sample.h"
+#include "imu_reader.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// 伪终端主端上的模拟设备
+class SimulatedDevice {
+public:
+    SimulatedDevice(int fd, int report_rate, uint16_t tag)
+        : fd_(fd), report_rate_(report_rate), tag_(tag), running_(false), frames_(0), commands_(0) {}
+
+    void start() {
+        begin_us_ = static_cast<int64_t>(IMUReader::hostNowUs());
+        running_ = true;
+        thread_ = std::thread(&SimulatedDevice::run, this);
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    // 设备时间戳零点（主机单调时钟 us），时间戳 t ms 的帧在 begin_us + t * 1000 发出
+    int64_t beginUs() const { return begin_us_; }
+    uint64_t frames() const { return frames_; }
+    uint64_t commands() const { return commands_; }
+
+private:
+    // 按整毫秒周期发帧（验证使用的频率周期均为整毫秒），时间戳即计划发出时刻
+    void run() {
+        int64_t next_us = 0;
+        while (running_) {
+            pollCommands();
+            int rate = report_rate_;
+            next_us += rate > 0 ? (1000 / rate) * 1000 : 2000000;
+            int64_t wait_us = begin_us_ + next_us - static_cast<int64_t>(IMUReader::hostNowUs());
+            if (wait_us > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(wait_us));
+            }
+            sendFrame(static_cast<uint32_t>(next_us / 1000), next_us / 1e6);
+        }
+    }
+
+    // 传感器帧：各字段均为同一 20Hz 正弦
+    void sendFrame(uint32_t timestamp, double t) {
+        const uint16_t tag = tag_;
+        const int payload = IMU_FRAME_OFFSETS.offset[tag & 0x7F][7];
+        U8 body[7 + IMU_RAW_MAX_PAYLOAD] = {};
+        body[0] = 0x11;
+        body[1] = static_cast<U8>(tag & 0xFF);
+        body[2] = static_cast<U8>(tag >> 8);
+        memcpy(body + 3, &timestamp, 4);
+        S16 wave = static_cast<S16>(2000.0 * std::sin(2.0 * PI * 20.0 * t));
+        for (int i = 0; i + 1 < payload && i + 1 < IMU_RAW_MAX_PAYLOAD; i += 2) {
+            memcpy(body + 7 + i, &wave, 2);
+        }
+
+        U8 frame[5 + 7 + IMU_RAW_MAX_PAYLOAD];
+        const int len = 7 + payload;
+        U8 checksum = 0x50 + static_cast<U8>(len);
+        frame[0] = CMD_PACKET_BEGIN;
+        frame[1] = 0x50;
+        frame[2] = static_cast<U8>(len);
+        for (int i = 0; i < len; i++) {
+            frame[3 + i] = body[i];
+            checksum += body[i];
+        }
+        frame[3 + len] = checksum;
+        frame[4 + len] = CMD_PACKET_END;
+        if (write(fd_, frame, len + 5) == len + 5) {
+            frames_++;
+        }
+    }
+
+    // 读取主机命令，只处理 0x12 参数命令（上报频率与订阅标签）
+    void pollCommands() {
+        U8 buf[256];
+        ssize_t n;
+        while ((n = read(fd_, buf, sizeof(buf))) > 0) {
+            rx_.insert(rx_.end(), buf, buf + n);
+        }
+        size_t pos = 0;
+        while (pos + 5 <= rx_.size()) {
+            if (rx_[pos] != CMD_PACKET_BEGIN) {
+                pos++;
+                continue;
+            }
+            size_t len = rx_[pos + 2];
+            if (pos + 5 + len > rx_.size()) {
+                break;
+            }
+            U8 checksum = rx_[pos + 1] + rx_[pos + 2];
+            for (size_t i = 0; i < len; i++) {
+                checksum += rx_[pos + 3 + i];
+            }
+            if (checksum != rx_[pos + 3 + len] || rx_[pos + 4 + len] != CMD_PACKET_END) {
+                pos++;
+                continue;
+            }
+            const U8* body = &rx_[pos + 3];
+            if (len == 11 && body[0] == 0x12) {
+                report_rate_ = body[5];
+                tag_ = static_cast<uint16_t>(body[9] | (body[10] << 8));
+                commands_++;
+            }
+            pos += 5 + len;
+        }
+        rx_.erase(rx_.begin(), rx_.begin() + pos);
+    }
+
+    int fd_;
+    int64_t begin_us_ = 0;
+    std::atomic<int> report_rate_;
+    std::atomic<uint16_t> tag_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> commands_;
+    std::vector<U8> rx_;
+    std::thread thread_;
+};
+
+// 数据回调的主机到达时刻（读取线程写入，停止后由主线程读取）
+struct ArrivalLog {
+    std::vector<int64_t> host_us;
+    std::vector<uint16_t> tags;
+    std::vector<uint32_t> timestamps;
+
+    void add(const IMUData& data) {
+        host_us.push_back(static_cast<int64_t>(IMUReader::hostNowUs()));
+        tags.push_back(data.subscribe_tag);
+        timestamps.push_back(data.timestamp);
+    }
+};
+
+struct Step {
+    int report_rate;
+    uint16_t subscribe_tag;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    double seconds = 1.0;
+    double max_periods = 3.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--max-periods" && i + 1 < argc) {
+            max_periods = std::atof(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--seconds 1] [--max-periods 3]" << std::endl;
+            return 1;
+        }
+    }
+    if (seconds <= 0.0 || max_periods <= 0.0) {
+        std::cerr << "错误: 参数无效" << std::endl;
+        return 1;
+    }
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::cerr << "错误: 无法创建伪终端" << std::endl;
+        return 1;
+    }
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    const std::string slave = ptsname(master);
+
+    // 依次切换的上报频率与订阅标签（第一项为初始配置）
+    const Step steps[] = {{100, 0x02}, {200, 0x02}, {50, 0x06}, {100, 0x07}, {250, 0x02}};
+
+    char config_file[] = "/tmp/verify_reconfigure_XXXXXX";
+    int config_fd = mkstemp(config_file);
+    if (config_fd < 0) {
+        std::cerr << "错误: 无法创建临时配置文件" << std::endl;
+        return 1;
+    }
+    close(config_fd);
+    {
+        std::ofstream out(config_file);
+        out << "[Serial]\nport=" << slave << "\nbaudrate=921600\ntimeout=100\n"
+            << "[IMU]\nreport_rate=" << steps[0].report_rate << "\nsubscribe_tag=0x" << std::hex
+            << steps[0].subscribe_tag << std::dec << "\n"
+            << "[Statistics]\nenabled=1\nwindows=1,10,60\n"
+            << "[Vibration]\nenabled=1\nfft_size=64\npublish_interval_ms=500\n"
+            << "[Debug]\ndebug_enabled=0\nlog_level=warn\n";
+    }
+
+    std::cout << "=== 运行中重配置数据中断验证 ===" << std::endl;
+    std::cout << "伪终端: " << slave << "  每段时长: " << seconds << " s  上界: " << max_periods << " 个帧周期"
+              << std::endl;
+
+    SimulatedDevice device(master, steps[0].report_rate, steps[0].subscribe_tag);
+    device.start();
+
+    ArrivalLog log;
+    log.host_us.reserve(1 << 16);
+    log.tags.reserve(1 << 16);
+    log.timestamps.reserve(1 << 16);
+    IMUReader reader;
+    bool ok = reader.initialize(config_file);
+    unlink(config_file);
+    if (!ok) {
+        std::cerr << "错误: 初始化读取器失败" << std::endl;
+        device.stop();
+        return 1;
+    }
+    reader.setDataCallback([&log](const IMUData& data) { log.add(data); });
+    if (!reader.start()) {
+        std::cerr << "错误: 启动读取器失败" << std::endl;
+        device.stop();
+        return 1;
+    }
+
+    struct Switch {
+        int64_t begin_us;
+        int64_t end_us;
+        bool ok;
+    };
+    std::vector<Switch> switches;
+    const auto phase = std::chrono::microseconds(static_cast<int64_t>(seconds * 1e6));
+    std::this_thread::sleep_for(phase);
+    for (size_t s = 1; s < sizeof(steps) / sizeof(steps[0]); s++) {
+        IMUReconfigureParams params;
+        params.report_rate = steps[s].report_rate;
+        params.subscribe_tag = steps[s].subscribe_tag;
+        Switch sw;
+        sw.begin_us = static_cast<int64_t>(IMUReader::hostNowUs());
+        sw.ok = reader.reconfigure(params);
+        sw.end_us = static_cast<int64_t>(IMUReader::hostNowUs());
+        switches.push_back(sw);
+        std::this_thread::sleep_for(phase);
+    }
+    std::shared_ptr<const VibrationSpectrum> spectrum = reader.getVibrationSpectrum();
+    FieldStatsSnapshot stats = reader.getFieldStats();
+    reader.stop();
+    device.stop();
+    close(master);
+
+    std::cout << std::endl << "设备发出 " << device.frames() << " 帧，收到参数命令 " << device.commands()
+              << " 次；数据回调 " << log.host_us.size() << " 次" << std::endl;
+    // 回调相对设备发帧时刻的延迟，取中位数作为稳态参照
+    std::vector<int64_t> delay_us(log.host_us.size());
+    for (size_t i = 0; i < log.host_us.size(); i++) {
+        delay_us[i] = log.host_us[i] - (device.beginUs() + static_cast<int64_t>(log.timestamps[i]) * 1000);
+    }
+    if (!delay_us.empty()) {
+        std::vector<int64_t> sorted = delay_us;
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        std::cout << "回调延迟中位数: " << std::fixed << std::setprecision(3) << sorted[sorted.size() / 2] / 1000.0
+                  << " ms" << std::endl;
+    }
+    std::cout << std::endl
+              << "切换                      reconfigure() ms   最大间隔 ms   帧周期 ms   间隔/周期   最大延迟 ms"
+              << std::endl;
+
+    bool pass_all = true;
+    for (size_t s = 0; s < switches.size(); s++) {
+        const Step& from = steps[s];
+        const Step& to = steps[s + 1];
+        const Switch& sw = switches[s];
+        double period_ms = 1000.0 / std::min(from.report_rate, to.report_rate);
+
+        // 命令发出前一个周期到切换完成后半段时长内相邻回调的最大间隔
+        int64_t window_begin = sw.begin_us - static_cast<int64_t>(period_ms * 1000);
+        int64_t window_end = sw.end_us + static_cast<int64_t>(seconds * 5e5);
+        int64_t max_gap = 0;
+        int64_t max_delay = 0;
+        for (size_t i = 1; i < log.host_us.size(); i++) {
+            if (log.host_us[i] < window_begin || log.host_us[i - 1] > window_end) {
+                continue;
+            }
+            max_gap = std::max(max_gap, log.host_us[i] - log.host_us[i - 1]);
+            max_delay = std::max(max_delay, delay_us[i]);
+        }
+        double gap_ms = max_gap / 1000.0;
+        bool pass = sw.ok && gap_ms <= max_periods * period_ms;
+        pass_all = pass_all && pass;
+
+        std::ostringstream name;
+        name << from.report_rate << "Hz/0x" << std::hex << from.subscribe_tag << std::dec << " -> " << to.report_rate
+             << "Hz/0x" << std::hex << to.subscribe_tag;
+        std::cout << "  " << std::left << std::setw(24) << name.str() << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(14) << (sw.end_us - sw.begin_us) / 1000.0 << std::setw(14)
+                  << gap_ms << std::setw(12) << period_ms << std::setw(11) << gap_ms / period_ms << std::setw(14)
+                  << std::setprecision(3) << max_delay / 1000.0 << (!sw.ok ? "  切换失败" : pass ? "  通过" : "  超出上界") << std::endl;
+    }
+
+    // 切换后的主机端状态：最后一帧为新订阅标签，振动频谱按新频率发布，1 秒统计窗口容量随频率增大
+    const Step& last = steps[sizeof(steps) / sizeof(steps[0]) - 1];
+    const Step& previous = steps[sizeof(steps) / sizeof(steps[0]) - 2];
+    uint16_t last_tag = log.tags.empty() ? 0 : log.tags.back();
+    std::cout << std::endl << "最后一帧订阅标签: 0x" << std::hex << last_tag << std::dec << "  振动频谱采样率: "
+              << (spectrum ? spectrum->sample_rate : 0.0f) << " Hz  1 秒统计窗口样本数: "
+              << (stats.windows > 0 ? stats.window[0].samples : 0) << std::endl;
+    if (last_tag != last.subscribe_tag) {
+        std::cerr << "错误: 最后一帧订阅标签与最终配置不一致" << std::endl;
+        pass_all = false;
+    }
+    if (!spectrum || spectrum->sample_rate != static_cast<float>(last.report_rate)) {
+        std::cerr << "错误: 振动频谱未按新频率 " << last.report_rate << " Hz 发布" << std::endl;
+        pass_all = false;
+    }
+    if (stats.windows == 0 || stats.window[0].samples <= static_cast<uint32_t>(previous.report_rate)) {
+        std::cerr << "错误: 统计窗口未按新频率 " << last.report_rate << " Hz 重新分配" << std::endl;
+        pass_all = false;
+    }
+
+    std::cout << std::endl << (pass_all ? "验证通过" : "验证失败：重配置期间数据中断过长") << std::endl;
+    return pass_all ? 0 : 1;
+}
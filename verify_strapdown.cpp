@@ -0,0 +1,240 @@
+/**
+ * @file verify_strapdown.cpp
+ * @brief 捷联积分在已知轨迹上的漂移验证
+ *
+ * Author : Jetson LV <ljhao1994@163.com>
+ * Created: 2026-10-17
+ * description:
+ *   以解析轨迹（双精度）生成无噪声的角速度与比力采样，经 StrapdownIntegrator 积分后与真值比较：
+ *     1. 圆锥运动：q(t) = Rz(Ωt)·Rx(α)·Rz(-Ωt)，机体 z 轴绕竖直方向画锥，检查姿态漂移
+ *     2. 划桨运动：绕 x 轴角振荡与沿 y 轴线振荡同频同相，检查速度与位置漂移
+ *   同时给出不做圆锥/划桨补偿（φ = Δθ，Δv 不加补偿项）的积分结果作对比，
+ *   补偿后的漂移超过上界时返回 1。关闭零速修正。
+ *   用法: verify_strapdown [--rate 200] [--seconds 10] [--attitude-bound 0.05] [--position-bound 0.1]
+ */
+#include "imu_math.h"
+#include "strapdown.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double GRAVITY = 9.8;
+
+// 双精度四元数（只用于生成真值）
+struct Quatd {
+    double w = 1.0, x = 0.0, y = 0.0, z = 0.0;
+};
+
+Quatd mul(const Quatd& a, const Quatd& b) {
+    return {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+}
+
+Quatd axisAngle(int axis, double angle) {
+    Quatd q;
+    q.w = std::cos(angle / 2);
+    double s = std::sin(angle / 2);
+    (axis == 0 ? q.x : axis == 1 ? q.y : q.z) = s;
+    return q;
+}
+
+// 世界系向量转到机体系：q* v q
+void rotateToBody(const Quatd& q, const double v[3], double out[3]) {
+    Quatd p{0.0, v[0], v[1], v[2]};
+    Quatd r = mul(mul(Quatd{q.w, -q.x, -q.y, -q.z}, p), q);
+    out[0] = r.x;
+    out[1] = r.y;
+    out[2] = r.z;
+}
+
+// 解析轨迹：机体到世界的姿态与世界系位置
+struct Trajectory {
+    const char* name;
+    std::function<Quatd(double)> attitude;
+    std::function<void(double, double[3])> position;
+};
+
+// 由真值轨迹生成 t 时刻的采样：角速度 ω = 2·Im(q*·dq/dt)，比力 f = R^T (d²p/dt² + g·z)
+StrapdownSample sampleAt(const Trajectory& traj, double t, float dt) {
+    const double h = 1e-5;
+    Quatd q = traj.attitude(t);
+    Quatd qp = traj.attitude(t + h), qm = traj.attitude(t - h);
+    Quatd dq{(qp.w - qm.w) / (2 * h), (qp.x - qm.x) / (2 * h), (qp.y - qm.y) / (2 * h), (qp.z - qm.z) / (2 * h)};
+    Quatd omega = mul(Quatd{q.w, -q.x, -q.y, -q.z}, dq);
+
+    double p0[3], pp[3], pm[3];
+    traj.position(t, p0);
+    traj.position(t + h, pp);
+    traj.position(t - h, pm);
+    double force_world[3];
+    for (int i = 0; i < 3; i++) {
+        force_world[i] = (pp[i] - 2 * p0[i] + pm[i]) / (h * h);
+    }
+    force_world[2] += GRAVITY;
+    double force_body[3];
+    rotateToBody(q, force_world, force_body);
+
+    StrapdownSample sample;
+    sample.gyro = Vec3f{static_cast<float>(2 * omega.x), static_cast<float>(2 * omega.y),
+                        static_cast<float>(2 * omega.z)};
+    sample.accel = Vec3f{static_cast<float>(force_body[0]), static_cast<float>(force_body[1]),
+                         static_cast<float>(force_body[2])};
+    sample.dt = dt;
+    return sample;
+}
+
+// 不做圆锥/划桨补偿的积分（对照）
+struct NaiveIntegrator {
+    Quatf attitude;
+    double velocity[3] = {0.0, 0.0, 0.0};
+    double position[3] = {0.0, 0.0, 0.0};
+    bool has_previous = false;
+    StrapdownSample previous;
+
+    void update(const StrapdownSample& s) {
+        if (has_previous) {
+            Vec3f dtheta = (previous.gyro + s.gyro) * (0.5f * s.dt);
+            Vec3f dv = rotate(attitude, (previous.accel + s.accel) * (0.5f * s.dt));
+            double v_old[3] = {velocity[0], velocity[1], velocity[2]};
+            velocity[0] += dv.x;
+            velocity[1] += dv.y;
+            velocity[2] += dv.z - GRAVITY * s.dt;
+            for (int i = 0; i < 3; i++) {
+                position[i] += 0.5 * (v_old[i] + velocity[i]) * s.dt;
+            }
+            attitude = normalized(attitude * quatFromRotationVector(dtheta));
+        }
+        has_previous = true;
+        previous = s;
+    }
+};
+
+// 误差旋转 q_true* · q_est 的转角，用虚部模长求 asin，避免小角度时 acos 的精度损失
+double attitudeErrorDeg(const Quatf& estimate, const Quatd& truth) {
+    Quatd e = mul(Quatd{truth.w, -truth.x, -truth.y, -truth.z}, Quatd{estimate.w, estimate.x, estimate.y, estimate.z});
+    double s = std::sqrt(e.x * e.x + e.y * e.y + e.z * e.z);
+    return 2.0 * std::asin(std::min(1.0, s)) * 180.0 / PI;
+}
+
+double positionError(const double estimate[3], const double truth[3]) {
+    double dx = estimate[0] - truth[0], dy = estimate[1] - truth[1], dz = estimate[2] - truth[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    double rate = 200.0;
+    double seconds = 10.0;
+    // 漂移上界（默认 200Hz、10s 下留 2 倍以上余量）
+    double attitude_bound_deg = 0.05;
+    double position_bound_m = 0.1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--rate" && i + 1 < argc) {
+            rate = std::atof(argv[++i]);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--attitude-bound" && i + 1 < argc) {
+            attitude_bound_deg = std::atof(argv[++i]);
+        } else if (arg == "--position-bound" && i + 1 < argc) {
+            position_bound_m = std::atof(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--rate 200] [--seconds 10] [--attitude-bound 0.05]"
+                      << " [--position-bound 0.1]" << std::endl;
+            return 1;
+        }
+    }
+    if (rate <= 0.0 || seconds <= 0.0) {
+        std::cerr << "错误: 参数无效" << std::endl;
+        return 1;
+    }
+
+    // 圆锥：半锥角 2°，锥频 4Hz；划桨：角振幅 2°、线振幅 2cm，频率 4Hz
+    const double cone_angle = 2.0 * PI / 180.0, cone_rate = 2.0 * PI * 4.0;
+    const double scull_angle = 2.0 * PI / 180.0, scull_amplitude = 0.02, scull_rate = 2.0 * PI * 4.0;
+
+    const Trajectory trajectories[] = {
+        {"圆锥运动",
+         [=](double t) { return mul(mul(axisAngle(2, cone_rate * t), axisAngle(0, cone_angle)), axisAngle(2, -cone_rate * t)); },
+         [](double, double p[3]) { p[0] = p[1] = p[2] = 0.0; }},
+        {"划桨运动",
+         [=](double t) { return axisAngle(0, scull_angle * std::sin(scull_rate * t)); },
+         [=](double t, double p[3]) {
+             p[0] = 0.0;
+             p[1] = scull_amplitude * std::sin(scull_rate * t);
+             p[2] = 0.0;
+         }},
+    };
+
+    std::cout << "=== 捷联积分漂移验证 ===" << std::endl;
+    std::cout << "采样率: " << rate << " Hz  时长: " << seconds << " s  上界: 姿态 " << attitude_bound_deg
+              << "°  位置 " << position_bound_m << " m" << std::endl;
+
+    const float dt = static_cast<float>(1.0 / rate);
+    const size_t samples = static_cast<size_t>(std::llround(seconds * rate)) + 1;
+    bool ok = true;
+    for (const Trajectory& traj : trajectories) {
+        StrapdownConfig config;
+        config.gravity = static_cast<float>(GRAVITY);
+        config.zupt = false;
+        StrapdownIntegrator integrator;
+        integrator.configure(config);
+
+        Quatd q0 = traj.attitude(0.0);
+        Quatf initial{static_cast<float>(q0.w), static_cast<float>(q0.x), static_cast<float>(q0.y),
+                      static_cast<float>(q0.z)};
+        double p0[3], v0[3], pp[3], pm[3];
+        const double h = 1e-5;
+        traj.position(0.0, p0);
+        traj.position(h, pp);
+        traj.position(-h, pm);
+        for (int i = 0; i < 3; i++) {
+            v0[i] = (pp[i] - pm[i]) / (2 * h);
+        }
+        integrator.reset(initial, v0, p0);
+        NaiveIntegrator naive;
+        naive.attitude = initial;
+        for (int i = 0; i < 3; i++) {
+            naive.velocity[i] = v0[i];
+            naive.position[i] = p0[i];
+        }
+
+        double t_end = 0.0;
+        for (size_t k = 0; k < samples; k++) {
+            t_end = k / rate;
+            StrapdownSample sample = sampleAt(traj, t_end, dt);
+            integrator.update(sample);
+            naive.update(sample);
+        }
+
+        Quatd truth = traj.attitude(t_end);
+        double p_true[3];
+        traj.position(t_end, p_true);
+        const StrapdownState& state = integrator.state();
+        double attitude_error = attitudeErrorDeg(state.attitude, truth);
+        double position_error = positionError(state.position, p_true);
+        bool pass = attitude_error <= attitude_bound_deg && position_error <= position_bound_m;
+        ok = ok && pass;
+
+        std::cout << std::endl << traj.name << ":" << std::endl;
+        std::cout << std::fixed << std::setprecision(5);
+        std::cout << "  补偿积分   姿态误差 " << std::setw(9) << attitude_error << "°  位置误差 " << std::setw(9)
+                  << position_error << " m" << (pass ? "  通过" : "  超出上界") << std::endl;
+        std::cout << "  未补偿     姿态误差 " << std::setw(9) << attitudeErrorDeg(naive.attitude, truth)
+                  << "°  位置误差 " << std::setw(9) << positionError(naive.position, p_true) << " m" << std::endl;
+    }
+
+    std::cout << std::endl << (ok ? "验证通过" : "验证失败：漂移超出上界") << std::endl;
+    return ok ? 0 : 1;
+}